@@ -13,7 +13,7 @@
 #include "include/Types/Types.h"
 
 // Type traits for serialization behavior (POD, fixed-size, variable-size)
-#include "Include/Traits/Traits.h"
+#include "include/Traits/Traits.h"
 
 // Zero-copy accessor templates and view classes
 #include "include/Accessor/Accessor.h"
@@ -21,6 +21,9 @@
 // Runtime buffer builder for serialization
 #include "include/Builder/Builder.h"
 
+// Binary reflection tables describing generated schemas
+#include "include/Reflection/Reflection.h"
+
 // Note: Generated schema headers (e.g., RiftSerializer/Generated/Entity_State.h)
 // are separate and should be included individually as needed, or through a
 // central generated "all_schemas.h" if your engine structure permits.
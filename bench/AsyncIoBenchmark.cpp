@@ -0,0 +1,144 @@
+﻿// RiftSerializer/bench/AsyncIoBenchmark.cpp
+//
+// Compares blocking pread/pwrite against the RiftAsyncIo backends (io_uring
+// and the thread-pool fallback) for random 4 KiB reads and sequential batch
+// writes. Reports IOPS / throughput and CPU time per GB transferred.
+//
+// Usage: AsyncIoBenchmark [path=/tmp/rift_async_io.bin] [file_mb=256] [queue_depth=32]
+// Point the path at the device under test (local NVMe, tmpfs, ...).
+
+#include "../include/AsyncIO/AsyncIO.h"
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <random>
+#include <string>
+
+using namespace RiftSerializer;
+
+namespace {
+
+    constexpr uint32 READ_BLOCK_SIZE = 4096;
+    constexpr uint32 WRITE_SIZE = 1u << 20;
+
+    struct Result {
+        double seconds;
+        double cpu_seconds;
+        uint64 bytes;
+        uint64 operations;
+    };
+
+    template<typename F>
+    Result Measure(F&& body) {
+        const std::clock_t cpu_start = std::clock();
+        const auto start = std::chrono::steady_clock::now();
+        Result result = body();
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.cpu_seconds = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+        return result;
+    }
+
+    void Report(const char* name, const Result& r) {
+        const double gb = static_cast<double>(r.bytes) / (1024.0 * 1024.0 * 1024.0);
+        std::printf("%-28s %10.0f ops/s %9.1f MB/s %8.3f cpu-s/GB\n", name,
+            static_cast<double>(r.operations) / r.seconds,
+            static_cast<double>(r.bytes) / r.seconds / (1024.0 * 1024.0),
+            gb > 0 ? r.cpu_seconds / gb : 0.0);
+    }
+
+    std::vector<uint64> RandomOffsets(uint64 file_size, size_t count) {
+        std::mt19937_64 rng(42);
+        std::uniform_int_distribution<uint64> block(0, file_size / READ_BLOCK_SIZE - 1);
+        std::vector<uint64> offsets(count);
+        for (auto& offset : offsets) offset = block(rng) * READ_BLOCK_SIZE;
+        return offsets;
+    }
+
+    Result BlockingReads(RiftFile& file, const std::vector<uint64>& offsets) {
+        RiftAlignedBuffer buffer(READ_BLOCK_SIZE, 4096);
+        for (uint64 offset : offsets) file.ReadAt(offset, buffer.GetData(), READ_BLOCK_SIZE);
+        return { 0, 0, offsets.size() * uint64(READ_BLOCK_SIZE), offsets.size() };
+    }
+
+    Result AsyncReads(RiftAsyncIo& io, RiftFile& file, const std::vector<uint64>& offsets, uint32 queue_depth) {
+        RiftIoBufferPool pool(queue_depth, READ_BLOCK_SIZE);
+        io.RegisterBuffers(pool);
+        std::vector<RiftIoCompletion> completions(queue_depth);
+        size_t next = 0;
+        size_t done = 0;
+        while (done < offsets.size()) {
+            for (int32 buffer; next < offsets.size() && (buffer = pool.Acquire()) >= 0; ++next) {
+                io.Prepare({ RiftIoOp::Read, &file, pool.GetBuffer(buffer), READ_BLOCK_SIZE, offsets[next], buffer, static_cast<uint64>(buffer) });
+            }
+            io.Submit();
+            const uint32 count = io.WaitAndReap(completions.data(), queue_depth);
+            for (uint32 i = 0; i < count; ++i) pool.Release(static_cast<uint32>(completions[i].user_data));
+            done += count;
+        }
+        return { 0, 0, offsets.size() * uint64(READ_BLOCK_SIZE), offsets.size() };
+    }
+
+    Result BlockingWrites(RiftFile& file, uint64 file_size) {
+        RiftAlignedBuffer buffer(WRITE_SIZE, 4096);
+        for (uint64 offset = 0; offset < file_size; offset += WRITE_SIZE) file.WriteAt(offset, buffer.GetData(), WRITE_SIZE);
+        file.Sync();
+        return { 0, 0, file_size, file_size / WRITE_SIZE };
+    }
+
+    Result AsyncWrites(RiftAsyncIo& io, RiftFile& file, uint64 file_size, uint32 queue_depth) {
+        RiftIoBufferPool pool(queue_depth, WRITE_SIZE);
+        io.RegisterBuffers(pool);
+        std::vector<RiftIoCompletion> completions(queue_depth);
+        uint64 offset = 0;
+        while (offset < file_size || io.GetInFlight() > 0) {
+            for (int32 buffer; offset < file_size && (buffer = pool.Acquire()) >= 0; offset += WRITE_SIZE) {
+                io.Prepare({ RiftIoOp::Write, &file, pool.GetBuffer(buffer), WRITE_SIZE, offset, buffer, static_cast<uint64>(buffer) });
+            }
+            io.Submit();
+            const uint32 count = io.WaitAndReap(completions.data(), queue_depth);
+            for (uint32 i = 0; i < count; ++i) pool.Release(static_cast<uint32>(completions[i].user_data));
+        }
+        file.Sync();
+        return { 0, 0, file_size, file_size / WRITE_SIZE };
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::string path = argc > 1 ? argv[1] : "/tmp/rift_async_io.bin";
+    const uint64 file_size = (argc > 2 ? std::stoull(argv[2]) : 256ull) << 20;
+    const uint32 queue_depth = argc > 3 ? static_cast<uint32>(std::stoul(argv[3])) : 32u;
+    const size_t read_count = 200000;
+
+    RiftFile file;
+    if (!file.Open(path.c_str(), RiftFileMode::ReadWrite)) {
+        std::fprintf(stderr, "cannot open %s\n", path.c_str());
+        return 1;
+    }
+    std::printf("file %s, %llu MB, queue depth %u\n", path.c_str(), static_cast<unsigned long long>(file_size >> 20), queue_depth);
+
+    Report("write blocking pwrite", Measure([&] { return BlockingWrites(file, file_size); }));
+    RiftAsyncIo pool_io;
+    pool_io.Init(queue_depth, false, 4);
+    Report("write thread pool", Measure([&] { return AsyncWrites(pool_io, file, file_size, queue_depth); }));
+    pool_io.Close();
+    RiftAsyncIo uring_io;
+    if (uring_io.Init(queue_depth) && uring_io.GetBackend() == RiftAsyncIoBackend::IoUring) {
+        Report("write io_uring", Measure([&] { return AsyncWrites(uring_io, file, file_size, queue_depth); }));
+    }
+    else {
+        std::printf("io_uring unavailable, skipping\n");
+    }
+
+    const std::vector<uint64> offsets = RandomOffsets(file_size, read_count);
+    Report("read 4K blocking pread", Measure([&] { return BlockingReads(file, offsets); }));
+    pool_io.Init(queue_depth, false, 4);
+    Report("read 4K thread pool", Measure([&] { return AsyncReads(pool_io, file, offsets, queue_depth); }));
+    if (uring_io.GetBackend() == RiftAsyncIoBackend::IoUring) {
+        Report("read 4K io_uring", Measure([&] { return AsyncReads(uring_io, file, offsets, queue_depth); }));
+    }
+
+    file.Close();
+    std::remove(path.c_str());
+    return 0;
+}
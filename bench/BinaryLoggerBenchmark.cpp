@@ -0,0 +1,78 @@
+﻿// RiftSerializer/bench/BinaryLoggerBenchmark.cpp
+//
+// Caller-side cost of a log call with a few numeric and string arguments:
+// RiftBinaryLogger (records formatted on its background thread into a
+// discarding sink) versus spdlog formatting synchronously into a null sink.
+//
+// Usage: BinaryLoggerBenchmark [threads=1] [calls_per_thread=1000000]
+
+#include "../include/Common/SpdlogDiagnostics.h"
+#include "../include/Logger/Logger.h"
+#include <spdlog/sinks/null_sink.h>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace RiftSerializer;
+
+namespace {
+
+    template<typename Body>
+    double TimePerCall(uint32 threads, uint64 calls, Body&& body) {
+        std::atomic<uint64> total_ns{ 0 };
+        std::vector<std::thread> workers;
+        for (uint32 t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                const auto start = std::chrono::steady_clock::now();
+                for (uint64 i = 0; i < calls; ++i) body(t, i);
+                total_ns += static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        return static_cast<double>(total_ns) / static_cast<double>(threads * calls);
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const uint32 threads = argc > 1 ? static_cast<uint32>(std::stoul(argv[1])) : 1;
+    const uint64 calls = argc > 2 ? std::stoull(argv[2]) : 1000000;
+
+    // Chunks sized so that a burst never drops; the sink formats and discards.
+    RiftBinaryLoggerConfig config;
+    config.chunk_size = 1u << 20;
+    config.max_chunks_per_thread = 256;
+    std::atomic<uint64> formatted{ 0 };
+    std::string line;
+    std::pair<std::string*, std::atomic<uint64>*> sink_state{ &line, &formatted };
+    RiftLogSink sink{ [](void* context, const RiftLogRecord& record) {
+        auto& state = *static_cast<std::pair<std::string*, std::atomic<uint64>*>*>(context);
+        state.first->clear();
+        record.FormatLine(*state.first);
+        state.second->fetch_add(1, std::memory_order_relaxed);
+    }, nullptr, &sink_state };
+    RiftBinaryLogger timed(config);
+    timed.AddSink(sink);
+    timed.Start();
+
+    const double binary_ns = TimePerCall(threads, calls, [&](uint32 t, uint64 i) {
+        RIFT_BLOG(timed, RiftLogLevel::Info, "entity {} moved to ({:.2f}, {:.2f}) in zone {}", i, 1.5 * static_cast<double>(i), -0.25, "harbor");
+        if (i + 1 == calls) timed.FlushThread();
+        (void)t;
+    });
+    timed.Stop();
+
+    auto spd = std::make_shared<spdlog::logger>("bench", std::make_shared<spdlog::sinks::null_sink_mt>());
+    spd->set_level(spdlog::level::info);
+    const double spdlog_ns = TimePerCall(threads, calls, [&](uint32, uint64 i) {
+        spd->info("entity {} moved to ({:.2f}, {:.2f}) in zone {}", i, 1.5 * static_cast<double>(i), -0.25, "harbor");
+    });
+
+    std::printf("%u threads x %llu calls\n", threads, static_cast<unsigned long long>(calls));
+    std::printf("binary logger %7.1f ns/call  formatted %llu  dropped %llu\n", binary_ns,
+        static_cast<unsigned long long>(formatted.load()), static_cast<unsigned long long>(timed.GetDroppedCount()));
+    std::printf("spdlog        %7.1f ns/call\n", spdlog_ns);
+    return 0;
+}
@@ -0,0 +1,113 @@
+﻿// RiftSerializer/bench/BitStreamBenchmark.cpp
+//
+// Throughput and wire size of a typical replicated record (a flag, a small
+// enum, a quantized position and a 7-bit counter) written and read as a
+// bit-packed section versus as byte-aligned fields in the builder.
+//
+// Usage: BitStreamBenchmark [records=1000000] [runs=5]
+
+#include "../include/BitStream/BitStream.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+
+using namespace RiftSerializer;
+
+namespace {
+
+    struct Record {
+        bool grounded;
+        uint8 stance;      // 0-7
+        float position[3]; // Within +-1024
+        uint8 ammo;        // 0-127
+    };
+    constexpr uint32 RECORD_BITS = 1 + 3 + 3 * 16 + 7;
+
+    // The byte-aligned encoding generated code uses today.
+    struct alignas(4) AlignedRecord {
+        uint8 grounded;
+        uint8 stance;
+        uint8 ammo;
+        uint8 padding;
+        float position[3];
+    };
+
+    template<typename Function>
+    double BestSeconds(int runs, Function&& function) {
+        double best = 1e30;
+        for (int run = 0; run < runs; ++run) {
+            const auto start = std::chrono::steady_clock::now();
+            function();
+            best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t count = argc > 1 ? std::stoull(argv[1]) : 1000000;
+    const int runs = argc > 2 ? std::stoi(argv[2]) : 5;
+
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> coordinate(-1024.0f, 1024.0f);
+    std::vector<Record> records(count);
+    for (Record& r : records) {
+        r = Record{ (rng() & 1) != 0, static_cast<uint8>(rng() % 8), { coordinate(rng), coordinate(rng), coordinate(rng) }, static_cast<uint8>(rng() % 128) };
+    }
+
+    RiftBufferBuilder builder(count * sizeof(AlignedRecord) + 64);
+    uint64 checksum = 0;
+
+    // --- Bit-packed ---
+    uint32 section = 0;
+    const double bit_write = BestSeconds(runs, [&] {
+        builder.Reset();
+        RiftBitWriter writer(builder);
+        for (const Record& r : records) {
+            writer.WriteBool(r.grounded);
+            writer.Write(r.stance, 3);
+            for (const float p : r.position) writer.WriteQuantized(p, -1024.0f, 1024.0f, 16);
+            writer.Write(r.ammo, 7);
+        }
+        section = writer.Finish();
+    });
+    const size_t bit_bytes = builder.GetCurrentSize();
+    const uint32 bit_count = static_cast<uint32>(count * RECORD_BITS);
+    const double bit_read = BestSeconds(runs, [&] {
+        RiftBitReader reader(builder.GetBufferPointer() + section, bit_count);
+        for (size_t i = 0; i < count; ++i) {
+            checksum += reader.ReadBool();
+            checksum += reader.Read(3);
+            for (int axis = 0; axis < 3; ++axis) checksum += static_cast<uint64>(reader.ReadQuantized(-1024.0f, 1024.0f, 16));
+            checksum += reader.Read(7);
+        }
+    });
+
+    // --- Byte-aligned ---
+    const double byte_write = BestSeconds(runs, [&] {
+        builder.Reset();
+        for (const Record& r : records) {
+            builder.PadToAlignment(alignof(AlignedRecord));
+            const AlignedRecord aligned{ r.grounded, r.stance, r.ammo, 0, { r.position[0], r.position[1], r.position[2] } };
+            builder.WriteRaw(&aligned, sizeof(aligned));
+        }
+    });
+    const size_t byte_bytes = builder.GetCurrentSize();
+    const double byte_read = BestSeconds(runs, [&] {
+        const auto* aligned = reinterpret_cast<const AlignedRecord*>(builder.GetBufferPointer());
+        for (size_t i = 0; i < count; ++i) {
+            checksum += aligned[i].grounded + aligned[i].stance + aligned[i].ammo;
+            for (const float p : aligned[i].position) checksum += static_cast<uint64>(p);
+        }
+    });
+
+    const double payload_bits = static_cast<double>(count) * RECORD_BITS;
+    std::printf("%zu records (%u payload bits each), checksum %llu\n", count, RECORD_BITS, static_cast<unsigned long long>(checksum));
+    std::printf("bit-packed:   %8.1f KB, write %7.0f Mbit/s, read %7.0f Mbit/s\n", static_cast<double>(bit_bytes) / 1024,
+        payload_bits / bit_write / 1e6, payload_bits / bit_read / 1e6);
+    std::printf("byte-aligned: %8.1f KB, write %7.0f Mbit/s, read %7.0f Mbit/s\n", static_cast<double>(byte_bytes) / 1024,
+        payload_bits / byte_write / 1e6, payload_bits / byte_read / 1e6);
+    return 0;
+}
@@ -0,0 +1,167 @@
+﻿// RiftSerializer/bench/DebugDrawBenchmark.cpp
+//
+// Encodes a frame of debug primitives (lines and spheres) as one object per
+// primitive and as a RiftDebugDrawBatch in each quantization, and reports
+// bytes per primitive, encode time (including collection) and the time to
+// read every primitive back as floats. A renderer would upload the batch
+// arrays as they are and skip that last step.
+//
+// Usage: DebugDrawBenchmark [lines=4096] [spheres=1024] [frames=200]
+
+#include "../include/Builder/Builder.h"
+#include "../include/Debug/DebugDraw.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace RiftSerializer;
+
+namespace {
+
+    constexpr uint32 DEBUG_LINE_SCHEMA_ID = 201;
+    constexpr uint32 DEBUG_SPHERE_SCHEMA_ID = 202;
+
+    // What a generated DebugLine / DebugSphere carries.
+    struct DebugLine {
+        glm::vec3 from;
+        glm::vec3 to;
+        uint32 color;
+    };
+
+    struct DebugSphere {
+        glm::vec3 center;
+        float radius;
+        uint32 color;
+    };
+
+    struct Frame {
+        std::vector<DebugLine> lines;
+        std::vector<DebugSphere> spheres;
+    };
+
+    Frame MakeFrame(uint32 line_count, uint32 sphere_count) {
+        Frame frame;
+        uint32 seed = 12345;
+        const auto next = [&] {
+            seed = seed * 1664525u + 1013904223u;
+            return static_cast<float>(seed >> 8) / static_cast<float>(1u << 24);
+        };
+        for (uint32 i = 0; i < line_count; ++i) {
+            const glm::vec3 from(next() * 200.0f - 100.0f, next() * 20.0f, next() * 200.0f - 100.0f);
+            frame.lines.push_back({ from, from + glm::vec3(next(), next(), next()), 0xFF000000u | i });
+        }
+        for (uint32 i = 0; i < sphere_count; ++i) {
+            frame.spheres.push_back({ glm::vec3(next() * 200.0f - 100.0f, next() * 20.0f, next() * 200.0f - 100.0f), 0.1f + next() * 4.0f, 0xFF00FF00u | i });
+        }
+        return frame;
+    }
+
+    template<typename T>
+    void BuildPrimitive(RiftBufferBuilder& builder, const T& primitive, uint32 schema_id) {
+        const size_t start = builder.BeginObject();
+        builder.Reserve(sizeof(RiftObjectHeader));
+        builder.WriteRaw(&primitive, sizeof(primitive));
+        builder.EndObject(start, schema_id);
+    }
+
+    struct Result {
+        size_t bytes = 0;
+        double encode_ns = 0.0;
+        double decode_ns = 0.0;
+        double checksum = 0.0;
+    };
+
+    template<typename Encode, typename Decode>
+    Result Measure(uint32 frames, Encode&& encode, Decode&& decode) {
+        Result result;
+        RiftBufferBuilder out(1u << 20);
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32 f = 0; f < frames; ++f) {
+            out.Reset();
+            encode(out);
+        }
+        const auto encoded = std::chrono::steady_clock::now();
+        for (uint32 f = 0; f < frames; ++f) result.checksum += decode(out.GetBufferPointer(), out.GetCurrentSize());
+        const auto decoded = std::chrono::steady_clock::now();
+        result.bytes = out.GetCurrentSize();
+        result.encode_ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(encoded - start).count()) / frames;
+        result.decode_ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(decoded - encoded).count()) / frames;
+        return result;
+    }
+
+    Result RunPerObject(const Frame& frame, uint32 frames) {
+        return Measure(frames,
+            [&](RiftBufferBuilder& out) {
+                for (const DebugLine& line : frame.lines) BuildPrimitive(out, line, DEBUG_LINE_SCHEMA_ID);
+                for (const DebugSphere& sphere : frame.spheres) BuildPrimitive(out, sphere, DEBUG_SPHERE_SCHEMA_ID);
+            },
+            [&](const uint8* data, size_t size) {
+                double sum = 0.0;
+                for (size_t offset = 0; offset < size;) {
+                    const RiftBufferViewBase view(data + offset);
+                    if (view.GetSchemaId() == DEBUG_LINE_SCHEMA_ID) {
+                        DebugLine line;
+                        std::memcpy(&line, view.GetPtrAtOffset(sizeof(RiftObjectHeader), sizeof(line)), sizeof(line));
+                        sum += line.from.x + line.to.y;
+                    }
+                    else {
+                        DebugSphere sphere;
+                        std::memcpy(&sphere, view.GetPtrAtOffset(sizeof(RiftObjectHeader), sizeof(sphere)), sizeof(sphere));
+                        sum += sphere.center.x + sphere.radius;
+                    }
+                    offset += align_up(view.GetTotalSize(), alignof(RiftObjectHeader));
+                }
+                return sum;
+            });
+    }
+
+    Result RunBatch(const Frame& frame, uint32 frames, const RiftDebugDrawConfig& config) {
+        RiftDebugDrawBatchBuilder batch(config);
+        std::vector<glm::vec3> starts, ends, centers;
+        std::vector<float> radii;
+        return Measure(frames,
+            [&](RiftBufferBuilder& out) {
+                batch.Clear();
+                for (const DebugLine& line : frame.lines) batch.AddLine(line.from, line.to, line.color);
+                for (const DebugSphere& sphere : frame.spheres) batch.AddSphere(sphere.center, sphere.radius, sphere.color);
+                batch.Build(out);
+            },
+            [&](const uint8* data, size_t) {
+                const RiftDebugDrawBatchView view(data);
+                starts.resize(view.GetLineCount());
+                ends.resize(view.GetLineCount());
+                centers.resize(view.GetSphereCount());
+                radii.resize(view.GetSphereCount());
+                view.DecodePositions(view.GetLineStarts(), starts.data());
+                view.DecodePositions(view.GetLineEnds(), ends.data());
+                view.DecodePositions(view.GetSphereCenters(), centers.data());
+                view.DecodeRadii(radii.data());
+                double sum = 0.0;
+                for (uint32 i = 0; i < view.GetLineCount(); ++i) sum += starts[i].x + ends[i].y;
+                for (uint32 i = 0; i < view.GetSphereCount(); ++i) sum += centers[i].x + radii[i];
+                return sum;
+            });
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const uint32 lines = argc > 1 ? static_cast<uint32>(std::stoul(argv[1])) : 4096;
+    const uint32 spheres = argc > 2 ? static_cast<uint32>(std::stoul(argv[2])) : 1024;
+    const uint32 frames = argc > 3 ? static_cast<uint32>(std::stoul(argv[3])) : 200;
+    const Frame frame = MakeFrame(lines, spheres);
+    const double primitives = static_cast<double>(lines + spheres);
+
+    std::printf("%u lines + %u spheres per frame, %u frames\n", lines, spheres, frames);
+    std::printf("%-26s %10s %10s %14s %14s\n", "encoding", "bytes", "B/prim", "encode us", "decode us");
+    const auto report = [&](const char* name, const Result& result) {
+        std::printf("%-26s %10zu %10.1f %14.1f %14.1f\n", name, result.bytes, static_cast<double>(result.bytes) / primitives,
+            result.encode_ns / 1000.0, result.decode_ns / 1000.0);
+    };
+    report("object per primitive", RunPerObject(frame, frames));
+    report("batch float32", RunBatch(frame, frames, { RiftDebugPositionFormat::Float32, RiftDebugRadiusFormat::Float32 }));
+    report("batch unorm16", RunBatch(frame, frames, { RiftDebugPositionFormat::Unorm16, RiftDebugRadiusFormat::Unorm16 }));
+    report("batch unorm10 + unorm16", RunBatch(frame, frames, { RiftDebugPositionFormat::Unorm10, RiftDebugRadiusFormat::Unorm16 }));
+    return 0;
+}
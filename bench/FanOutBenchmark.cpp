@@ -0,0 +1,99 @@
+﻿// RiftSerializer/bench/FanOutBenchmark.cpp
+//
+// Per-tick cost of building every client's snapshot packets: serializing
+// each visible entity once per client, versus serializing every entity once
+// into a RiftFanOutPool and assembling per-client gather lists. Sending is
+// not included, so only serialization and packet assembly are compared.
+//
+// Usage: FanOutBenchmark [clients=128] [entities=2000] [visible_percent=25] [ticks=200]
+
+#include "../include/Net/FanOut.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+
+using namespace RiftSerializer;
+
+namespace {
+
+    constexpr uint32 ENTITY_STATE_SCHEMA_ID = 100;
+
+    struct EntityState {
+        uint64 id;
+        float position[3];
+        float rotation[4];
+        float velocity[3];
+        uint32 health;
+        uint32 flags;
+    };
+
+    size_t SerializeEntity(RiftBufferBuilder& builder, const EntityState& entity) {
+        const size_t start = builder.BeginObject();
+        builder.Reserve(sizeof(RiftObjectHeader));
+        builder.WriteRaw(&entity, sizeof(entity));
+        builder.EndObject(start, ENTITY_STATE_SCHEMA_ID);
+        return start;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const uint32 clients = argc > 1 ? static_cast<uint32>(std::stoul(argv[1])) : 128;
+    const uint32 entity_count = argc > 2 ? static_cast<uint32>(std::stoul(argv[2])) : 2000;
+    const uint32 visible_percent = argc > 3 ? static_cast<uint32>(std::stoul(argv[3])) : 25;
+    const uint32 ticks = argc > 4 ? static_cast<uint32>(std::stoul(argv[4])) : 200;
+
+    std::mt19937 rng(7);
+    std::vector<EntityState> entities(entity_count);
+    for (uint32 i = 0; i < entity_count; ++i) entities[i] = EntityState{ i, { 1, 2, 3 }, { 0, 0, 0, 1 }, { 0, 0, 0 }, 100, 0 };
+    std::vector<std::vector<uint32>> visible(clients);
+    for (auto& set : visible) {
+        for (uint32 i = 0; i < entity_count; ++i) {
+            if (rng() % 100 < visible_percent) set.push_back(i);
+        }
+    }
+
+    // Baseline: every client serializes its own copy of each visible entity.
+    uint64 baseline_bytes = 0;
+    RiftBufferBuilder per_client(1u << 20);
+    auto start = std::chrono::steady_clock::now();
+    for (uint32 tick = 0; tick < ticks; ++tick) {
+        for (EntityState& entity : entities) entity.position[0] += 1.0f;
+        for (uint32 c = 0; c < clients; ++c) {
+            per_client.Reset();
+            for (const uint32 id : visible[c]) SerializeEntity(per_client, entities[id]);
+            baseline_bytes += per_client.GetCurrentSize();
+        }
+    }
+    const double baseline = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / ticks;
+
+    // Fan-out: one serialization per entity, then a gather list per client.
+    RiftFanOutPool pool;
+    RiftFanOutAssembler assembler;
+    std::vector<uint32> blocks(entity_count);
+    std::vector<uint32> client_blocks;
+    uint64 fanout_bytes = 0;
+    uint64 datagrams = 0;
+    start = std::chrono::steady_clock::now();
+    for (uint32 tick = 0; tick < ticks; ++tick) {
+        for (EntityState& entity : entities) entity.position[0] += 1.0f;
+        pool.BeginTick();
+        for (uint32 i = 0; i < entity_count; ++i) blocks[i] = pool.AddBuilt(SerializeEntity(pool.GetBuilder(), entities[i]));
+        for (uint32 c = 0; c < clients; ++c) {
+            client_blocks.clear();
+            for (const uint32 id : visible[c]) client_blocks.push_back(blocks[id]);
+            const uint32 count = assembler.Assemble(pool, tick, c, client_blocks.data(), client_blocks.size());
+            datagrams += count;
+            for (uint32 d = 0; d < count; ++d) fanout_bytes += assembler.GetDatagrams()[d].size;
+        }
+    }
+    const double fanout = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / ticks;
+
+    std::printf("%u clients, %u entities, %u%% visible\n", clients, entity_count, visible_percent);
+    std::printf("per-client serialization: %8.1f us/tick (%.1f MB serialized per tick)\n", baseline,
+        static_cast<double>(baseline_bytes) / ticks / (1 << 20));
+    std::printf("serialize once + fan-out: %8.1f us/tick (%.1f MB referenced per tick, %.1f datagrams per client)\n", fanout,
+        static_cast<double>(fanout_bytes) / ticks / (1 << 20), static_cast<double>(datagrams) / ticks / clients);
+    return 0;
+}
@@ -0,0 +1,274 @@
+﻿// RiftSerializer/bench/JsonBenchmark.cpp
+//
+// Throughput of RiftJsonTranscoder in both directions over a corpus shaped
+// like a replay export: mostly entity state updates (scalars, vectors, a
+// quaternion, a short name and two small arrays) mixed with chat messages
+// whose text needs escaping and carries UTF-8. The reflection tables are
+// written out by hand the way the schema compiler emits them.
+//
+// ToJson renders every buffer through the registry lookup; FromJson parses
+// every document back, resolving the schema from "$schema_id". The parsed
+// buffers are rendered again and compared with the corpus text as a
+// round-trip check.
+//
+// Usage: JsonBenchmark [objects=20000] [runs=5]
+
+#include "../include/Json/Json.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace RiftSerializer;
+
+namespace {
+
+    // --- EntityState ---
+    constexpr RiftFieldInfo EntityState_Fields[] = {
+        { "entity_id", 9, 16, RiftFieldType::UInt32, RiftFieldType::None },
+        { "owner", 5, 20, RiftFieldType::UInt16, RiftFieldType::None },
+        { "flags", 5, 22, RiftFieldType::UInt8, RiftFieldType::None },
+        { "alive", 5, 23, RiftFieldType::Bool, RiftFieldType::None },
+        { "position", 8, 24, RiftFieldType::Vec3, RiftFieldType::None },
+        { "velocity", 8, 36, RiftFieldType::Vec3, RiftFieldType::None },
+        { "rotation", 8, 48, RiftFieldType::Quat, RiftFieldType::None },
+        { "health", 6, 64, RiftFieldType::Float, RiftFieldType::None },
+        { "armor", 5, 68, RiftFieldType::Float, RiftFieldType::None },
+        { "timestamp", 9, 72, RiftFieldType::UInt64, RiftFieldType::None },
+        { "name", 4, 80, RiftFieldType::String, RiftFieldType::None },
+        { "tags", 4, 88, RiftFieldType::Array, RiftFieldType::UInt32 },
+        { "path", 4, 96, RiftFieldType::Array, RiftFieldType::Vec3 },
+    };
+    constexpr RiftSchemaInfo EntityState_SchemaInfo = { 0x45535431, 104, "EntityState", EntityState_Fields, 13 };
+    RIFT_SERIALIZER_REGISTER_SCHEMA(EntityState_SchemaInfo)
+
+    // --- ChatMessage ---
+    constexpr RiftFieldInfo ChatMessage_Fields[] = {
+        { "sender", 6, 16, RiftFieldType::UInt64, RiftFieldType::None },
+        { "sent_at", 7, 24, RiftFieldType::Double, RiftFieldType::None },
+        { "channel", 7, 32, RiftFieldType::UInt8, RiftFieldType::None },
+        { "text", 4, 36, RiftFieldType::String, RiftFieldType::None },
+        { "mentions", 8, 44, RiftFieldType::Array, RiftFieldType::UInt64 },
+    };
+    constexpr RiftSchemaInfo ChatMessage_SchemaInfo = { 0x43484154, 52, "ChatMessage", ChatMessage_Fields, 5 };
+    RIFT_SERIALIZER_REGISTER_SCHEMA(ChatMessage_SchemaInfo)
+
+    template<typename T>
+    void WriteSlot(RiftBufferBuilder& builder, size_t object, uint32 offset, T value) {
+        uint8 bytes[sizeof(T)];
+        detail::store_little_endian(bytes, value);
+        builder.WriteAt(object + offset, bytes, sizeof(bytes));
+    }
+
+    void WriteFloats(RiftBufferBuilder& builder, size_t object, uint32 offset, const float* values, uint32 count) {
+        for (uint32 i = 0; i < count; ++i) WriteSlot(builder, object, offset + i * static_cast<uint32>(sizeof(float)), values[i]);
+    }
+
+    void WriteString(RiftBufferBuilder& builder, size_t object, uint32 offset, const std::string& text) {
+        OffsetTableEntry entry{ 0, 0 };
+        if (!text.empty()) {
+            entry = { to_little_endian(static_cast<uint32>(builder.GetCurrentSize() - object)), to_little_endian(static_cast<uint32>(text.size())) };
+            builder.WriteRaw(text.data(), text.size());
+            const char terminator = '\0';
+            builder.WriteRaw(&terminator, 1);
+        }
+        builder.WriteAt(object + offset, &entry, sizeof(entry));
+    }
+
+    // components > 1 packs vector elements (e.g. 3 floats per Vec3) from a flat list.
+    template<typename T>
+    void WriteArray(RiftBufferBuilder& builder, size_t object, uint32 offset, const std::vector<T>& values, size_t alignment, uint32 components = 1) {
+        OffsetTableEntry entry{ 0, 0 };
+        if (!values.empty()) {
+            builder.PadToAlignment(alignment);
+            const auto count = static_cast<uint32>(values.size() / components);
+            entry = { to_little_endian(static_cast<uint32>(builder.GetCurrentSize() - object)), to_little_endian(count) };
+            for (const T& value : values) {
+                uint8 bytes[sizeof(T)];
+                detail::store_little_endian(bytes, value);
+                builder.WriteRaw(bytes, sizeof(bytes));
+            }
+        }
+        builder.WriteAt(object + offset, &entry, sizeof(entry));
+    }
+
+    struct Corpus {
+        RiftBufferBuilder buffers{ 16u << 20 };
+        std::vector<size_t> buffer_offsets;
+        std::string json;
+        std::vector<size_t> json_offsets; // One past the last entry marks the end
+        uint32 entity_count = 0;
+        uint32 chat_count = 0;
+    };
+
+    void AddEntity(Corpus& corpus, std::mt19937& rng, uint32 sequence) {
+        std::uniform_real_distribution<float> coordinate(-2000.0f, 2000.0f);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        RiftBufferBuilder& builder = corpus.buffers;
+        const size_t object = builder.BeginObject();
+        builder.Reserve(EntityState_SchemaInfo.inline_size);
+
+        WriteSlot<uint32>(builder, object, 16, 1000 + rng() % 4096);
+        WriteSlot<uint16>(builder, object, 20, static_cast<uint16>(rng() % 64));
+        WriteSlot<uint8>(builder, object, 22, static_cast<uint8>(rng()));
+        WriteSlot<uint8>(builder, object, 23, rng() % 16 != 0);
+        const float position[3] = { coordinate(rng), coordinate(rng), coordinate(rng) * 0.05f };
+        const float velocity[3] = { unit(rng) * 12.0f, unit(rng) * 12.0f, unit(rng) };
+        const float rotation[4] = { unit(rng), unit(rng), unit(rng), unit(rng) };
+        WriteFloats(builder, object, 24, position, 3);
+        WriteFloats(builder, object, 36, velocity, 3);
+        WriteFloats(builder, object, 48, rotation, 4);
+        WriteSlot<float>(builder, object, 64, static_cast<float>(rng() % 1000) * 0.1f);
+        WriteSlot<float>(builder, object, 68, static_cast<float>(rng() % 100));
+        WriteSlot<uint64>(builder, object, 72, 1700000000000ull + sequence * 16ull);
+
+        WriteString(builder, object, 80, "npc_" + std::to_string(rng() % 100000));
+        std::vector<uint32> tags(rng() % 5);
+        for (uint32& tag : tags) tag = rng() % 256;
+        WriteArray(builder, object, 88, tags, alignof(uint32));
+        std::vector<float> path((rng() % 4) * 3);
+        for (float& value : path) value = coordinate(rng);
+        WriteArray(builder, object, 96, path, alignof(float), 3);
+
+        builder.EndObject(object, EntityState_SchemaInfo.schema_id);
+        corpus.buffer_offsets.push_back(object);
+        ++corpus.entity_count;
+    }
+
+    void AddChat(Corpus& corpus, std::mt19937& rng, uint32 sequence) {
+        static const char* const phrases[] = {
+            "gg", "push mid", "need heal at \"B\" site", "brb\n", "caf\xC3\xA9 closes at 5", "tab\tseparated",
+            "path C:\\games\\rift", "\xE2\x9C\x93 ready", "on my way", "ctrl\x01" "char",
+        };
+        RiftBufferBuilder& builder = corpus.buffers;
+        const size_t object = builder.BeginObject();
+        builder.Reserve(ChatMessage_SchemaInfo.inline_size);
+
+        WriteSlot<uint64>(builder, object, 16, 76561198000000000ull + rng() % 100000);
+        WriteSlot<double>(builder, object, 24, 1700000000.0 + sequence * 0.016);
+        WriteSlot<uint8>(builder, object, 32, static_cast<uint8>(rng() % 4));
+        std::string text;
+        for (uint32 words = 1 + rng() % 6; words > 0; --words) {
+            if (!text.empty()) text += ' ';
+            text += phrases[rng() % (sizeof(phrases) / sizeof(phrases[0]))];
+        }
+        WriteString(builder, object, 36, text);
+        std::vector<uint64> mentions(rng() % 3);
+        for (uint64& mention : mentions) mention = 76561198000000000ull + rng() % 100000;
+        WriteArray(builder, object, 44, mentions, alignof(uint64));
+
+        builder.EndObject(object, ChatMessage_SchemaInfo.schema_id);
+        corpus.buffer_offsets.push_back(object);
+        ++corpus.chat_count;
+    }
+
+    // Builds the buffers, then renders them once to get the JSON documents.
+    bool BuildCorpus(Corpus& corpus, uint32 object_count) {
+        std::mt19937 rng(42);
+        for (uint32 i = 0; i < object_count; ++i) {
+            if (rng() % 8 == 0) AddChat(corpus, rng, i);
+            else AddEntity(corpus, rng, i);
+        }
+
+        const uint8* data = corpus.buffers.GetBufferPointer();
+        std::vector<char> text(64u << 10);
+        for (const size_t offset : corpus.buffer_offsets) {
+            const size_t size = RiftJsonTranscoder::ToJson(RiftBufferViewBase(data + offset), text.data(), text.size());
+            if (size == 0) return false;
+            corpus.json_offsets.push_back(corpus.json.size());
+            corpus.json.append(text.data(), size);
+            corpus.json.push_back('\n');
+        }
+        corpus.json_offsets.push_back(corpus.json.size());
+        return true;
+    }
+
+    double Seconds(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void Report(const char* name, double seconds, size_t objects, size_t binary_bytes, size_t json_bytes) {
+        std::printf("%-9s %8.2f ms  %7.1f ns/object  %7.1f MB/s json  %7.1f MB/s binary\n", name, seconds * 1e3,
+            seconds * 1e9 / static_cast<double>(objects), static_cast<double>(json_bytes) / seconds / 1e6,
+            static_cast<double>(binary_bytes) / seconds / 1e6);
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const uint32 object_count = argc > 1 ? static_cast<uint32>(std::stoul(argv[1])) : 20000;
+    const int runs = argc > 2 ? std::stoi(argv[2]) : 5;
+    if (object_count == 0 || runs <= 0) {
+        std::fprintf(stderr, "usage: JsonBenchmark [objects=20000] [runs=5]\n");
+        return 1;
+    }
+
+    Corpus corpus;
+    if (!BuildCorpus(corpus, object_count)) {
+        std::fprintf(stderr, "failed to render the corpus\n");
+        return 1;
+    }
+    const uint8* data = corpus.buffers.GetBufferPointer();
+    const size_t binary_bytes = corpus.buffers.GetCurrentSize();
+    const size_t json_bytes = corpus.json.size();
+    std::printf("corpus: %u objects (%u EntityState, %u ChatMessage), %.2f MB binary, %.2f MB json\n", object_count,
+        corpus.entity_count, corpus.chat_count, static_cast<double>(binary_bytes) / 1e6, static_cast<double>(json_bytes) / 1e6);
+
+    // --- Buffer -> JSON ---
+    std::vector<char> out(json_bytes + 1);
+    double best = 1e30;
+    size_t written = 0;
+    for (int run = 0; run < runs; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        written = 0;
+        for (const size_t offset : corpus.buffer_offsets) {
+            written += RiftJsonTranscoder::ToJson(RiftBufferViewBase(data + offset), out.data() + written, out.size() - written);
+            out[written++] = '\n';
+        }
+        best = std::min(best, Seconds(start));
+    }
+    Report("ToJson", best, object_count, binary_bytes, json_bytes);
+    if (written != json_bytes || std::memcmp(out.data(), corpus.json.data(), json_bytes) != 0) {
+        std::fprintf(stderr, "ToJson output differs from the corpus\n");
+        return 1;
+    }
+
+    // --- JSON -> Buffer ---
+    RiftBufferBuilder parsed(binary_bytes + (64u << 10));
+    best = 1e30;
+    size_t failures = 0;
+    for (int run = 0; run < runs; ++run) {
+        parsed.Reset();
+        failures = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i + 1 < corpus.json_offsets.size(); ++i) {
+            const size_t offset = corpus.json_offsets[i];
+            if (RiftJsonTranscoder::FromJson(corpus.json.data() + offset, corpus.json_offsets[i + 1] - offset, parsed) == 0) ++failures;
+        }
+        best = std::min(best, Seconds(start));
+    }
+    Report("FromJson", best, object_count, parsed.GetCurrentSize(), json_bytes);
+    if (failures != 0) {
+        std::fprintf(stderr, "FromJson rejected %zu documents\n", failures);
+        return 1;
+    }
+
+    // Round trip: the parsed buffers must render to the same text.
+    std::string round_trip;
+    std::vector<char> text(64u << 10);
+    const uint8* parsed_data = parsed.GetBufferPointer();
+    for (size_t offset = 0; offset < parsed.GetCurrentSize();) {
+        const RiftBufferViewBase view(parsed_data + offset);
+        round_trip.append(text.data(), RiftJsonTranscoder::ToJson(view, text.data(), text.size()));
+        round_trip.push_back('\n');
+        offset = align_up(offset + view.GetTotalSize(), alignof(RiftObjectHeader));
+    }
+    if (round_trip != corpus.json) {
+        std::fprintf(stderr, "round trip through FromJson changed the documents\n");
+        return 1;
+    }
+    std::printf("round trip: ok\n");
+    return 0;
+}
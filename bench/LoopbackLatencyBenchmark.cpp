@@ -0,0 +1,264 @@
+﻿// RiftSerializer/bench/LoopbackLatencyBenchmark.cpp
+//
+// End-to-end latency of serialize -> send -> receive -> verify -> access,
+// between a producer and a consumer thread over loopback UDP, a Unix
+// datagram socket and an in-process ring (RiftSpscObjectRing, built in
+// place). Messages are sent at a fixed rate; latency is measured from each
+// message's scheduled send time, so producer stalls are not hidden
+// (coordinated omission). Reports p50/p99/p99.9/max from an HDR histogram.
+//
+// Usage: LoopbackLatencyBenchmark [messages=100000] [rate_per_second=50000] [extra_payload_bytes=0]
+
+#include "../include/Builder/Builder.h"
+#include "../include/Concurrency/SpscRing.h"
+#include "../include/Memory/AlignedBuffer.h"
+#include "../include/Net/Socket.h"
+#include "../include/Stats/HdrHistogram.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#endif
+
+using namespace RiftSerializer;
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint32 ENTITY_STATE_SCHEMA_ID = 100;
+    constexpr uint32 DEBUG_EVENT_SCHEMA_ID = 200;
+    constexpr size_t MAX_MESSAGE_SIZE = 8192;
+
+    uint64 NowNs() {
+        return static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+    }
+
+    // Fixed part shared by both workloads: when the message was due, and its sequence number.
+    struct Stamp {
+        uint64 scheduled_ns;
+        uint64 sequence;
+    };
+
+    // --- Workloads ---
+    // Both are built through the generic builder interface so that the ring
+    // can build them in place with RiftSpanBuilder.
+
+    struct EntityStateWorkload {
+        static constexpr const char* NAME = "Entity_State";
+        struct Fields {
+            Stamp stamp;
+            float position[3];
+            float rotation[4];
+            float velocity[3];
+            uint32 health;
+        };
+
+        template<typename Builder>
+        static void Build(Builder& builder, const Stamp& stamp, size_t extra) {
+            const size_t start = builder.BeginObject();
+            const size_t fixed = builder.Reserve(sizeof(RiftObjectHeader) + sizeof(Fields) + sizeof(OffsetTableEntry));
+            const Fields fields{ stamp, { 1, 2, 3 }, { 0, 0, 0, 1 }, { 0.5f, 0, 0 }, 100 };
+            builder.WriteAt(fixed + sizeof(RiftObjectHeader), &fields, sizeof(fields));
+            if (extra > 0) {
+                builder.PadToAlignment(alignof(uint32));
+                const OffsetTableEntry entry{ static_cast<uint32>(builder.GetCurrentSize() - start), static_cast<uint32>(extra / sizeof(uint32)) };
+                builder.WriteAt(fixed + sizeof(RiftObjectHeader) + sizeof(Fields), &entry, sizeof(entry));
+                builder.Reserve(extra);
+            }
+            builder.EndObject(start, ENTITY_STATE_SCHEMA_ID);
+        }
+
+        static bool Access(const RiftBufferViewBase& view, Stamp& stamp, uint64& sink) {
+            if (view.GetSchemaId() != ENTITY_STATE_SCHEMA_ID || view.GetTotalSize() < sizeof(RiftObjectHeader) + sizeof(Fields)) return false;
+            Fields fields;
+            std::memcpy(&fields, view.GetPtrAtOffset(sizeof(RiftObjectHeader), sizeof(Fields)), sizeof(fields));
+            stamp = fields.stamp;
+            sink += fields.health + static_cast<uint64>(fields.position[0] + fields.velocity[0]);
+            return true;
+        }
+    };
+
+    struct DebugEventWorkload {
+        static constexpr const char* NAME = "DebugEvent";
+
+        template<typename Builder>
+        static void Build(Builder& builder, const Stamp& stamp, size_t extra) {
+            static const std::string base = "ability_cast player=17 target=42 result=hit";
+            const size_t start = builder.BeginObject();
+            const size_t fixed = builder.Reserve(sizeof(RiftObjectHeader) + sizeof(Stamp) + sizeof(OffsetTableEntry));
+            builder.WriteAt(fixed + sizeof(RiftObjectHeader), &stamp, sizeof(stamp));
+            const std::string text = extra ? base + std::string(extra, '.') : base;
+            const OffsetTableEntry entry{ static_cast<uint32>(builder.AddString(text) - start), static_cast<uint32>(text.size()) };
+            builder.WriteAt(fixed + sizeof(RiftObjectHeader) + sizeof(Stamp), &entry, sizeof(entry));
+            builder.EndObject(start, DEBUG_EVENT_SCHEMA_ID);
+        }
+
+        static bool Access(const RiftBufferViewBase& view, Stamp& stamp, uint64& sink) {
+            const size_t fixed = sizeof(RiftObjectHeader) + sizeof(Stamp) + sizeof(OffsetTableEntry);
+            if (view.GetSchemaId() != DEBUG_EVENT_SCHEMA_ID || view.GetTotalSize() < fixed) return false;
+            OffsetTableEntry entry;
+            std::memcpy(&stamp, view.GetPtrAtOffset(sizeof(RiftObjectHeader), sizeof(Stamp)), sizeof(stamp));
+            std::memcpy(&entry, view.GetPtrAtOffset(sizeof(RiftObjectHeader) + sizeof(Stamp), sizeof(entry)), sizeof(entry));
+            if (entry.offset + entry.size + 1 > view.GetTotalSize()) return false;
+            sink += std::strlen(reinterpret_cast<const char*>(view.GetPtrAtOffset(entry.offset, entry.size + 1)));
+            return true;
+        }
+    };
+
+    // --- Transports ---
+    // Send() takes a builder-produced message; Poll() returns a received
+    // message (8-byte aligned) or nullptr if none is ready.
+
+    class UdpTransport {
+    public:
+        static constexpr const char* NAME = "udp loopback";
+        bool Open() {
+            if (!m_rx.Open(0) || !m_tx.Open(0) || !m_tx.Connect("127.0.0.1", m_rx.GetLocalPort())) return false;
+            m_rx.SetBufferSizes(4 << 20, 4 << 20);
+            return m_rx.SetNonBlocking(true);
+        }
+        bool Send(const RiftBufferBuilder& message) { return m_tx.Send(message.GetBufferPointer(), message.GetCurrentSize()); }
+        const uint8* Poll() { return m_rx.Receive(m_buffer.GetData(), m_buffer.GetSize()) > 0 ? m_buffer.GetData() : nullptr; }
+
+    private:
+        RiftUdpSocket m_rx;
+        RiftUdpSocket m_tx;
+        RiftAlignedBuffer m_buffer{ MAX_MESSAGE_SIZE, alignof(RiftObjectHeader) };
+    };
+
+#ifndef _WIN32
+    class UnixTransport {
+    public:
+        static constexpr const char* NAME = "unix datagram";
+        UnixTransport() = default;
+        ~UnixTransport() {
+            if (m_fds[0] >= 0) ::close(m_fds[0]);
+            if (m_fds[1] >= 0) ::close(m_fds[1]);
+        }
+        bool Open() {
+            if (::socketpair(AF_UNIX, SOCK_DGRAM, 0, m_fds) != 0) return false;
+            return ::fcntl(m_fds[1], F_SETFL, ::fcntl(m_fds[1], F_GETFL, 0) | O_NONBLOCK) == 0;
+        }
+        bool Send(const RiftBufferBuilder& message) {
+            return ::send(m_fds[0], message.GetBufferPointer(), message.GetCurrentSize(), 0) >= 0;
+        }
+        const uint8* Poll() { return ::recv(m_fds[1], m_buffer.GetData(), m_buffer.GetSize(), 0) > 0 ? m_buffer.GetData() : nullptr; }
+
+    private:
+        int m_fds[2] = { -1, -1 };
+        RiftAlignedBuffer m_buffer{ MAX_MESSAGE_SIZE, alignof(RiftObjectHeader) };
+    };
+#endif
+
+    class RingTransport {
+    public:
+        static constexpr const char* NAME = "in-process ring";
+        bool Open() { return true; }
+        template<typename Workload>
+        bool BuildAndSend(const Stamp& stamp, size_t extra) {
+            RiftSpanBuilder* builder = m_ring.BeginWrite(MAX_MESSAGE_SIZE);
+            if (!builder) return false;
+            Workload::Build(*builder, stamp, extra);
+            return m_ring.Commit();
+        }
+        const uint8* Poll() {
+            if (m_peeked) m_ring.Release();
+            m_peeked = static_cast<const uint8*>(m_ring.Peek());
+            return m_peeked;
+        }
+
+    private:
+        RiftSpscObjectRing m_ring{ 1u << 20 };
+        const uint8* m_peeked = nullptr;
+    };
+
+    template<typename Workload, typename Transport>
+    void Run(uint64 messages, uint64 rate, size_t extra) {
+        Transport transport;
+        if (!transport.Open()) {
+            std::printf("%-16s %-13s open failed\n", Transport::NAME, Workload::NAME);
+            return;
+        }
+
+        RiftHdrHistogram latency;
+        std::atomic<bool> producing{ true };
+        uint64 received = 0;
+        uint64 invalid = 0;
+        uint64 sink = 0;
+        std::thread consumer([&] {
+            uint32 idle = 0;
+            while (received + invalid < messages) {
+                const uint8* data = transport.Poll();
+                if (!data) {
+                    if (!producing.load(std::memory_order_acquire) && ++idle > 100000) break; // Remaining messages were lost
+                    std::this_thread::yield();
+                    continue;
+                }
+                const auto* header = reinterpret_cast<const RiftObjectHeader*>(data);
+                Stamp stamp{};
+                if (from_little_endian(header->magic) != RIFT_MAGIC_NUMBER || from_little_endian(header->total_size) > MAX_MESSAGE_SIZE ||
+                    !Workload::Access(RiftBufferViewBase(data), stamp, sink)) {
+                    ++invalid;
+                    continue;
+                }
+                latency.Record(NowNs() - stamp.scheduled_ns);
+                ++received;
+            }
+        });
+
+        RiftBufferBuilder builder(MAX_MESSAGE_SIZE);
+        const uint64 interval_ns = rate ? 1000000000ull / rate : 0;
+        const uint64 begin = NowNs();
+        for (uint64 i = 0; i < messages; ++i) {
+            const Stamp stamp{ begin + i * interval_ns, i };
+            while (NowNs() < stamp.scheduled_ns) std::this_thread::yield();
+            if constexpr (std::is_same_v<Transport, RingTransport>) {
+                while (!transport.template BuildAndSend<Workload>(stamp, extra) && NowNs() - stamp.scheduled_ns < 1000000000ull) {
+                    std::this_thread::yield(); // Ring full: wait up to a second for the consumer
+                }
+            }
+            else {
+                builder.Reset();
+                Workload::Build(builder, stamp, extra);
+                transport.Send(builder);
+            }
+        }
+        producing.store(false, std::memory_order_release);
+        consumer.join();
+        const double seconds = static_cast<double>(NowNs() - begin) / 1e9;
+
+        std::printf("%-16s %-13s p50 %7.1f us  p99 %7.1f us  p99.9 %7.1f us  max %8.1f us  %7.0f k msg/s  lost %llu\n",
+            Transport::NAME, Workload::NAME,
+            static_cast<double>(latency.GetPercentile(50)) / 1000, static_cast<double>(latency.GetPercentile(99)) / 1000,
+            static_cast<double>(latency.GetPercentile(99.9)) / 1000, static_cast<double>(latency.GetMax()) / 1000,
+            static_cast<double>(received) / seconds / 1000, static_cast<unsigned long long>(messages - received));
+        (void)sink;
+    }
+
+    template<typename Workload>
+    void RunAll(uint64 messages, uint64 rate, size_t extra) {
+        Run<Workload, UdpTransport>(messages, rate, extra);
+#ifndef _WIN32
+        Run<Workload, UnixTransport>(messages, rate, extra);
+#endif
+        Run<Workload, RingTransport>(messages, rate, extra);
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const uint64 messages = argc > 1 ? std::stoull(argv[1]) : 100000;
+    const uint64 rate = argc > 2 ? std::stoull(argv[2]) : 50000;
+    const size_t extra = argc > 3 ? std::min<size_t>(std::stoull(argv[3]), MAX_MESSAGE_SIZE - 256) : 0;
+
+    std::printf("%llu messages at %llu/s, %zu extra payload bytes\n", static_cast<unsigned long long>(messages),
+        static_cast<unsigned long long>(rate), extra);
+    RunAll<EntityStateWorkload>(messages, rate, extra);
+    RunAll<DebugEventWorkload>(messages, rate, extra);
+    return 0;
+}
@@ -0,0 +1,136 @@
+﻿// RiftSerializer/bench/ParallelReplayBenchmark.cpp
+//
+// Total time to decode a long replay: the sequential RiftReplayReader path
+// against RiftParallelReplayDecoder with 1 to 16 threads. Decoding applies
+// each frame to an entity state and emits one summary object per frame (the
+// tick and a checksum of the whole state); the consumer checks that ticks
+// arrive in order and that the checksums match the sequential decode.
+//
+// Usage: ParallelReplayBenchmark [path=/tmp/rift_parallel_replay.bin] [ticks=216000] [entities=1000] [keyframe_interval=300]
+
+#include "../include/Replay/ParallelReplayDecoder.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+using namespace RiftSerializer;
+
+namespace {
+
+    constexpr uint32 ENTITY_SCHEMA_ID = 7;
+    constexpr uint32 SUMMARY_SCHEMA_ID = 8;
+
+    void AddEntity(RiftBufferBuilder& builder, uint32 id, uint64 value) {
+        const size_t start = builder.BeginObject();
+        builder.Reserve(sizeof(RiftObjectHeader));
+        const uint64 fields[2] = { id, value };
+        builder.WriteRaw(fields, sizeof(fields));
+        builder.EndObject(start, ENTITY_SCHEMA_ID);
+    }
+
+    void Record(const char* path, uint64 ticks, uint32 entities, uint32 keyframe_interval) {
+        RiftReplayWriter writer(keyframe_interval);
+        writer.Open(path);
+        RiftBufferBuilder builder(entities * 48);
+        for (uint64 tick = 0; tick < ticks; ++tick) {
+            builder.Reset();
+            if (writer.IsKeyframeDue(tick)) {
+                for (uint32 id = 0; id < entities; ++id) AddEntity(builder, id, tick * entities + id);
+                writer.WriteKeyframe(tick, builder);
+            }
+            else {
+                for (uint32 i = 0; i < 8; ++i) AddEntity(builder, static_cast<uint32>((tick * 8 + i) % entities), tick);
+                writer.WriteDelta(tick, builder);
+            }
+        }
+        writer.Close();
+    }
+
+    // Rebuilds the entity state frame by frame. A keyframe overwrites every
+    // entity, so a copy starting at a keyframe needs no earlier state.
+    struct StateDecoder {
+        std::vector<uint64> state;
+
+        void operator()(const RiftReplayFrame& frame, RiftBufferBuilder& out) {
+            frame.ForEachObject([&](const RiftBufferViewBase& view) {
+                uint64 fields[2];
+                std::memcpy(fields, view.GetBufferStart() + sizeof(RiftObjectHeader), sizeof(fields));
+                if (fields[0] < state.size()) state[fields[0]] = fields[1];
+            });
+            uint64 checksum = 14695981039346656037ull;
+            for (const uint64 value : state) checksum = (checksum ^ value) * 1099511628211ull;
+            const size_t start = out.BeginObject();
+            out.Reserve(sizeof(RiftObjectHeader));
+            const uint64 fields[2] = { frame.tick, checksum };
+            out.WriteRaw(fields, sizeof(fields));
+            out.EndObject(start, SUMMARY_SCHEMA_ID);
+        }
+    };
+
+    struct Consumer {
+        uint64 frames = 0;
+        uint64 last_tick = 0;
+        uint64 digest = 0;
+        bool ordered = true;
+
+        void operator()(const RiftReplayFrame& frame) {
+            ordered &= frames == 0 || frame.tick > last_tick;
+            last_tick = frame.tick;
+            ++frames;
+            frame.ForEachObject([&](const RiftBufferViewBase& view) {
+                uint64 fields[2];
+                std::memcpy(fields, view.GetBufferStart() + sizeof(RiftObjectHeader), sizeof(fields));
+                digest = digest * 31 + fields[1];
+            });
+        }
+    };
+
+    double Seconds(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::string path = argc > 1 ? argv[1] : "/tmp/rift_parallel_replay.bin";
+    const uint64 ticks = argc > 2 ? std::stoull(argv[2]) : 216000;
+    const uint32 entities = argc > 3 ? static_cast<uint32>(std::stoul(argv[3])) : 1000;
+    const uint32 keyframe_interval = argc > 4 ? static_cast<uint32>(std::stoul(argv[4])) : 300;
+
+    Record(path.c_str(), ticks, entities, keyframe_interval);
+    RiftReplayReader reader;
+    if (!reader.Open(path.c_str())) {
+        std::printf("Failed to open %s\n", path.c_str());
+        return 1;
+    }
+    std::printf("%llu ticks, %zu keyframes, %.1f MB\n", static_cast<unsigned long long>(ticks), reader.GetKeyframeCount(),
+        static_cast<double>(reader.GetLogReader().GetMappedFile().GetSize()) / (1 << 20));
+
+    // Sequential: one decoder over every frame.
+    Consumer sequential;
+    {
+        const StateDecoder prototype{ std::vector<uint64>(entities) };
+        StateDecoder decoder = prototype;
+        RiftBufferBuilder out(4096);
+        const auto start = std::chrono::steady_clock::now();
+        while (reader.NextFrame([&](const RiftReplayFrame& frame) {
+            out.Reset();
+            decoder(frame, out);
+            sequential(RiftReplayFrame{ frame.tick, frame.kind, out.GetBufferPointer(), out.GetCurrentSize() });
+        })) {}
+        std::printf("sequential     %8.1f ms  %llu frames\n", Seconds(start) * 1e3, static_cast<unsigned long long>(sequential.frames));
+    }
+
+    for (const uint32 threads : { 1u, 2u, 4u, 8u, 16u }) {
+        RiftTaskExecutor executor(threads);
+        RiftParallelReplayDecoder decoder(executor);
+        Consumer consumer;
+        const auto start = std::chrono::steady_clock::now();
+        const RiftParallelReplayStats stats = decoder.Decode(reader, StateDecoder{ std::vector<uint64>(entities) }, consumer);
+        const double seconds = Seconds(start);
+        const bool match = consumer.ordered && consumer.frames == sequential.frames && consumer.digest == sequential.digest;
+        std::printf("%2u threads     %8.1f ms  %u blocks, %u consumer waits%s\n", threads, seconds * 1e3, stats.block_count,
+            stats.consumer_waits, match ? "" : "  MISMATCH");
+    }
+    return 0;
+}
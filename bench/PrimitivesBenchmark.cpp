@@ -0,0 +1,285 @@
+﻿// RiftSerializer/bench/PrimitivesBenchmark.cpp
+//
+// Microbenchmarks of the builder and accessor primitives every generated
+// schema is made of: WriteRaw, Reserve, PadToAlignment, AddString, AddArray,
+// EndObject, view construction, RiftArrayView::at and RiftStringView
+// conversions, each across a range of sizes.
+//
+// Every case is calibrated to run at least min_time_ms per sample; the median
+// and minimum of the samples are reported. --json prints one JSON object per
+// line and --csv a header plus rows, for tracking results per commit (pass the
+// commit as --label=<sha>).
+//
+// Usage: PrimitivesBenchmark [--json | --csv] [--filter=<substring>] [--label=<text>]
+//                            [--min-time-ms=20] [--repetitions=5]
+
+#include "../include/Accessor/Accessor.h"
+#include "../include/Builder/Builder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace RiftSerializer;
+
+namespace {
+
+    enum class OutputFormat { Text, Json, Csv };
+
+    struct Options {
+        OutputFormat format = OutputFormat::Text;
+        std::string filter;
+        std::string label;
+        double min_time_ms = 20.0;
+        uint32 repetitions = 5;
+    };
+
+    // Keeps the compiler from discarding a computed value.
+    template<typename T>
+    inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+
+    struct Measurement {
+        uint64 iterations = 0;
+        double median_ns = 0.0;
+        double min_ns = 0.0;
+    };
+
+    // body(iterations) runs the operation that many times.
+    template<typename Body>
+    Measurement Measure(const Options& options, Body&& body) {
+        using Clock = std::chrono::steady_clock;
+        const auto run = [&](uint64 iterations) {
+            const auto start = Clock::now();
+            body(iterations);
+            return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+        };
+
+        uint64 iterations = 1;
+        for (;;) {
+            const double elapsed = run(iterations);
+            if (elapsed >= options.min_time_ms * 1e6 || iterations >= (1ull << 40)) break;
+            // Aim a little past the target so one more round usually suffices.
+            const double scale = elapsed > 0.0 ? options.min_time_ms * 1e6 * 1.2 / elapsed : 100.0;
+            iterations = std::max<uint64>(iterations + 1, static_cast<uint64>(static_cast<double>(iterations) * std::min(scale, 100.0)));
+        }
+
+        std::vector<double> samples;
+        for (uint32 i = 0; i < options.repetitions; ++i) samples.push_back(run(iterations) / static_cast<double>(iterations));
+        std::sort(samples.begin(), samples.end());
+        return { iterations, samples[samples.size() / 2], samples.front() };
+    }
+
+    class Suite {
+    public:
+        explicit Suite(const Options& options) : m_options(options) {
+            if (m_options.format == OutputFormat::Csv) std::printf("label,benchmark,size,iterations,median_ns,min_ns,bytes_per_second\n");
+            if (m_options.format == OutputFormat::Text) {
+                std::printf("%-34s %10s %12s %12s %14s\n", "benchmark", "size", "median ns", "min ns", "MB/s");
+            }
+        }
+
+        // bytes_per_op is the payload one operation moves (0 if not meaningful).
+        template<typename Body>
+        void Run(const char* name, size_t size, size_t bytes_per_op, Body&& body) {
+            const std::string full_name = std::string(name) + "/" + std::to_string(size);
+            if (!m_options.filter.empty() && full_name.find(m_options.filter) == std::string::npos) return;
+
+            const Measurement m = Measure(m_options, body);
+            const double bytes_per_second = bytes_per_op > 0 && m.median_ns > 0.0 ? static_cast<double>(bytes_per_op) * 1e9 / m.median_ns : 0.0;
+            const auto iterations = static_cast<unsigned long long>(m.iterations);
+            switch (m_options.format) {
+            case OutputFormat::Json:
+                std::printf("{\"label\":\"%s\",\"benchmark\":\"%s\",\"size\":%zu,\"iterations\":%llu,\"median_ns\":%.3f,\"min_ns\":%.3f,\"bytes_per_second\":%.0f}\n",
+                    m_options.label.c_str(), name, size, iterations, m.median_ns, m.min_ns, bytes_per_second);
+                break;
+            case OutputFormat::Csv:
+                std::printf("%s,%s,%zu,%llu,%.3f,%.3f,%.0f\n", m_options.label.c_str(), name, size, iterations, m.median_ns, m.min_ns, bytes_per_second);
+                break;
+            default:
+                std::printf("%-34s %10zu %12.2f %12.2f %14.1f\n", name, size, m.median_ns, m.min_ns, bytes_per_second / 1e6);
+                break;
+            }
+            std::fflush(stdout);
+        }
+
+    private:
+        Options m_options;
+    };
+
+    // Builders are reset once they pass this size, so the measured cost is
+    // the steady-state append rather than vector growth.
+    constexpr size_t BUILDER_LIMIT = 1u << 20;
+
+    void RunBuilderBenchmarks(Suite& suite) {
+        for (size_t size : { 8u, 64u, 512u, 4096u, 65536u }) {
+            const std::vector<uint8> payload(size, 0xAB);
+            RiftBufferBuilder builder(BUILDER_LIMIT + size);
+            suite.Run("Builder.WriteRaw", size, size, [&](uint64 n) {
+                for (uint64 i = 0; i < n; ++i) {
+                    if (builder.GetCurrentSize() >= BUILDER_LIMIT) builder.Reset();
+                    builder.WriteRaw(payload.data(), size);
+                }
+                DoNotOptimize(builder.GetCurrentSize());
+            });
+        }
+
+        for (size_t size : { 8u, 64u, 512u, 4096u }) {
+            RiftBufferBuilder builder(BUILDER_LIMIT + size + 8);
+            suite.Run("Builder.Reserve", size, size, [&](uint64 n) {
+                for (uint64 i = 0; i < n; ++i) {
+                    if (builder.GetCurrentSize() >= BUILDER_LIMIT) builder.Reset();
+                    DoNotOptimize(builder.Reserve(size));
+                }
+            });
+        }
+
+        for (size_t alignment : { 4u, 8u, 16u, 64u }) {
+            RiftBufferBuilder builder(BUILDER_LIMIT + 2 * alignment);
+            const uint8 byte = 1;
+            suite.Run("Builder.PadToAlignment", alignment, 0, [&](uint64 n) {
+                for (uint64 i = 0; i < n; ++i) {
+                    if (builder.GetCurrentSize() >= BUILDER_LIMIT) builder.Reset();
+                    builder.WriteRaw(&byte, 1);
+                    builder.PadToAlignment(alignment);
+                }
+                DoNotOptimize(builder.GetCurrentSize());
+            });
+        }
+
+        for (size_t length : { 4u, 16u, 64u, 256u, 4096u }) {
+            const std::string text(length, 'x');
+            RiftBufferBuilder builder(BUILDER_LIMIT + length + 1);
+            suite.Run("Builder.AddString", length, length + 1, [&](uint64 n) {
+                for (uint64 i = 0; i < n; ++i) {
+                    if (builder.GetCurrentSize() >= BUILDER_LIMIT) builder.Reset();
+                    DoNotOptimize(builder.AddString(text));
+                }
+            });
+        }
+
+        for (size_t count : { 1u, 16u, 256u, 4096u }) {
+            const std::vector<uint32> values(count, 7);
+            RiftBufferBuilder builder(BUILDER_LIMIT + count * sizeof(uint32) + 4);
+            suite.Run("Builder.AddArray<uint32>", count, count * sizeof(uint32), [&](uint64 n) {
+                for (uint64 i = 0; i < n; ++i) {
+                    if (builder.GetCurrentSize() >= BUILDER_LIMIT) builder.Reset();
+                    DoNotOptimize(builder.AddArray(values));
+                }
+            });
+        }
+
+        for (size_t count : { 1u, 64u, 1024u }) {
+            const std::vector<glm::vec3> values(count, glm::vec3(1.0f, 2.0f, 3.0f));
+            RiftBufferBuilder builder(BUILDER_LIMIT + count * sizeof(glm::vec3) + 4);
+            suite.Run("Builder.AddArray<vec3>", count, count * sizeof(glm::vec3), [&](uint64 n) {
+                for (uint64 i = 0; i < n; ++i) {
+                    if (builder.GetCurrentSize() >= BUILDER_LIMIT) builder.Reset();
+                    DoNotOptimize(builder.AddArray(values));
+                }
+            });
+        }
+
+        // A whole fixed-size object: BeginObject, Reserve for header and fields, EndObject.
+        for (size_t fields : { 0u, 48u, 240u }) {
+            RiftBufferBuilder builder(BUILDER_LIMIT + fields + 64);
+            suite.Run("Builder.EndObject", fields, 0, [&](uint64 n) {
+                for (uint64 i = 0; i < n; ++i) {
+                    if (builder.GetCurrentSize() >= BUILDER_LIMIT) builder.Reset();
+                    const size_t start = builder.BeginObject();
+                    builder.Reserve(sizeof(RiftObjectHeader) + fields);
+                    builder.EndObject(start, 42);
+                }
+                DoNotOptimize(builder.GetCurrentSize());
+            });
+        }
+    }
+
+    void RunAccessorBenchmarks(Suite& suite) {
+        // A stream of objects of varying size, walked by offset.
+        for (size_t object_size : { 16u, 64u, 1024u }) {
+            RiftBufferBuilder builder(1u << 20);
+            std::vector<uint32> offsets;
+            for (uint32 i = 0; i < 4096; ++i) {
+                const size_t start = builder.BeginObject();
+                builder.Reserve(object_size);
+                builder.EndObject(start, i);
+                offsets.push_back(static_cast<uint32>(start));
+            }
+            const uint8* data = builder.GetBufferPointer();
+            suite.Run("View.Construct", object_size, 0, [&](uint64 n) {
+                uint64 sum = 0;
+                for (uint64 i = 0; i < n; ++i) {
+                    const RiftBufferViewBase view(data + offsets[i & 4095]);
+                    sum += view.GetSchemaId() + view.GetTotalSize();
+                }
+                DoNotOptimize(sum);
+            });
+        }
+
+        for (uint32 count : { 16u, 256u, 4096u }) {
+            std::vector<uint32> values(count);
+            for (uint32 i = 0; i < count; ++i) values[i] = i * 3;
+            RiftBufferBuilder builder(count * sizeof(uint32) + 64);
+            const uint32 offset = builder.AddArray(values);
+            const RiftArrayView<uint32, uint32> view(builder.GetBufferPointer() + offset, count);
+            suite.Run("ArrayView.at<uint32>", count, sizeof(uint32), [&](uint64 n) {
+                uint64 sum = 0;
+                for (uint64 i = 0; i < n; ++i) sum += view.at(static_cast<uint32>(i) & (count - 1));
+                DoNotOptimize(sum);
+            });
+        }
+
+        for (uint32 length : { 4u, 16u, 64u, 256u, 4096u }) {
+            const std::string text(length, 'y');
+            const RiftStringView view(text.data(), length);
+            suite.Run("StringView.to_std_string_view", length, 0, [&](uint64 n) {
+                for (uint64 i = 0; i < n; ++i) {
+                    DoNotOptimize(view);
+                    DoNotOptimize(view.to_std_string_view());
+                }
+            });
+            suite.Run("StringView.to_std_string", length, length, [&](uint64 n) {
+                for (uint64 i = 0; i < n; ++i) {
+                    std::string copy = view.to_std_string();
+                    DoNotOptimize(copy);
+                }
+            });
+        }
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            const auto value = [&](const char* prefix) { return arg.substr(std::strlen(prefix)); };
+            if (arg == "--json") options.format = OutputFormat::Json;
+            else if (arg == "--csv") options.format = OutputFormat::Csv;
+            else if (arg.rfind("--filter=", 0) == 0) options.filter = value("--filter=");
+            else if (arg.rfind("--label=", 0) == 0) options.label = value("--label=");
+            else if (arg.rfind("--min-time-ms=", 0) == 0) options.min_time_ms = std::stod(value("--min-time-ms="));
+            else if (arg.rfind("--repetitions=", 0) == 0) options.repetitions = std::max<uint32>(static_cast<uint32>(std::stoul(value("--repetitions="))), 1);
+            else {
+                std::fprintf(stderr, "Unknown argument: %s\n", arg.c_str());
+                return false;
+            }
+        }
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) return 1;
+    Suite suite(options);
+    RunBuilderBenchmarks(suite);
+    RunAccessorBenchmarks(suite);
+    return 0;
+}
@@ -0,0 +1,85 @@
+﻿// RiftSerializer/bench/ReplaySeekBenchmark.cpp
+//
+// Seek latency into replays of increasing length. Each tick changes a few
+// entities (a delta); every keyframe_interval ticks the full state is
+// written. Random seeks should cost the same whatever the replay length.
+//
+// Usage: ReplaySeekBenchmark [path=/tmp/rift_replay.bin] [entities=1000] [keyframe_interval=300] [seeks=2000]
+
+#include "../include/Replay/Replay.h"
+#include "../include/Stats/Histogram.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+
+using namespace RiftSerializer;
+
+namespace {
+
+    constexpr uint32 ENTITY_SCHEMA_ID = 7;
+
+    void AddEntity(RiftBufferBuilder& builder, uint32 id, uint64 value) {
+        const size_t start = builder.BeginObject();
+        builder.Reserve(sizeof(RiftObjectHeader));
+        const uint64 fields[2] = { id, value };
+        builder.WriteRaw(fields, sizeof(fields));
+        builder.EndObject(start, ENTITY_SCHEMA_ID);
+    }
+
+    void Record(const char* path, uint64 ticks, uint32 entities, uint32 keyframe_interval) {
+        RiftReplayWriter writer(keyframe_interval);
+        writer.Open(path);
+        RiftBufferBuilder builder(entities * 48);
+        for (uint64 tick = 0; tick < ticks; ++tick) {
+            builder.Reset();
+            if (writer.IsKeyframeDue(tick)) {
+                for (uint32 id = 0; id < entities; ++id) AddEntity(builder, id, tick);
+                writer.WriteKeyframe(tick, builder);
+            }
+            else {
+                for (uint32 i = 0; i < 8; ++i) AddEntity(builder, static_cast<uint32>((tick * 8 + i) % entities), tick);
+                writer.WriteDelta(tick, builder);
+            }
+        }
+        writer.Close();
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::string path = argc > 1 ? argv[1] : "/tmp/rift_replay.bin";
+    const uint32 entities = argc > 2 ? static_cast<uint32>(std::stoul(argv[2])) : 1000;
+    const uint32 keyframe_interval = argc > 3 ? static_cast<uint32>(std::stoul(argv[3])) : 300;
+    const uint32 seeks = argc > 4 ? static_cast<uint32>(std::stoul(argv[4])) : 2000;
+
+    std::vector<uint64> state(entities);
+    for (const uint64 ticks : { 18000ull, 72000ull, 216000ull }) { // 5, 20 and 60 minutes at 60 Hz
+        Record(path.c_str(), ticks, entities, keyframe_interval);
+
+        RiftReplayReader reader;
+        if (!reader.Open(path.c_str())) {
+            std::printf("Failed to open %s\n", path.c_str());
+            return 1;
+        }
+        RiftHistogram latency;
+        std::mt19937_64 rng(ticks);
+        for (uint32 i = 0; i < seeks; ++i) {
+            const uint64 target = rng() % ticks;
+            const auto start = std::chrono::steady_clock::now();
+            reader.Seek(target, [&](const RiftReplayFrame& frame) {
+                frame.ForEachObject([&](const RiftBufferViewBase& view) {
+                    uint64 fields[2];
+                    std::memcpy(fields, view.GetBufferStart() + sizeof(RiftObjectHeader), sizeof(fields));
+                    state[fields[0]] = fields[1];
+                });
+            });
+            latency.Record(static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+        }
+        std::printf("%7llu ticks (%4zu keyframes, %6.1f MB): seek mean %7.1f us, p99 <= %7.1f us\n",
+            static_cast<unsigned long long>(ticks), reader.GetKeyframeCount(),
+            static_cast<double>(reader.GetLogReader().GetMappedFile().GetSize()) / (1 << 20),
+            latency.GetMean() / 1000.0, static_cast<double>(latency.GetPercentile(99)) / 1000.0);
+    }
+    return 0;
+}
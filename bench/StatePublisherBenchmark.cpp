@@ -0,0 +1,144 @@
+﻿// RiftSerializer/bench/StatePublisherBenchmark.cpp
+//
+// Readers fetching the latest serialized world state while a writer publishes
+// a new one every tick: RiftStatePublisher (pin + view in place) against a
+// mutex-protected buffer that every reader copies out. Reports reader
+// ns/access and the writer's publish cost.
+//
+// Usage: StatePublisherBenchmark [readers=3] [state_kb=256] [seconds=2]
+
+#include "../include/Concurrency/StatePublisher.h"
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace RiftSerializer;
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+    constexpr uint32 WORLD_STATE_SCHEMA_ID = 400;
+
+    // [header][tick u64][entities...], the tick repeated in the last word.
+    template<typename Builder>
+    void BuildState(Builder& builder, uint64 tick, size_t state_bytes) {
+        const size_t start = builder.BeginObject();
+        const size_t body = builder.Reserve(state_bytes);
+        builder.WriteAt(body + sizeof(RiftObjectHeader), &tick, sizeof(tick));
+        builder.WriteAt(body + state_bytes - sizeof(tick), &tick, sizeof(tick));
+        builder.EndObject(start, WORLD_STATE_SCHEMA_ID);
+    }
+
+    // What a reader does with the state: read a few fields and check that the
+    // state is not torn.
+    bool ReadState(const uint8* object) {
+        const RiftBufferViewBase view(object);
+        uint64 first, last;
+        std::memcpy(&first, view.GetPtrAtOffset(sizeof(RiftObjectHeader), sizeof(first)), sizeof(first));
+        std::memcpy(&last, view.GetPtrAtOffset(view.GetTotalSize() - sizeof(last), sizeof(last)), sizeof(last));
+        return first == last;
+    }
+
+    struct Result {
+        double reader_ns;
+        double publish_ns;
+        uint64 reads;
+        uint64 torn;
+    };
+
+    template<typename Writer, typename Reader>
+    Result Run(uint32 readers, double seconds, Writer&& write, Reader&& read) {
+        std::atomic<bool> running{ true };
+        std::atomic<uint64> reads{ 0 }, torn{ 0 }, reader_ns{ 0 };
+        std::vector<std::thread> threads;
+        for (uint32 r = 0; r < readers; ++r) {
+            threads.emplace_back([&] {
+                auto local = read();
+                uint64 count = 0, bad = 0;
+                const auto start = Clock::now();
+                while (running.load(std::memory_order_relaxed)) {
+                    bad += local() ? 0 : 1;
+                    ++count;
+                }
+                reader_ns += static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+                reads += count;
+                torn += bad;
+            });
+        }
+        uint64 ticks = 0;
+        double publish_seconds = 0.0;
+        const auto end = Clock::now() + std::chrono::duration<double>(seconds);
+        while (Clock::now() < end) {
+            const auto start = Clock::now();
+            write(++ticks);
+            publish_seconds += std::chrono::duration<double>(Clock::now() - start).count();
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        }
+        running = false;
+        for (auto& thread : threads) thread.join();
+        return { reads ? static_cast<double>(reader_ns) / static_cast<double>(reads) : 0.0,
+            publish_seconds * 1e9 / static_cast<double>(ticks), reads.load(), torn.load() };
+    }
+
+    void Report(const char* name, const Result& result) {
+        std::printf("%-18s reader %9.1f ns/access  publish %9.1f ns  reads %10llu  torn %llu\n", name, result.reader_ns,
+            result.publish_ns, static_cast<unsigned long long>(result.reads), static_cast<unsigned long long>(result.torn));
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const uint32 readers = argc > 1 ? static_cast<uint32>(std::stoul(argv[1])) : 3;
+    const size_t state_bytes = std::max<size_t>((argc > 2 ? std::stoull(argv[2]) : 256) << 10, 64);
+    const double seconds = argc > 3 ? std::stod(argv[3]) : 2.0;
+
+    // Mutex + copy: the writer builds privately and swaps under the lock;
+    // readers copy the whole state out under the lock.
+    {
+        std::mutex mutex;
+        RiftBufferBuilder shared(state_bytes + 64);
+        RiftBufferBuilder staging(state_bytes + 64);
+        const Result result = Run(readers, seconds,
+            [&](uint64 tick) {
+                staging.Reset();
+                BuildState(staging, tick, state_bytes);
+                std::lock_guard<std::mutex> lock(mutex);
+                shared.Reset();
+                shared.WriteRaw(staging.GetBufferPointer(), staging.GetCurrentSize());
+            },
+            [&] {
+                return [&, copy = std::vector<uint64>(state_bytes / sizeof(uint64) + 8)]() mutable {
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (shared.GetCurrentSize() == 0) return true;
+                        std::memcpy(copy.data(), shared.GetBufferPointer(), shared.GetCurrentSize());
+                    }
+                    return ReadState(reinterpret_cast<const uint8*>(copy.data()));
+                };
+            });
+        Report("mutex + copy", result);
+    }
+
+    // Publisher: zero-copy views pinned by epoch.
+    {
+        RiftStatePublisher publisher(readers + 1, 8, state_bytes + 64);
+        const Result result = Run(readers, seconds,
+            [&](uint64 tick) {
+                RiftBufferBuilder* builder;
+                while (!(builder = publisher.BeginWrite())) std::this_thread::yield();
+                BuildState(*builder, tick, state_bytes);
+                publisher.Publish();
+            },
+            [&] {
+                return [reader = publisher.CreateReader()]() mutable {
+                    const RiftStateSnapshot snapshot = reader.Acquire();
+                    return !snapshot.IsValid() || ReadState(snapshot.GetData());
+                };
+            });
+        Report("state publisher", result);
+    }
+    return 0;
+}
@@ -32,6 +32,7 @@ namespace RiftSerializer {
 
         uint32 GetSchemaId() const { return from_little_endian(m_header->schema_id); }
         uint32 GetTotalSize() const { return from_little_endian(m_header->total_size); }
+        const uint8* GetBufferStart() const { return m_buffer_start; }
 
         const uint8* GetPtrAtOffset(uint32 offset, size_t size_needed = 1) const {
             RIFT_ASSERT(offset + size_needed <= GetTotalSize(), "Memory access out of object bounds.");
@@ -39,6 +40,16 @@ namespace RiftSerializer {
         }
     };
 
+    // Checks the header at data (8-aligned) against the bytes available and
+    // returns the object's total_size, or 0 if it is not a valid object.
+    inline uint32 rift_verify_object_header(const uint8* data, size_t available) {
+        if (available < sizeof(RiftObjectHeader) || !is_aligned(data, alignof(RiftObjectHeader))) return 0;
+        const auto* header = reinterpret_cast<const RiftObjectHeader*>(data);
+        const uint32 total_size = from_little_endian(header->total_size);
+        if (from_little_endian(header->magic) != RIFT_MAGIC_NUMBER || total_size < sizeof(RiftObjectHeader) || total_size > available) return 0;
+        return total_size;
+    }
+
     // --- RiftStringView ---
     // A simple, zero-copy string view.
     class RiftStringView {
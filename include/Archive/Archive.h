@@ -0,0 +1,258 @@
+﻿// RiftSerializer/include/RiftSerializer/Archive.h
+//
+// Multi-object archive files with a trailing, sorted index.
+//
+// Layout:
+//   [object 0][pad to 8][object 1][pad to 8]...[index entries][footer]
+//
+// The footer is fixed-size and sits at the very end of the file, so a reader
+// only touches the footer on open and maps the index in place; open cost does
+// not depend on the number or size of the objects.
+
+#pragma once
+
+#include "../Accessor/Accessor.h"
+#include "../Platform/File.h"
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace RiftSerializer {
+
+    // 'RFA1' in Little Endian (version 1)
+    constexpr uint32 RIFT_ARCHIVE_MAGIC_NUMBER = 0x31414652;
+    constexpr uint32 RIFT_ARCHIVE_VERSION = 1;
+
+    // --- RiftArchiveIndexEntry ---
+    // One entry (24 bytes) per object, sorted by (key, schema_id).
+    struct alignas(8) RiftArchiveIndexEntry {
+        uint64 key;       // Caller-defined lookup key (entity id, asset hash, ...)
+        uint64 offset;    // File offset of the object's RiftObjectHeader
+        uint32 schema_id; // Copied from the object header
+        uint32 size;      // Copied from the object header (total_size)
+
+        uint64 GetKey() const { return from_little_endian(key); }
+        uint64 GetOffset() const { return from_little_endian(offset); }
+        uint32 GetSchemaId() const { return from_little_endian(schema_id); }
+        uint32 GetSize() const { return from_little_endian(size); }
+    };
+    static_assert(sizeof(RiftArchiveIndexEntry) == 24, "RiftArchiveIndexEntry must be 24 bytes.");
+
+    // --- RiftArchiveFooter ---
+    // The last 32 bytes of every archive.
+    struct alignas(8) RiftArchiveFooter {
+        uint32 magic;        // 'RFA1'
+        uint32 version;
+        uint64 entry_count;
+        uint64 index_offset; // File offset of the first RiftArchiveIndexEntry
+        uint64 reserved;
+    };
+    static_assert(sizeof(RiftArchiveFooter) == 32, "RiftArchiveFooter must be 32 bytes.");
+
+    // --- RiftArchiveWriter ---
+    // Appends finished RiftObjects to a file and writes the index on Finish().
+    // Objects are staged and written in large chunks.
+    class RiftArchiveWriter {
+    public:
+        explicit RiftArchiveWriter(size_t staging_capacity = 1u << 20)
+            : m_staging_capacity(staging_capacity) {
+            m_staging.reserve(staging_capacity);
+        }
+        ~RiftArchiveWriter() { Finish(); }
+
+        bool Open(const char* path) {
+            m_entries.clear();
+            m_staging.clear();
+            m_file_offset = 0;
+            return m_file.Open(path, RiftFileMode::Write);
+        }
+
+        // Adds one complete RiftObject (header included) under the given key.
+        bool Add(uint64 key, const void* object) {
+            RIFT_ASSERT(m_file.IsOpen(), "Archive is not open.");
+            const RiftBufferViewBase view(object);
+            const uint32 size = view.GetTotalSize();
+
+            RiftArchiveIndexEntry entry;
+            entry.key = to_little_endian(key);
+            entry.offset = to_little_endian(m_file_offset + m_staging.size());
+            entry.schema_id = to_little_endian(view.GetSchemaId());
+            entry.size = to_little_endian(size);
+            m_entries.push_back(entry);
+
+            if (!Stage(object, size)) return false;
+            return Stage(nullptr, align_up(size, alignof(RiftObjectHeader)) - size);
+        }
+
+        // Sorts and writes the index and footer, then closes the file.
+        bool Finish() {
+            if (!m_file.IsOpen()) return false;
+
+            std::sort(m_entries.begin(), m_entries.end(), [](const RiftArchiveIndexEntry& a, const RiftArchiveIndexEntry& b) {
+                return a.GetKey() != b.GetKey() ? a.GetKey() < b.GetKey() : a.GetSchemaId() < b.GetSchemaId();
+            });
+
+            RiftArchiveFooter footer{};
+            footer.magic = to_little_endian(RIFT_ARCHIVE_MAGIC_NUMBER);
+            footer.version = to_little_endian(RIFT_ARCHIVE_VERSION);
+            footer.entry_count = to_little_endian(static_cast<uint64>(m_entries.size()));
+            footer.index_offset = to_little_endian(m_file_offset + m_staging.size());
+
+            bool ok = Stage(m_entries.data(), m_entries.size() * sizeof(RiftArchiveIndexEntry));
+            ok = ok && Stage(&footer, sizeof(footer));
+            ok = ok && Flush();
+            m_file.Close();
+            m_entries.clear();
+            return ok;
+        }
+
+    private:
+        // Appends bytes to the staging buffer (zeros if data is null).
+        bool Stage(const void* data, size_t size) {
+            if (m_staging.size() + size > m_staging_capacity && !Flush()) return false;
+            if (size >= m_staging_capacity) {
+                if (!data) {
+                    m_staging.resize(size, 0);
+                    return Flush();
+                }
+                m_file_offset += size;
+                return m_file.Write(data, size);
+            }
+            if (data) {
+                const auto* bytes = static_cast<const uint8*>(data);
+                m_staging.insert(m_staging.end(), bytes, bytes + size);
+            }
+            else {
+                m_staging.resize(m_staging.size() + size, 0);
+            }
+            return true;
+        }
+
+        bool Flush() {
+            if (m_staging.empty()) return true;
+            const bool ok = m_file.Write(m_staging.data(), m_staging.size());
+            m_file_offset += m_staging.size();
+            m_staging.clear();
+            return ok;
+        }
+
+        RiftFile m_file;
+        std::vector<uint8> m_staging;
+        size_t m_staging_capacity;
+        uint64 m_file_offset = 0;
+        std::vector<RiftArchiveIndexEntry> m_entries;
+    };
+
+    // --- RiftArchiveReader ---
+    // Maps an archive and serves objects in place. Nothing is copied: views
+    // and index entries point directly into the mapping and stay valid until
+    // Close() or destruction.
+    class RiftArchiveReader {
+    public:
+        bool Open(const char* path) {
+            Close();
+            if (!m_file.Open(path)) return false;
+
+            const size_t file_size = m_file.GetSize();
+            if (file_size < sizeof(RiftArchiveFooter)) return Fail();
+            const auto* footer = reinterpret_cast<const RiftArchiveFooter*>(m_file.GetData() + file_size - sizeof(RiftArchiveFooter));
+            if (!is_aligned(footer, alignof(RiftArchiveFooter)) ||
+                from_little_endian(footer->magic) != RIFT_ARCHIVE_MAGIC_NUMBER ||
+                from_little_endian(footer->version) != RIFT_ARCHIVE_VERSION) {
+                return Fail();
+            }
+
+            const uint64 count = from_little_endian(footer->entry_count);
+            const uint64 index_offset = from_little_endian(footer->index_offset);
+            const uint64 index_end = file_size - sizeof(RiftArchiveFooter);
+            // Bound count before multiplying so a corrupt footer cannot wrap the size check.
+            if (index_offset % alignof(RiftArchiveIndexEntry) != 0 || index_offset > index_end ||
+                count > (index_end - index_offset) / sizeof(RiftArchiveIndexEntry) ||
+                index_end - index_offset != count * sizeof(RiftArchiveIndexEntry)) {
+                return Fail();
+            }
+
+            m_entries = reinterpret_cast<const RiftArchiveIndexEntry*>(m_file.GetData() + index_offset);
+            m_entry_count = static_cast<size_t>(count);
+            m_index_offset = index_offset;
+            return true;
+        }
+
+        void Close() {
+            m_file.Close();
+            m_entries = nullptr;
+            m_entry_count = 0;
+            m_index_offset = 0;
+        }
+
+        bool IsOpen() const { return m_file.IsOpen(); }
+        size_t GetObjectCount() const { return m_entry_count; }
+        const RiftArchiveIndexEntry& GetEntry(size_t index) const {
+            RIFT_ASSERT(index < m_entry_count, "Archive index out of bounds.");
+            return m_entries[index];
+        }
+
+        // Returns a pointer to the object's RiftObjectHeader inside the mapping,
+        // or nullptr if the entry points outside the object region or the
+        // object's own header is corrupt or larger than the entry.
+        const void* GetObjectData(const RiftArchiveIndexEntry& entry) const {
+            const uint64 offset = entry.GetOffset();
+            const uint64 size = entry.GetSize();
+            if (offset % alignof(RiftObjectHeader) != 0 || size < sizeof(RiftObjectHeader) || size > m_index_offset || offset > m_index_offset - size) {
+                return nullptr;
+            }
+            const uint8* data = m_file.GetData() + offset;
+            return rift_verify_object_header(data, static_cast<size_t>(size)) != 0 ? data : nullptr;
+        }
+
+        // Empty if the entry or its object is corrupt.
+        std::optional<RiftBufferViewBase> GetObject(size_t index) const {
+            const void* data = GetObjectData(GetEntry(index));
+            if (!data) return std::nullopt;
+            return RiftBufferViewBase(data);
+        }
+
+        // Binary search over the mapped index. Returns the first entry with
+        // the key, or nullptr. Entries sharing a key are adjacent.
+        const RiftArchiveIndexEntry* FindEntry(uint64 key) const {
+            const RiftArchiveIndexEntry* end = m_entries + m_entry_count;
+            const RiftArchiveIndexEntry* it = std::lower_bound(m_entries, end, key,
+                [](const RiftArchiveIndexEntry& e, uint64 k) { return e.GetKey() < k; });
+            return (it != end && it->GetKey() == key) ? it : nullptr;
+        }
+
+        const RiftArchiveIndexEntry* FindEntry(uint64 key, uint32 schema_id) const {
+            const RiftArchiveIndexEntry* end = m_entries + m_entry_count;
+            const RiftArchiveIndexEntry* it = std::lower_bound(m_entries, end, std::make_pair(key, schema_id),
+                [](const RiftArchiveIndexEntry& e, const std::pair<uint64, uint32>& k) {
+                    return e.GetKey() != k.first ? e.GetKey() < k.first : e.GetSchemaId() < k.second;
+                });
+            return (it != end && it->GetKey() == key && it->GetSchemaId() == schema_id) ? it : nullptr;
+        }
+
+        // Pointer suitable for constructing a generated _View, or nullptr if not found.
+        const void* FindObject(uint64 key) const {
+            const RiftArchiveIndexEntry* entry = FindEntry(key);
+            return entry ? GetObjectData(*entry) : nullptr;
+        }
+
+        const void* FindObject(uint64 key, uint32 schema_id) const {
+            const RiftArchiveIndexEntry* entry = FindEntry(key, schema_id);
+            return entry ? GetObjectData(*entry) : nullptr;
+        }
+
+        const RiftMappedFile& GetMappedFile() const { return m_file; }
+
+    private:
+        bool Fail() {
+            Close();
+            return false;
+        }
+
+        RiftMappedFile m_file;
+        const RiftArchiveIndexEntry* m_entries = nullptr;
+        size_t m_entry_count = 0;
+        uint64 m_index_offset = 0;
+    };
+
+} // namespace RiftSerializer
@@ -0,0 +1,148 @@
+﻿// RiftSerializer/include/RiftSerializer/AsyncArchiveReader.h
+//
+// Completion-driven archive reader. Object reads go through RiftAsyncIo into
+// registered pool buffers and are delivered as RiftBufferViewBase once the
+// I/O completes, so many reads can be in flight without blocking the caller.
+
+#pragma once
+
+#include "AsyncIO.h"
+#include "../Archive/Archive.h"
+
+namespace RiftSerializer {
+
+    class RiftAsyncArchiveReader {
+    public:
+        // max_object_size bounds the objects that can be requested; each
+        // in-flight request holds one buffer of that size.
+        explicit RiftAsyncArchiveReader(uint32 queue_depth = 64, size_t max_object_size = 64u << 10)
+            : m_pool(queue_depth, max_object_size), m_queue_depth(queue_depth) {
+            m_completions.resize(queue_depth);
+            m_requests.resize(queue_depth);
+        }
+
+        // Waits for reads in flight: they write into m_pool's buffers.
+        ~RiftAsyncArchiveReader() { Close(); }
+
+        // Reads the footer and index with two positional reads. Objects are
+        // fetched lazily through Request().
+        bool Open(const char* path, bool allow_io_uring = true) {
+            Close();
+            if (!m_file.Open(path, RiftFileMode::Read)) return false;
+
+            const uint64 file_size = m_file.GetSize();
+            RiftArchiveFooter footer;
+            if (file_size < sizeof(footer) || !m_file.ReadAt(file_size - sizeof(footer), &footer, sizeof(footer)) ||
+                from_little_endian(footer.magic) != RIFT_ARCHIVE_MAGIC_NUMBER ||
+                from_little_endian(footer.version) != RIFT_ARCHIVE_VERSION) {
+                return Fail();
+            }
+            const uint64 count = from_little_endian(footer.entry_count);
+            const uint64 index_offset = from_little_endian(footer.index_offset);
+            const uint64 index_end = file_size - sizeof(footer);
+            if (index_offset > index_end || count > (index_end - index_offset) / sizeof(RiftArchiveIndexEntry) ||
+                index_end - index_offset != count * sizeof(RiftArchiveIndexEntry)) {
+                return Fail();
+            }
+            m_entries.resize(static_cast<size_t>(count));
+            if (count > 0 && !m_file.ReadAt(index_offset, m_entries.data(), m_entries.size() * sizeof(RiftArchiveIndexEntry))) {
+                return Fail();
+            }
+            m_index_offset = index_offset;
+
+            if (!m_io.Init(m_queue_depth, allow_io_uring)) return Fail();
+            m_io.RegisterBuffers(m_pool);
+            return true;
+        }
+
+        void Close() {
+            Drain();
+            m_io.Close();
+            m_file.Close();
+            m_entries.clear();
+        }
+
+        RiftAsyncIoBackend GetBackend() const { return m_io.GetBackend(); }
+        size_t GetObjectCount() const { return m_entries.size(); }
+        const RiftArchiveIndexEntry& GetEntry(size_t index) const { return m_entries[index]; }
+        uint32 GetInFlight() const { return m_io.GetInFlight(); }
+        bool CanRequest() const { return m_pool.GetFreeCount() > 0; }
+
+        const RiftArchiveIndexEntry* FindEntry(uint64 key) const {
+            auto it = std::lower_bound(m_entries.begin(), m_entries.end(), key,
+                [](const RiftArchiveIndexEntry& e, uint64 k) { return e.GetKey() < k; });
+            return (it != m_entries.end() && it->GetKey() == key) ? &*it : nullptr;
+        }
+
+        // Queues a read of the object. Returns false if every buffer is in use
+        // or the object is larger than max_object_size. Reads are only handed
+        // to the kernel on the next Poll(), so consecutive requests batch.
+        bool Request(const RiftArchiveIndexEntry& entry, uint64 user_data) {
+            const uint32 size = entry.GetSize();
+            if (size < sizeof(RiftObjectHeader) || size > m_pool.GetBufferSize() || size > m_index_offset || entry.GetOffset() > m_index_offset - size) return false;
+            const int32 buffer = m_pool.Acquire();
+            if (buffer < 0) return false;
+
+            m_requests[buffer] = user_data;
+            const RiftIoRequest request{ RiftIoOp::Read, &m_file, m_pool.GetBuffer(buffer), size, entry.GetOffset(), buffer, static_cast<uint64>(buffer) };
+            if (!m_io.Prepare(request)) {
+                m_pool.Release(static_cast<uint32>(buffer));
+                return false;
+            }
+            return true;
+        }
+
+        // Submits queued reads and delivers finished ones as
+        // on_object(user_data, const RiftBufferViewBase* view). view is null if
+        // the read failed or did not contain a valid object. The view is only
+        // valid during the callback. If wait is set, blocks until at least one
+        // read completes (when any are in flight).
+        template<typename Callback>
+        uint32 Poll(Callback&& on_object, bool wait = false) {
+            m_io.Submit();
+            const uint32 count = wait ? m_io.WaitAndReap(m_completions.data(), m_queue_depth)
+                : m_io.Reap(m_completions.data(), m_queue_depth);
+            for (uint32 i = 0; i < count; ++i) {
+                const RiftIoCompletion& completion = m_completions[i];
+                const auto buffer = static_cast<uint32>(completion.user_data);
+                const uint8* data = m_pool.GetBuffer(buffer);
+                const auto* header = reinterpret_cast<const RiftObjectHeader*>(data);
+                if (completion.result >= static_cast<int64>(sizeof(RiftObjectHeader)) &&
+                    from_little_endian(header->magic) == RIFT_MAGIC_NUMBER &&
+                    from_little_endian(header->total_size) <= completion.result) {
+                    const RiftBufferViewBase view(data);
+                    on_object(m_requests[buffer], &view);
+                }
+                else {
+                    on_object(m_requests[buffer], static_cast<const RiftBufferViewBase*>(nullptr));
+                }
+                m_pool.Release(buffer);
+            }
+            return count;
+        }
+
+    private:
+        bool Fail() {
+            m_file.Close();
+            m_entries.clear();
+            return false;
+        }
+
+        void Drain() {
+            while (m_io.GetInFlight() > 0) {
+                Poll([](uint64, const RiftBufferViewBase*) {}, true);
+            }
+        }
+
+        // Declared so the ring is torn down before the file and the buffers registered with it.
+        RiftFile m_file;
+        RiftIoBufferPool m_pool;
+        RiftAsyncIo m_io;
+        uint32 m_queue_depth;
+        std::vector<RiftArchiveIndexEntry> m_entries;
+        std::vector<RiftIoCompletion> m_completions;
+        std::vector<uint64> m_requests;
+        uint64 m_index_offset = 0;
+    };
+
+} // namespace RiftSerializer
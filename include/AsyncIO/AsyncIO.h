@@ -0,0 +1,435 @@
+﻿// RiftSerializer/include/RiftSerializer/AsyncIO.h
+//
+// Asynchronous positional file I/O for the archive and log components.
+//
+// On Linux the primary backend is io_uring, driven through the raw system
+// calls so there is no liburing dependency: requests are batched into the
+// submission ring and flushed with a single io_uring_enter, and buffers from
+// a RiftIoBufferPool can be registered so reads and writes use the *_FIXED
+// opcodes. Everywhere else (or when the kernel refuses io_uring) a small
+// thread pool running pread/pwrite provides the same interface.
+
+#pragma once
+
+#include "../Memory/AlignedBuffer.h"
+#include "../Platform/File.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__) && !defined(RIFT_SERIALIZER_NO_IO_URING)
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && defined(__NR_io_uring_register)
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+#define RIFT_SERIALIZER_HAS_IO_URING 1
+#endif
+#endif
+
+namespace RiftSerializer {
+
+    // --- RiftIoBufferPool ---
+    // A fixed set of equally sized, aligned I/O buffers carved from one
+    // allocation. Buffer indices double as io_uring registered-buffer indices.
+    // Not thread-safe: owned by the thread that drives the I/O.
+    class RiftIoBufferPool {
+    public:
+        RiftIoBufferPool(uint32 buffer_count, size_t buffer_size, size_t alignment = 4096)
+            : m_buffer_size(align_up(buffer_size, alignment)), m_buffer_count(buffer_count) {
+            m_storage.Allocate(m_buffer_size * buffer_count, alignment);
+            m_free.reserve(buffer_count);
+            for (uint32 i = buffer_count; i > 0; --i) m_free.push_back(i - 1);
+        }
+
+        uint32 GetBufferCount() const { return m_buffer_count; }
+        size_t GetBufferSize() const { return m_buffer_size; }
+        uint32 GetFreeCount() const { return static_cast<uint32>(m_free.size()); }
+        uint8* GetBuffer(uint32 index) { return m_storage.GetData() + static_cast<size_t>(index) * m_buffer_size; }
+
+        // Returns a free buffer index, or -1 if all buffers are in use.
+        int32 Acquire() {
+            if (m_free.empty()) return -1;
+            const uint32 index = m_free.back();
+            m_free.pop_back();
+            return static_cast<int32>(index);
+        }
+
+        void Release(uint32 index) {
+            RIFT_ASSERT(index < m_buffer_count, "Buffer index out of range.");
+            m_free.push_back(index);
+        }
+
+    private:
+        RiftAlignedBuffer m_storage;
+        size_t m_buffer_size;
+        uint32 m_buffer_count;
+        std::vector<uint32> m_free;
+    };
+
+    enum class RiftIoOp : uint8 { Read, Write };
+
+    struct RiftIoRequest {
+        RiftIoOp op;
+        RiftFile* file;
+        void* buffer;
+        uint32 size;
+        uint64 offset;
+        int32 buffer_index;  // Registered pool buffer holding `buffer`, or -1
+        uint64 user_data;
+    };
+
+    struct RiftIoCompletion {
+        uint64 user_data;
+        int64 result;        // Bytes transferred, or a negative error code
+    };
+
+#ifdef RIFT_SERIALIZER_HAS_IO_URING
+    // --- RiftUringIo ---
+    class RiftUringIo {
+    public:
+        RiftUringIo() = default;
+        ~RiftUringIo() { Close(); }
+        RiftUringIo(const RiftUringIo&) = delete;
+        RiftUringIo& operator=(const RiftUringIo&) = delete;
+
+        bool Init(uint32 entries) {
+            Close();
+            io_uring_params params{};
+            const long fd = ::syscall(__NR_io_uring_setup, entries, &params);
+            if (fd < 0) return false;
+            m_fd = static_cast<int>(fd);
+
+            m_sq_map_size = params.sq_off.array + params.sq_entries * sizeof(uint32);
+            m_cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (single_mmap) m_sq_map_size = m_cq_map_size = std::max(m_sq_map_size, m_cq_map_size);
+
+            m_sq_map = ::mmap(nullptr, m_sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+            if (m_sq_map == MAP_FAILED) { m_sq_map = nullptr; Close(); return false; }
+            if (single_mmap) {
+                m_cq_map = m_sq_map;
+            }
+            else {
+                m_cq_map = ::mmap(nullptr, m_cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+                if (m_cq_map == MAP_FAILED) { m_cq_map = nullptr; Close(); return false; }
+            }
+            m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+            void* sqes = ::mmap(nullptr, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+            if (sqes == MAP_FAILED) { Close(); return false; }
+            m_sqes = static_cast<io_uring_sqe*>(sqes);
+
+            auto* sq = static_cast<uint8*>(m_sq_map);
+            m_sq_head = reinterpret_cast<uint32*>(sq + params.sq_off.head);
+            m_sq_tail = reinterpret_cast<uint32*>(sq + params.sq_off.tail);
+            m_sq_mask = *reinterpret_cast<uint32*>(sq + params.sq_off.ring_mask);
+            m_sq_array = reinterpret_cast<uint32*>(sq + params.sq_off.array);
+            m_sq_entries = params.sq_entries;
+
+            auto* cq = static_cast<uint8*>(m_cq_map);
+            m_cq_head = reinterpret_cast<uint32*>(cq + params.cq_off.head);
+            m_cq_tail = reinterpret_cast<uint32*>(cq + params.cq_off.tail);
+            m_cq_mask = *reinterpret_cast<uint32*>(cq + params.cq_off.ring_mask);
+            m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+            return true;
+        }
+
+        void Close() {
+            if (m_sqes) ::munmap(m_sqes, m_sqes_size);
+            if (m_cq_map && m_cq_map != m_sq_map) ::munmap(m_cq_map, m_cq_map_size);
+            if (m_sq_map) ::munmap(m_sq_map, m_sq_map_size);
+            if (m_fd >= 0) ::close(m_fd);
+            m_sqes = nullptr;
+            m_sq_map = m_cq_map = nullptr;
+            m_fd = -1;
+            m_unsubmitted = 0;
+            m_buffers_registered = false;
+        }
+
+        bool RegisterBuffers(RiftIoBufferPool& pool) {
+            std::vector<iovec> iovecs(pool.GetBufferCount());
+            for (uint32 i = 0; i < pool.GetBufferCount(); ++i) {
+                iovecs[i].iov_base = pool.GetBuffer(i);
+                iovecs[i].iov_len = pool.GetBufferSize();
+            }
+            m_buffers_registered = ::syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_BUFFERS, iovecs.data(), static_cast<unsigned>(iovecs.size())) == 0;
+            return m_buffers_registered;
+        }
+
+        // Queues a request in the submission ring. Returns false if the ring is full.
+        bool Prepare(const RiftIoRequest& request) {
+            const uint32 tail = *m_sq_tail;
+            if (tail - __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE) >= m_sq_entries) return false;
+
+            const uint32 index = tail & m_sq_mask;
+            io_uring_sqe* sqe = &m_sqes[index];
+            std::memset(sqe, 0, sizeof(*sqe));
+            const bool fixed = m_buffers_registered && request.buffer_index >= 0;
+            if (request.op == RiftIoOp::Read) sqe->opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+            else sqe->opcode = fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+            sqe->fd = request.file->GetNativeHandle();
+            sqe->addr = reinterpret_cast<uint64>(request.buffer);
+            sqe->len = request.size;
+            sqe->off = request.offset;
+            sqe->user_data = request.user_data;
+            if (fixed) sqe->buf_index = static_cast<uint16>(request.buffer_index);
+
+            m_sq_array[index] = index;
+            __atomic_store_n(m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+            ++m_unsubmitted;
+            return true;
+        }
+
+        // Hands every prepared request to the kernel in one call, optionally
+        // blocking until at least wait_for completions are available.
+        uint32 Submit(uint32 wait_for = 0) {
+            for (;;) {
+                const long submitted = ::syscall(__NR_io_uring_enter, m_fd, m_unsubmitted, wait_for,
+                    wait_for > 0 ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+                if (submitted >= 0) {
+                    m_unsubmitted -= static_cast<uint32>(submitted);
+                    return static_cast<uint32>(submitted);
+                }
+                if (errno != EINTR) return 0;
+            }
+        }
+
+        uint32 Reap(RiftIoCompletion* out, uint32 max) {
+            uint32 head = *m_cq_head;
+            const uint32 tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE);
+            uint32 count = 0;
+            while (head != tail && count < max) {
+                const io_uring_cqe& cqe = m_cqes[head & m_cq_mask];
+                out[count++] = { cqe.user_data, cqe.res };
+                ++head;
+            }
+            __atomic_store_n(m_cq_head, head, __ATOMIC_RELEASE);
+            return count;
+        }
+
+    private:
+        int m_fd = -1;
+        void* m_sq_map = nullptr;
+        void* m_cq_map = nullptr;
+        size_t m_sq_map_size = 0;
+        size_t m_cq_map_size = 0;
+        size_t m_sqes_size = 0;
+        io_uring_sqe* m_sqes = nullptr;
+        uint32* m_sq_head = nullptr;
+        uint32* m_sq_tail = nullptr;
+        uint32* m_sq_array = nullptr;
+        uint32 m_sq_mask = 0;
+        uint32 m_sq_entries = 0;
+        uint32* m_cq_head = nullptr;
+        uint32* m_cq_tail = nullptr;
+        uint32 m_cq_mask = 0;
+        io_uring_cqe* m_cqes = nullptr;
+        uint32 m_unsubmitted = 0;
+        bool m_buffers_registered = false;
+    };
+#endif // RIFT_SERIALIZER_HAS_IO_URING
+
+    // --- RiftThreadPoolIo ---
+    // Fallback backend: worker threads execute requests with blocking
+    // positional reads and writes.
+    class RiftThreadPoolIo {
+    public:
+        RiftThreadPoolIo() = default;
+        ~RiftThreadPoolIo() { Close(); }
+        RiftThreadPoolIo(const RiftThreadPoolIo&) = delete;
+        RiftThreadPoolIo& operator=(const RiftThreadPoolIo&) = delete;
+
+        bool Init(uint32 thread_count) {
+            Close();
+            m_stopping = false;
+            for (uint32 i = 0; i < std::max<uint32>(thread_count, 1); ++i) {
+                m_workers.emplace_back([this] { Work(); });
+            }
+            return true;
+        }
+
+        void Close() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopping = true;
+            }
+            m_work_ready.notify_all();
+            for (auto& worker : m_workers) worker.join();
+            m_workers.clear();
+            m_prepared.clear();
+            m_queue.clear();
+            m_completions.clear();
+        }
+
+        bool Prepare(const RiftIoRequest& request) {
+            m_prepared.push_back(request);
+            return true;
+        }
+
+        uint32 Submit(uint32 wait_for = 0) {
+            const uint32 submitted = static_cast<uint32>(m_prepared.size());
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_queue.insert(m_queue.end(), m_prepared.begin(), m_prepared.end());
+            m_prepared.clear();
+            if (submitted > 0) m_work_ready.notify_all();
+            if (wait_for > 0) {
+                m_completion_ready.wait(lock, [&] { return m_completions.size() >= wait_for; });
+            }
+            return submitted;
+        }
+
+        uint32 Reap(RiftIoCompletion* out, uint32 max) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            uint32 count = 0;
+            while (!m_completions.empty() && count < max) {
+                out[count++] = m_completions.front();
+                m_completions.pop_front();
+            }
+            return count;
+        }
+
+    private:
+        void Work() {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            for (;;) {
+                m_work_ready.wait(lock, [&] { return m_stopping || !m_queue.empty(); });
+                if (m_queue.empty()) return;
+                const RiftIoRequest request = m_queue.front();
+                m_queue.pop_front();
+                lock.unlock();
+
+                int64 result;
+                if (request.op == RiftIoOp::Read) {
+                    result = request.file->ReadAtMost(request.offset, request.buffer, request.size);
+                }
+                else {
+                    result = request.file->WriteAt(request.offset, request.buffer, request.size) ? static_cast<int64>(request.size) : -1;
+                }
+
+                lock.lock();
+                m_completions.push_back({ request.user_data, result });
+                m_completion_ready.notify_all();
+            }
+        }
+
+        std::vector<RiftIoRequest> m_prepared;
+        std::mutex m_mutex;
+        std::condition_variable m_work_ready;
+        std::condition_variable m_completion_ready;
+        std::deque<RiftIoRequest> m_queue;
+        std::deque<RiftIoCompletion> m_completions;
+        std::vector<std::thread> m_workers;
+        bool m_stopping = false;
+    };
+
+    enum class RiftAsyncIoBackend { None, IoUring, ThreadPool };
+
+    // --- RiftAsyncIo ---
+    // Backend-selecting front end. Driven from a single thread: Prepare()
+    // requests, Submit() them as one batch, then Reap() completions.
+    class RiftAsyncIo {
+    public:
+        RiftAsyncIo() = default;
+        ~RiftAsyncIo() { Close(); }
+        RiftAsyncIo(const RiftAsyncIo&) = delete;
+        RiftAsyncIo& operator=(const RiftAsyncIo&) = delete;
+
+        // Uses io_uring when available and allowed, the thread pool otherwise.
+        bool Init(uint32 queue_depth, bool allow_io_uring = true, uint32 fallback_threads = 4) {
+            Close();
+#ifdef RIFT_SERIALIZER_HAS_IO_URING
+            if (allow_io_uring && m_uring.Init(queue_depth)) {
+                m_backend = RiftAsyncIoBackend::IoUring;
+                return true;
+            }
+#else
+            (void)queue_depth;
+            (void)allow_io_uring;
+#endif
+            m_backend = m_pool.Init(fallback_threads) ? RiftAsyncIoBackend::ThreadPool : RiftAsyncIoBackend::None;
+            return m_backend != RiftAsyncIoBackend::None;
+        }
+
+        // Waits for every request in flight first (their completions are
+        // discarded), so no read lands in a caller's buffer after Close()
+        // returns and no registered buffer is still in use by the kernel.
+        void Close() {
+            RiftIoCompletion completions[64];
+            while (m_in_flight > 0) {
+                if (WaitAndReap(completions, 64) == 0) break; // The backend failed; nothing more will complete
+            }
+#ifdef RIFT_SERIALIZER_HAS_IO_URING
+            m_uring.Close();
+#endif
+            m_pool.Close();
+            m_backend = RiftAsyncIoBackend::None;
+            m_in_flight = 0;
+        }
+
+        RiftAsyncIoBackend GetBackend() const { return m_backend; }
+        uint32 GetInFlight() const { return m_in_flight; }
+
+        // Registers pool buffers with the kernel (io_uring only; a no-op otherwise).
+        bool RegisterBuffers(RiftIoBufferPool& pool) {
+#ifdef RIFT_SERIALIZER_HAS_IO_URING
+            if (m_backend == RiftAsyncIoBackend::IoUring) return m_uring.RegisterBuffers(pool);
+#endif
+            (void)pool;
+            return true;
+        }
+
+        // Queues a request; if the submission ring is full, the queued batch is
+        // submitted first to make room.
+        bool Prepare(const RiftIoRequest& request) {
+#ifdef RIFT_SERIALIZER_HAS_IO_URING
+            if (m_backend == RiftAsyncIoBackend::IoUring) {
+                if (!m_uring.Prepare(request) && (m_uring.Submit() == 0 || !m_uring.Prepare(request))) return false;
+                ++m_in_flight;
+                return true;
+            }
+#endif
+            if (m_backend != RiftAsyncIoBackend::ThreadPool) return false;
+            m_pool.Prepare(request);
+            ++m_in_flight;
+            return true;
+        }
+
+        uint32 Submit(uint32 wait_for = 0) {
+#ifdef RIFT_SERIALIZER_HAS_IO_URING
+            if (m_backend == RiftAsyncIoBackend::IoUring) return m_uring.Submit(wait_for);
+#endif
+            return m_backend == RiftAsyncIoBackend::ThreadPool ? m_pool.Submit(wait_for) : 0;
+        }
+
+        uint32 Reap(RiftIoCompletion* out, uint32 max) {
+            uint32 count = 0;
+#ifdef RIFT_SERIALIZER_HAS_IO_URING
+            if (m_backend == RiftAsyncIoBackend::IoUring) count = m_uring.Reap(out, max);
+#endif
+            if (m_backend == RiftAsyncIoBackend::ThreadPool) count = m_pool.Reap(out, max);
+            m_in_flight -= count;
+            return count;
+        }
+
+        // Submits anything queued and blocks until at least one completion is
+        // available (if any request is in flight), then reaps.
+        uint32 WaitAndReap(RiftIoCompletion* out, uint32 max) {
+            uint32 count = Reap(out, max);
+            if (count == 0 && m_in_flight > 0) {
+                Submit(1);
+                count = Reap(out, max);
+            }
+            return count;
+        }
+
+    private:
+#ifdef RIFT_SERIALIZER_HAS_IO_URING
+        RiftUringIo m_uring;
+#endif
+        RiftThreadPoolIo m_pool;
+        RiftAsyncIoBackend m_backend = RiftAsyncIoBackend::None;
+        uint32 m_in_flight = 0;
+    };
+
+} // namespace RiftSerializer
@@ -0,0 +1,168 @@
+﻿// RiftSerializer/include/RiftSerializer/BitStream.h
+//
+// Bit-packed sections for booleans, small enums and quantized values.
+//
+// A section is a run of little-endian 64-bit words, 8-byte aligned inside
+// the object and padded to a whole word. Fields are packed LSB-first. An
+// object refers to its section through an OffsetTableEntry whose size is the
+// number of bits written.
+
+#pragma once
+
+#include "../Accessor/Accessor.h"
+#include "../Builder/Builder.h"
+#include <cmath>
+
+namespace RiftSerializer {
+
+    namespace detail {
+        inline uint64 low_bits_mask(uint32 bits) {
+            return bits >= 64 ? ~uint64(0) : (uint64(1) << bits) - 1;
+        }
+
+        template<typename T>
+        inline uint32 to_bit_field(T value) {
+            if constexpr (std::is_enum_v<T>) return static_cast<uint32>(static_cast<std::underlying_type_t<T>>(value));
+            else return static_cast<uint32>(value);
+        }
+    } // namespace detail
+
+    // --- RiftBitWriter ---
+    // Appends a bit-packed section to a builder. Bits collect in a 64-bit
+    // accumulator and are written to the builder one whole word at a time.
+    class RiftBitWriter {
+    public:
+        // Starts a section at the builder's current (8-byte aligned) position.
+        explicit RiftBitWriter(RiftBufferBuilder& builder) : m_builder(builder) {
+            m_builder.PadToAlignment(sizeof(uint64));
+            m_start = static_cast<uint32>(m_builder.GetCurrentSize());
+        }
+
+        // Writes the low bits (1-32) of value.
+        void Write(uint32 value, uint32 bits) {
+            RIFT_ASSERT(bits >= 1 && bits <= 32, "Bit count must be between 1 and 32.");
+            const uint64 v = value & detail::low_bits_mask(bits);
+            m_accumulator |= v << m_pending;
+            m_pending += bits;
+            m_bit_count += bits;
+            if (m_pending >= 64) {
+                const uint64 word = to_little_endian(m_accumulator);
+                m_builder.WriteRaw(&word, sizeof(word));
+                m_pending -= 64;
+                // The bits of v that did not fit; shifting by bits - m_pending is < 64 here.
+                m_accumulator = m_pending ? v >> (bits - m_pending) : 0;
+            }
+        }
+
+        void WriteBool(bool value) { Write(value ? 1u : 0u, 1); }
+
+        // Two's complement in the given width; value must fit.
+        void WriteSigned(int32 value, uint32 bits) { Write(static_cast<uint32>(value), bits); }
+
+        // Maps value from [min, max] onto 2^bits evenly spaced steps (clamped).
+        void WriteQuantized(float value, float min, float max, uint32 bits) {
+            // In double so that 25..32-bit widths round and clamp exactly; a float
+            // cannot hold 2^32 - 1 and t * steps + 0.5f would overflow uint32.
+            const double steps = static_cast<double>(detail::low_bits_mask(bits));
+            const double t = (static_cast<double>(value) - min) / (static_cast<double>(max) - min);
+            const double clamped = t > 0.0 ? std::min(t, 1.0) : 0.0; // NaN maps to min
+            Write(static_cast<uint32>(std::min(clamped * steps + 0.5, steps)), bits);
+        }
+
+        // Compile-time width, for generated code (bool, enums, integers).
+        template<uint32 Bits, typename T>
+        void WriteField(T value) {
+            static_assert(Bits >= 1 && Bits <= 32, "Bit fields must be 1 to 32 bits wide.");
+            Write(detail::to_bit_field(value), Bits);
+        }
+
+        // Flushes the last partial word. Returns the section's offset in the
+        // builder; its length in bits is GetBitCount().
+        uint32 Finish() {
+            if (m_pending > 0) {
+                const uint64 word = to_little_endian(m_accumulator);
+                m_builder.WriteRaw(&word, sizeof(word));
+                m_accumulator = 0;
+                m_pending = 0;
+            }
+            return m_start;
+        }
+
+        uint32 GetBitCount() const { return m_bit_count; }
+
+    private:
+        RiftBufferBuilder& m_builder;
+        uint32 m_start = 0;
+        uint32 m_bit_count = 0;
+        uint32 m_pending = 0; // Bits held in the accumulator
+        uint64 m_accumulator = 0;
+    };
+
+    // --- RiftBitReader ---
+    // Reads a section in place. Each read combines the current word with the
+    // next one without branching; the next-word index is clamped to the last
+    // word, so reads never touch memory past the section. Reading past the
+    // end yields unspecified values and sets HasOverrun().
+    class RiftBitReader {
+    public:
+        // data must be 8-byte aligned and hold ceil(bit_count / 64) words.
+        RiftBitReader(const void* data, uint32 bit_count)
+            : m_words(bit_count ? static_cast<const uint64*>(data) : &s_empty_word),
+            m_last_word(bit_count ? (bit_count - 1) / 64 : 0),
+            m_bit_count(bit_count) {
+            RIFT_ASSERT(is_aligned(m_words, sizeof(uint64)), "Bit section is not 8-byte aligned.");
+        }
+
+        // Section referenced by an OffsetTableEntry of the viewed object.
+        RiftBitReader(const RiftBufferViewBase& view, const OffsetTableEntry& entry)
+            : RiftBitReader(entry.size ? view.GetPtrAtOffset(from_little_endian(entry.offset), (from_little_endian(entry.size) + 63) / 64 * 8) : nullptr,
+                from_little_endian(entry.size)) {
+        }
+
+        // Reads bits (1-32) bits.
+        uint32 Read(uint32 bits) {
+            RIFT_ASSERT(bits >= 1 && bits <= 32, "Bit count must be between 1 and 32.");
+            const uint64 index = std::min<uint64>(m_position >> 6, m_last_word);
+            const uint64 next = std::min<uint64>(index + 1, m_last_word);
+            const uint32 shift = static_cast<uint32>(m_position & 63);
+            const uint64 low = from_little_endian(m_words[index]) >> shift;
+            // (x << 1) << (63 - shift) is x << (64 - shift), and 0 when shift is 0.
+            const uint64 high = (from_little_endian(m_words[next]) << 1) << (63 - shift);
+            m_position += bits;
+            return static_cast<uint32>((low | high) & detail::low_bits_mask(bits));
+        }
+
+        bool ReadBool() { return Read(1) != 0; }
+
+        int32 ReadSigned(uint32 bits) {
+            const uint32 shift = 32 - bits;
+            return static_cast<int32>(Read(bits) << shift) >> shift;
+        }
+
+        float ReadQuantized(float min, float max, uint32 bits) {
+            const double steps = static_cast<double>(detail::low_bits_mask(bits));
+            return static_cast<float>(min + (static_cast<double>(max) - min) * (static_cast<double>(Read(bits)) / steps));
+        }
+
+        template<uint32 Bits, typename T>
+        T ReadField() {
+            static_assert(Bits >= 1 && Bits <= 32, "Bit fields must be 1 to 32 bits wide.");
+            if constexpr (std::is_same_v<T, bool>) return Read(Bits) != 0;
+            else if constexpr (std::is_signed_v<T>) return static_cast<T>(ReadSigned(Bits));
+            else return static_cast<T>(Read(Bits));
+        }
+
+        uint32 GetPosition() const { return static_cast<uint32>(m_position); }
+        uint32 GetBitCount() const { return m_bit_count; }
+        bool HasOverrun() const { return m_position > m_bit_count; }
+
+    private:
+        static inline const uint64 s_empty_word = 0;
+
+        const uint64* m_words;
+        uint64 m_last_word;
+        uint32 m_bit_count;
+        uint64 m_position = 0;
+    };
+
+} // namespace RiftSerializer
@@ -7,43 +7,87 @@
 #include <vector>
 #include <string>
 
+// Define RIFT_SERIALIZER_BUILDER_STATS to have every builder count its
+// reallocations, padding and objects and report them per root schema to
+// RiftBuilderStatsRegistry (see BuilderStats.h). Without it the hooks compile
+// to nothing.
+#ifdef RIFT_SERIALIZER_BUILDER_STATS
+#include "../Stats/BuilderStats.h"
+#define RIFT_BUILDER_STAT(...) __VA_ARGS__
+#else
+#define RIFT_BUILDER_STAT(...)
+#endif
+
 namespace RiftSerializer {
 
     class RiftBufferBuilder {
     public:
         explicit RiftBufferBuilder(size_t initial_capacity = 1024) {
             m_buffer.reserve(initial_capacity);
+            RIFT_BUILDER_STAT(m_stats.counters.peak_capacity = m_buffer.capacity();)
         }
 
-        const uint8* GetBufferPointer() const { return m_buffer.data(); }
-        size_t GetCurrentSize() const { return m_buffer.size(); }
-        void Reset() { m_buffer.clear(); }
+        // Contiguous built bytes. Not available while external blobs are held
+        // (aborts in every build); use GetIoSlices() or Flatten() instead.
+        const uint8* GetBufferPointer() const {
+            RIFT_CHECK(m_blobs.empty(), "Builder holds external blobs; use GetIoSlices() or Flatten().");
+            return m_buffer.data();
+        }
+        // Size of the built stream, external blobs included. All offsets
+        // returned by the builder are positions in this stream.
+        size_t GetCurrentSize() const { return m_buffer.size() + m_blob_bytes; }
+        // Ends the current buffer; with builder stats enabled, its counters are reported here.
+        void Reset() {
+            RIFT_BUILDER_STAT(m_stats.Flush(); m_stats.counters.peak_capacity = m_buffer.capacity();)
+            m_buffer.clear();
+            m_blobs.clear();
+            m_blob_bytes = 0;
+        }
+
+        // Discards everything written after new_size, e.g. to roll back a partially built object.
+        void Truncate(size_t new_size) {
+            RIFT_ASSERT(new_size <= GetCurrentSize(), "Truncate cannot grow the buffer.");
+            while (!m_blobs.empty() && m_blobs.back().offset >= new_size) {
+                m_blob_bytes -= m_blobs.back().size;
+                m_blobs.pop_back();
+            }
+            RIFT_ASSERT(m_blobs.empty() || m_blobs.back().offset + m_blobs.back().size <= new_size, "Truncate cannot split an external blob.");
+            m_buffer.resize(ToBufferOffset(new_size));
+        }
 
         void WriteRaw(const void* data, size_t size) {
             if (!data || size == 0) return;
             const auto* bytes = static_cast<const uint8*>(data);
+            RIFT_BUILDER_STAT(const size_t old_capacity = m_buffer.capacity();)
             m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+            RIFT_BUILDER_STAT(CountGrowth(old_capacity, m_buffer.size() - size);)
         }
 
         void WriteAt(size_t offset, const void* data, size_t size) {
-            RIFT_ASSERT(offset + size <= m_buffer.size(), "WriteAt would write out of bounds.");
+            RIFT_ASSERT(offset + size <= GetCurrentSize(), "WriteAt would write out of bounds.");
             if (data && size > 0) {
-                std::memcpy(m_buffer.data() + offset, data, size);
+                const size_t buffer_offset = ToBufferOffset(offset);
+                RIFT_ASSERT(ToBufferOffset(offset + size - 1) == buffer_offset + size - 1, "WriteAt cannot write into an external blob.");
+                std::memcpy(m_buffer.data() + buffer_offset, data, size);
             }
         }
 
         size_t Reserve(size_t size) {
             PadToAlignment(8);
-            size_t offset = m_buffer.size();
-            m_buffer.resize(offset + size);
+            size_t offset = GetCurrentSize();
+            RIFT_BUILDER_STAT(const size_t old_capacity = m_buffer.capacity();)
+            m_buffer.resize(m_buffer.size() + size);
+            RIFT_BUILDER_STAT(CountGrowth(old_capacity, m_buffer.size() - size); m_stats.counters.reserve_fill_bytes += size;)
             return offset;
         }
 
         void PadToAlignment(size_t alignment) {
-            size_t current_size = m_buffer.size();
+            size_t current_size = GetCurrentSize();
             size_t padding = (alignment - (current_size % alignment)) % alignment;
             if (padding > 0) {
-                m_buffer.resize(current_size + padding, 0);
+                RIFT_BUILDER_STAT(const size_t old_capacity = m_buffer.capacity();)
+                m_buffer.resize(m_buffer.size() + padding, 0);
+                RIFT_BUILDER_STAT(CountGrowth(old_capacity, m_buffer.size() - padding); m_stats.counters.padding_bytes += padding;)
             }
         }
 
@@ -53,13 +97,17 @@ namespace RiftSerializer {
         }
 
         void EndObject(size_t object_start_offset, uint32 schema_id) {
-            RIFT_ASSERT(is_aligned(m_buffer.data() + object_start_offset, alignof(RiftObjectHeader)), "Object start is not aligned.");
-            auto* header = reinterpret_cast<RiftObjectHeader*>(m_buffer.data() + object_start_offset);
-
-            header->magic = to_little_endian(RIFT_MAGIC_NUMBER);
-            header->schema_id = to_little_endian(schema_id);
-            header->total_size = to_little_endian(static_cast<uint32>(GetCurrentSize() - object_start_offset));
-            header->version_flags = to_little_endian(static_cast<uint32>(0)); // Reserved for future use
+            RIFT_ASSERT(object_start_offset % alignof(RiftObjectHeader) == 0, "Object start is not aligned.");
+            RiftObjectHeader header;
+            header.magic = to_little_endian(RIFT_MAGIC_NUMBER);
+            header.schema_id = to_little_endian(schema_id);
+            header.total_size = to_little_endian(static_cast<uint32>(GetCurrentSize() - object_start_offset));
+            header.version_flags = to_little_endian(static_cast<uint32>(0)); // Reserved for future use
+            WriteAt(object_start_offset, &header, sizeof(header));
+            RIFT_BUILDER_STAT(
+                m_stats.counters.objects += 1;
+                m_stats.counters.built_bytes = GetCurrentSize();
+                m_stats.counters.last_schema_id = schema_id;)
         }
 
         template <typename T>
@@ -73,14 +121,119 @@ namespace RiftSerializer {
             return start_offset;
         }
 
+        // Like AddArray, but records a reference to the caller's memory instead
+        // of copying it. The array must stay alive and unchanged until the
+        // output has been consumed through GetIoSlices() or Flatten(). The
+        // built stream is byte-identical to the one AddArray would produce.
+        template <typename T>
+        uint32_t AddArrayRef(const T* data, size_t count) {
+            if (count == 0) return 0;
+            static_assert(is_rift_fixed_size<T>::value, "AddArrayRef requires fixed-size types.");
+
+            PadToAlignment(alignof(T));
+            return AddBlobRef(data, count * sizeof(T));
+        }
+
+        template <typename T>
+        uint32_t AddArrayRef(const std::vector<T>& arr) {
+            return AddArrayRef(arr.data(), arr.size());
+        }
+
+        // Records size bytes at data as the next part of the stream without copying them.
+        uint32_t AddBlobRef(const void* data, size_t size) {
+            if (!data || size == 0) return 0;
+            uint32_t start_offset = static_cast<uint32>(GetCurrentSize());
+            m_blobs.push_back({ start_offset, m_buffer.size(), static_cast<const uint8*>(data), size });
+            m_blob_bytes += size;
+            return start_offset;
+        }
+
+        bool HasExternalBlobs() const { return !m_blobs.empty(); }
+
+        // Appends the built stream to out as a gather list: builder-owned
+        // bytes and external blobs, in stream order. Suitable for writev or
+        // sendmsg; slices stay valid until the builder is next modified.
+        void GetIoSlices(std::vector<RiftIoSlice>& out) const {
+            ForEachIoSlice([&](const RiftIoSlice& slice) { out.push_back(slice); });
+        }
+
+        // Same, calling visitor(const RiftIoSlice&) for each slice without allocating.
+        template<typename Visitor>
+        void ForEachIoSlice(Visitor&& visitor) const {
+            size_t buffer_offset = 0;
+            for (const ExternalBlob& blob : m_blobs) {
+                if (blob.buffer_offset > buffer_offset) {
+                    visitor(RiftIoSlice{ m_buffer.data() + buffer_offset, blob.buffer_offset - buffer_offset });
+                }
+                visitor(RiftIoSlice{ blob.data, blob.size });
+                buffer_offset = blob.buffer_offset;
+            }
+            if (m_buffer.size() > buffer_offset) {
+                visitor(RiftIoSlice{ m_buffer.data() + buffer_offset, m_buffer.size() - buffer_offset });
+            }
+        }
+
+        // Copies the built stream into dest, which must hold GetCurrentSize() bytes.
+        void Flatten(void* dest) const {
+            auto* out = static_cast<uint8*>(dest);
+            size_t buffer_offset = 0;
+            for (const ExternalBlob& blob : m_blobs) {
+                std::memcpy(out, m_buffer.data() + buffer_offset, blob.buffer_offset - buffer_offset);
+                out += blob.buffer_offset - buffer_offset;
+                std::memcpy(out, blob.data, blob.size);
+                out += blob.size;
+                buffer_offset = blob.buffer_offset;
+            }
+            if (m_buffer.size() > buffer_offset) {
+                std::memcpy(out, m_buffer.data() + buffer_offset, m_buffer.size() - buffer_offset);
+            }
+        }
+
         uint32_t AddString(const std::string& str) {
             if (str.empty()) return 0;
             uint32_t start_offset = static_cast<uint32>(GetCurrentSize());
             WriteRaw(str.data(), str.length() + 1); // Write string data AND null terminator
             return start_offset;
         }
+#ifdef RIFT_SERIALIZER_BUILDER_STATS
+        // Counters of the buffer currently being built.
+        const RiftBuilderCounters& GetStatsCounters() const { return m_stats.counters; }
+#endif
+
     private:
+        struct ExternalBlob {
+            size_t offset;        // Position in the built stream
+            size_t buffer_offset; // Position in m_buffer the blob is spliced in at
+            const uint8* data;
+            size_t size;
+        };
+
+        // Maps a stream offset to the corresponding offset in m_buffer.
+        size_t ToBufferOffset(size_t offset) const {
+            if (m_blobs.empty()) return offset;
+            auto it = std::upper_bound(m_blobs.begin(), m_blobs.end(), offset,
+                [](size_t o, const ExternalBlob& blob) { return o < blob.offset; });
+            if (it == m_blobs.begin()) return offset;
+            --it;
+            RIFT_ASSERT(offset >= it->offset + it->size, "Offset lies inside an external blob.");
+            return it->buffer_offset + (offset - it->offset - it->size);
+        }
+
+#ifdef RIFT_SERIALIZER_BUILDER_STATS
+        void CountGrowth(size_t old_capacity, size_t old_size) {
+            if (m_buffer.capacity() == old_capacity) return;
+            m_stats.counters.reallocations += 1;
+            m_stats.counters.growth_bytes_copied += old_size;
+            m_stats.counters.peak_capacity = std::max<uint64>(m_stats.counters.peak_capacity, m_buffer.capacity());
+        }
+#endif
+
         std::vector<uint8> m_buffer;
+        std::vector<ExternalBlob> m_blobs; // Sorted by offset
+        size_t m_blob_bytes = 0;
+#ifdef RIFT_SERIALIZER_BUILDER_STATS
+        detail::builder_stats_scope m_stats;
+#endif
     };
 
 } // namespace RiftSerializer
\ No newline at end of file
@@ -0,0 +1,113 @@
+﻿// RiftSerializer/include/RiftSerializer/SpanBuilder.h
+//
+// A builder over caller-provided memory (a ring slot, a shared-memory region,
+// a stack buffer). Same building interface as RiftBufferBuilder, but it never
+// allocates: once the span is full, further writes are dropped and
+// HasOverflowed() reports it.
+
+#pragma once
+
+#include "../Accessor/Accessor.h"
+#include <vector>
+#include <string>
+
+namespace RiftSerializer {
+
+    class RiftSpanBuilder {
+    public:
+        RiftSpanBuilder() = default;
+        // data must be 8-byte aligned so that objects can be viewed in place.
+        RiftSpanBuilder(void* data, size_t capacity) { Attach(data, capacity); }
+
+        void Attach(void* data, size_t capacity) {
+            RIFT_ASSERT(is_aligned(data, alignof(RiftObjectHeader)), "Span is not aligned for RiftObjectHeader.");
+            m_data = static_cast<uint8*>(data);
+            m_capacity = capacity;
+            Reset();
+        }
+
+        const uint8* GetBufferPointer() const { return m_data; }
+        // Size of the content built so far. May exceed GetCapacity() after an overflow.
+        size_t GetCurrentSize() const { return m_size; }
+        size_t GetCapacity() const { return m_capacity; }
+        bool HasOverflowed() const { return m_size > m_capacity; }
+        void Reset() { m_size = 0; }
+
+        void Truncate(size_t new_size) {
+            RIFT_ASSERT(new_size <= m_size, "Truncate cannot grow the buffer.");
+            m_size = new_size;
+        }
+
+        void WriteRaw(const void* data, size_t size) {
+            if (!data || size == 0) return;
+            if (m_size + size <= m_capacity) {
+                std::memcpy(m_data + m_size, data, size);
+            }
+            m_size += size;
+        }
+
+        void WriteAt(size_t offset, const void* data, size_t size) {
+            RIFT_ASSERT(offset + size <= m_size, "WriteAt would write out of bounds.");
+            if (data && size > 0 && offset + size <= m_capacity) {
+                std::memcpy(m_data + offset, data, size);
+            }
+        }
+
+        size_t Reserve(size_t size) {
+            PadToAlignment(8);
+            size_t offset = m_size;
+            if (offset + size <= m_capacity) {
+                std::memset(m_data + offset, 0, size);
+            }
+            m_size += size;
+            return offset;
+        }
+
+        void PadToAlignment(size_t alignment) {
+            const size_t padded = align_up(m_size, alignment);
+            if (padded <= m_capacity) {
+                std::memset(m_data + m_size, 0, padded - m_size);
+            }
+            m_size = padded;
+        }
+
+        size_t BeginObject() {
+            PadToAlignment(alignof(RiftObjectHeader));
+            return m_size;
+        }
+
+        void EndObject(size_t object_start_offset, uint32 schema_id) {
+            RIFT_ASSERT(object_start_offset % alignof(RiftObjectHeader) == 0, "Object start is not aligned.");
+            RiftObjectHeader header;
+            header.magic = to_little_endian(RIFT_MAGIC_NUMBER);
+            header.schema_id = to_little_endian(schema_id);
+            header.total_size = to_little_endian(static_cast<uint32>(m_size - object_start_offset));
+            header.version_flags = to_little_endian(static_cast<uint32>(0)); // Reserved for future use
+            WriteAt(object_start_offset, &header, sizeof(header));
+        }
+
+        template <typename T>
+        uint32_t AddArray(const std::vector<T>& arr) {
+            if (arr.empty()) return 0;
+            static_assert(is_rift_fixed_size<T>::value, "AddArray requires fixed-size types.");
+
+            PadToAlignment(alignof(T));
+            uint32_t start_offset = static_cast<uint32>(m_size);
+            WriteRaw(arr.data(), arr.size() * sizeof(T));
+            return start_offset;
+        }
+
+        uint32_t AddString(const std::string& str) {
+            if (str.empty()) return 0;
+            uint32_t start_offset = static_cast<uint32>(m_size);
+            WriteRaw(str.data(), str.length() + 1); // Write string data AND null terminator
+            return start_offset;
+        }
+
+    private:
+        uint8* m_data = nullptr;
+        size_t m_capacity = 0;
+        size_t m_size = 0;
+    };
+
+} // namespace RiftSerializer
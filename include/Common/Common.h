@@ -6,9 +6,12 @@
 #include <type_traits>
 #include <algorithm>
 #include <cstdlib>
+#include <cstdio>
+#include <atomic>
 
-#define SPDLOG_HEADER_ONLY
-#include <spdlog/spdlog.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 // --- Fixed-Width Integer Aliases ---
 namespace RiftSerializer {
@@ -57,6 +60,37 @@ namespace RiftSerializer {
 #endif
         }
 
+        // Index of the lowest set bit. The argument must be non-zero.
+        inline uint32_t count_trailing_zeros(uint32_t v) {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward(&index, v);
+            return static_cast<uint32_t>(index);
+#else
+            return static_cast<uint32_t>(__builtin_ctz(v));
+#endif
+        }
+        inline uint32_t count_trailing_zeros(uint64_t v) {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward64(&index, v);
+            return static_cast<uint32_t>(index);
+#else
+            return static_cast<uint32_t>(__builtin_ctzll(v));
+#endif
+        }
+
+        // Number of zero bits above the highest set bit. The argument must be non-zero.
+        inline uint32_t count_leading_zeros(uint64_t v) {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanReverse64(&index, v);
+            return 63 - static_cast<uint32_t>(index);
+#else
+            return static_cast<uint32_t>(__builtin_clzll(v));
+#endif
+        }
+
         template<typename T>
         inline T to_little_endian(T value) {
 #ifdef RIFT_SERIALIZER_HOST_BIG_ENDIAN
@@ -79,6 +113,9 @@ namespace RiftSerializer {
 
 // --- Alignment Utilities ---
 namespace RiftSerializer {
+    // Used to keep atomics written by different threads on separate cache lines.
+    constexpr size_t RIFT_CACHE_LINE_SIZE = 64;
+
     inline size_t align_up(size_t offset, size_t alignment) {
         return (offset + alignment - 1) & ~(alignment - 1);
     }
@@ -87,15 +124,121 @@ namespace RiftSerializer {
     }
 }
 
+// --- Gather I/O ---
+namespace RiftSerializer {
+    // One contiguous piece of a gather list. Layout-compatible with POSIX iovec.
+    struct RiftIoSlice {
+        const void* data;
+        size_t size;
+    };
+
+    // One datagram described as a gather list.
+    struct RiftDatagram {
+        const RiftIoSlice* slices;
+        uint32 slice_count;
+        uint32 size;
+    };
+}
+
+// --- Diagnostics ---
+// Assert failures and other library reports go through a single handler that
+// the application can replace (see SpdlogDiagnostics.h for an spdlog
+// adapter). The default handler writes to stderr. Reporting functions are
+// out of line and marked cold, so a check in a hot inlined accessor costs
+// only the compare and a call on the failure path.
+#if defined(_MSC_VER)
+#define RIFT_NOINLINE __declspec(noinline)
+#define RIFT_COLD
+#else
+#define RIFT_NOINLINE __attribute__((noinline))
+#define RIFT_COLD __attribute__((cold))
+#endif
+
+// Reports below this level compile to nothing (0 = Trace ... 6 = Off).
+#ifndef RIFT_DIAGNOSTIC_LEVEL
+#ifdef RIFT_SERIALIZER_DEBUG
+#define RIFT_DIAGNOSTIC_LEVEL 1
+#else
+#define RIFT_DIAGNOSTIC_LEVEL 3
+#endif
+#endif
+
+namespace RiftSerializer {
+    enum class RiftDiagnosticLevel : uint8 {
+        Trace = 0,
+        Debug,
+        Info,
+        Warning,
+        Error,
+        Critical,
+        Off,
+    };
+
+    // Called for every report that passes RIFT_DIAGNOSTIC_LEVEL, from any
+    // thread. For assert failures (Critical) the process aborts afterwards.
+    using RiftDiagnosticHandler = void (*)(RiftDiagnosticLevel level, const char* message, const char* file, int line);
+
+    inline const char* rift_diagnostic_level_name(RiftDiagnosticLevel level) {
+        static const char* const names[] = { "trace", "debug", "info", "warning", "error", "critical", "off" };
+        return names[static_cast<uint8>(level) < 7 ? static_cast<uint8>(level) : 6];
+    }
+
+    inline void rift_default_diagnostic_handler(RiftDiagnosticLevel level, const char* message, const char* file, int line) {
+        std::fprintf(stderr, "[RiftSerializer] [%s] %s (%s:%d)\n", rift_diagnostic_level_name(level), message, file, line);
+        std::fflush(stderr);
+    }
+
+    namespace detail {
+        inline std::atomic<RiftDiagnosticHandler>& diagnostic_handler() {
+            static std::atomic<RiftDiagnosticHandler> handler{ &rift_default_diagnostic_handler };
+            return handler;
+        }
+
+        RIFT_NOINLINE RIFT_COLD inline void report_diagnostic(RiftDiagnosticLevel level, const char* message, const char* file, int line) {
+            diagnostic_handler().load(std::memory_order_acquire)(level, message, file, line);
+        }
+
+        [[noreturn]] RIFT_NOINLINE RIFT_COLD inline void assert_failed(const char* condition, const char* message, const char* file, int line) {
+            char text[512];
+            std::snprintf(text, sizeof(text), "ASSERT FAILED: %s [%s]", message, condition);
+            report_diagnostic(RiftDiagnosticLevel::Critical, text, file, line);
+            std::abort();
+        }
+    }
+
+    // Installs a handler (nullptr restores the default). Thread-safe.
+    inline void rift_set_diagnostic_handler(RiftDiagnosticHandler handler) {
+        detail::diagnostic_handler().store(handler ? handler : &rift_default_diagnostic_handler, std::memory_order_release);
+    }
+}
+
+// Reports a message at a RiftDiagnosticLevel. Compiled out below RIFT_DIAGNOSTIC_LEVEL.
+#define RIFT_DIAGNOSTIC(level, message) \
+        do { \
+            if constexpr (static_cast<int>(level) >= RIFT_DIAGNOSTIC_LEVEL) { \
+                ::RiftSerializer::detail::report_diagnostic(level, message, __FILE__, __LINE__); \
+            } \
+        } while (0)
+
 // --- Assertion Macro ---
 #ifdef RIFT_SERIALIZER_DEBUG
 #define RIFT_ASSERT(condition, message) \
         do { \
-            if (!(condition)) { \
-                spdlog::critical("ASSERT FAILED: {} ({}:{})", message, __FILE__, __LINE__); \
-                std::abort(); \
+            if (!(condition)) [[unlikely]] { \
+                ::RiftSerializer::detail::assert_failed(#condition, message, __FILE__, __LINE__); \
             } \
         } while (0)
 #else
-#define RIFT_ASSERT(condition, message)
-#endif
\ No newline at end of file
+// The condition is not evaluated, only kept referenced so release builds do
+// not warn about values that exist just to be checked.
+#define RIFT_ASSERT(condition, message) do { (void)sizeof(condition); } while (0)
+#endif
+
+// Like RIFT_ASSERT, but checked in every build. For API misuse that would
+// otherwise read or write out of bounds in release.
+#define RIFT_CHECK(condition, message) \
+        do { \
+            if (!(condition)) [[unlikely]] { \
+                ::RiftSerializer::detail::assert_failed(#condition, message, __FILE__, __LINE__); \
+            } \
+        } while (0)
@@ -0,0 +1,40 @@
+﻿// RiftSerializer/include/RiftSerializer/SpdlogDiagnostics.h
+//
+// Optional adapter that routes RiftSerializer diagnostics (RIFT_ASSERT
+// failures, RIFT_DIAGNOSTIC reports) to spdlog's default logger. Common.h
+// does not depend on spdlog; include this header only where spdlog is
+// available and call rift_install_spdlog_diagnostics() once at startup.
+
+#pragma once
+
+#include "Common.h"
+
+#if !defined(SPDLOG_HEADER_ONLY) && !defined(SPDLOG_COMPILED_LIB)
+#define SPDLOG_HEADER_ONLY
+#endif
+#include <spdlog/spdlog.h>
+
+namespace RiftSerializer {
+
+    inline spdlog::level::level_enum rift_to_spdlog_level(RiftDiagnosticLevel level) {
+        switch (level) {
+        case RiftDiagnosticLevel::Trace: return spdlog::level::trace;
+        case RiftDiagnosticLevel::Debug: return spdlog::level::debug;
+        case RiftDiagnosticLevel::Info: return spdlog::level::info;
+        case RiftDiagnosticLevel::Warning: return spdlog::level::warn;
+        case RiftDiagnosticLevel::Error: return spdlog::level::err;
+        case RiftDiagnosticLevel::Critical: return spdlog::level::critical;
+        default: return spdlog::level::off;
+        }
+    }
+
+    inline void rift_spdlog_diagnostic_handler(RiftDiagnosticLevel level, const char* message, const char* file, int line) {
+        spdlog::default_logger_raw()->log(spdlog::source_loc{ file, line, "" }, rift_to_spdlog_level(level), message);
+        if (level == RiftDiagnosticLevel::Critical) spdlog::default_logger_raw()->flush(); // An assert aborts next
+    }
+
+    inline void rift_install_spdlog_diagnostics() {
+        rift_set_diagnostic_handler(&rift_spdlog_diagnostic_handler);
+    }
+
+} // namespace RiftSerializer
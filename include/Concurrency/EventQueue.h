@@ -0,0 +1,243 @@
+﻿// RiftSerializer/include/RiftSerializer/EventQueue.h
+//
+// Multi-producer / single-consumer queue for high-rate debug and telemetry
+// objects (DebugEvent, DebugLine, DebugSphere, ...) emitted from many threads.
+//
+// Each producer thread owns a RiftEventProducer and builds objects in place
+// into a private chunk, so emitting an event touches no shared cache line.
+// Full chunks (or partial ones on Flush()) are pushed onto a lock-free list;
+// the consumer takes the whole list with one exchange, visits every object in
+// place and hands each chunk back to the producer that filled it.
+//
+// Objects from one producer are delivered in emission order. Chunks from
+// different producers are delivered in the order they were published.
+
+#pragma once
+
+#include "../Builder/SpanBuilder.h"
+#include "../Memory/AlignedBuffer.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace RiftSerializer {
+
+    struct RiftEventQueueConfig {
+        size_t chunk_size = 64u << 10;         // Bytes per chunk; bounds the largest event
+        uint32 max_chunks_per_producer = 16;   // Events are dropped once all are in flight
+    };
+
+    class RiftEventProducer;
+
+    // --- RiftEventQueue ---
+    // All chunk memory is owned by the queue, so producers may come and go
+    // while the consumer still holds their chunks. Producers must be
+    // destroyed before the queue.
+    class RiftEventQueue {
+    public:
+        explicit RiftEventQueue(const RiftEventQueueConfig& config = RiftEventQueueConfig()) : m_config(config) {
+            m_config.chunk_size = align_up(std::max<size_t>(m_config.chunk_size, 256), RIFT_CACHE_LINE_SIZE);
+            m_config.max_chunks_per_producer = std::max<uint32>(m_config.max_chunks_per_producer, 2);
+        }
+        RiftEventQueue(const RiftEventQueue&) = delete;
+        RiftEventQueue& operator=(const RiftEventQueue&) = delete;
+
+        const RiftEventQueueConfig& GetConfig() const { return m_config; }
+
+        // --- Consumer ---
+
+        // Calls on_event(const RiftBufferViewBase&) for every published
+        // object and returns the number visited. Views are valid only during
+        // the callback.
+        template<typename Callback>
+        uint64 Drain(Callback&& on_event) {
+            // The list is newest-first; reverse it into publication order.
+            Chunk* chunk = m_published.exchange(nullptr, std::memory_order_acquire);
+            Chunk* ordered = nullptr;
+            while (chunk) {
+                Chunk* next = chunk->next;
+                chunk->next = ordered;
+                ordered = chunk;
+                chunk = next;
+            }
+
+            uint64 count = 0;
+            while (ordered) {
+                Chunk* next = ordered->next;
+                const uint8* data = ordered->data.GetData();
+                for (size_t offset = 0; offset < ordered->size;) {
+                    const RiftBufferViewBase view(data + offset);
+                    on_event(view);
+                    offset += align_up(view.GetTotalSize(), alignof(RiftObjectHeader));
+                    ++count;
+                }
+                Recycle(ordered);
+                ordered = next;
+            }
+            return count;
+        }
+
+        bool HasPublished() const { return m_published.load(std::memory_order_relaxed) != nullptr; }
+
+    private:
+        friend class RiftEventProducer;
+        struct Slot;
+
+        struct Chunk {
+            Chunk* next = nullptr;
+            Slot* owner = nullptr;
+            size_t size = 0; // Bytes of complete events
+            RiftAlignedBuffer data;
+        };
+
+        // Per-producer state. The consumer only touches 'returned', which
+        // sits on its own cache line.
+        struct Slot {
+            alignas(RIFT_CACHE_LINE_SIZE) std::atomic<Chunk*> returned{ nullptr };
+            alignas(RIFT_CACHE_LINE_SIZE) Chunk* free = nullptr;
+            uint32 allocated = 0;
+            bool attached = false;
+        };
+
+        Slot* Attach() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const auto& slot : m_slots) {
+                if (!slot->attached) {
+                    slot->attached = true;
+                    return slot.get();
+                }
+            }
+            m_slots.push_back(std::make_unique<Slot>());
+            m_slots.back()->attached = true;
+            return m_slots.back().get();
+        }
+
+        void Detach(Slot* slot) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            slot->attached = false;
+        }
+
+        // Producer slow path: a recycled chunk, a new one, or nullptr.
+        Chunk* Acquire(Slot* slot) {
+            if (!slot->free) slot->free = slot->returned.exchange(nullptr, std::memory_order_acquire);
+            if (Chunk* chunk = slot->free) {
+                slot->free = chunk->next;
+                chunk->next = nullptr;
+                chunk->size = 0;
+                return chunk;
+            }
+            if (slot->allocated >= m_config.max_chunks_per_producer) return nullptr;
+
+            auto chunk = std::make_unique<Chunk>();
+            chunk->owner = slot;
+            chunk->data.Allocate(m_config.chunk_size, RIFT_CACHE_LINE_SIZE);
+            ++slot->allocated;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_chunks.push_back(std::move(chunk));
+            return m_chunks.back().get();
+        }
+
+        void Publish(Chunk* chunk) {
+            Chunk* head = m_published.load(std::memory_order_relaxed);
+            do {
+                chunk->next = head;
+            } while (!m_published.compare_exchange_weak(head, chunk, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        void Recycle(Chunk* chunk) {
+            std::atomic<Chunk*>& returned = chunk->owner->returned;
+            Chunk* head = returned.load(std::memory_order_relaxed);
+            do {
+                chunk->next = head;
+            } while (!returned.compare_exchange_weak(head, chunk, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        RiftEventQueueConfig m_config;
+        alignas(RIFT_CACHE_LINE_SIZE) std::atomic<Chunk*> m_published{ nullptr };
+        alignas(RIFT_CACHE_LINE_SIZE) std::mutex m_mutex; // Slow path only
+        std::vector<std::unique_ptr<Slot>> m_slots;
+        std::vector<std::unique_ptr<Chunk>> m_chunks;
+    };
+
+    // --- RiftEventProducer ---
+    // One per producing thread (typically thread_local or owned by a worker).
+    // Not thread-safe itself.
+    class RiftEventProducer {
+    public:
+        explicit RiftEventProducer(RiftEventQueue& queue) : m_queue(queue), m_slot(queue.Attach()) {}
+        ~RiftEventProducer() {
+            Flush();
+            if (m_chunk) Release(m_chunk);
+            m_queue.Detach(m_slot);
+        }
+        RiftEventProducer(const RiftEventProducer&) = delete;
+        RiftEventProducer& operator=(const RiftEventProducer&) = delete;
+
+        // Returns a builder with room for an event of up to max_size bytes,
+        // or nullptr (the event is dropped) if every chunk of this producer
+        // is waiting for the consumer. Build one object, then call Commit().
+        RiftSpanBuilder* BeginEvent(size_t max_size) {
+            RIFT_ASSERT(max_size <= m_queue.m_config.chunk_size, "Event is larger than a chunk.");
+            if (m_chunk) m_builder.Truncate(m_chunk->size); // Discard an uncommitted event
+            if (!m_chunk || m_builder.GetCapacity() - m_chunk->size < max_size) {
+                if (m_chunk && m_chunk->size > 0) {
+                    m_queue.Publish(m_chunk);
+                    m_chunk = nullptr;
+                }
+                if (!m_chunk && !(m_chunk = m_queue.Acquire(m_slot))) {
+                    ++m_dropped;
+                    return nullptr;
+                }
+                m_builder.Attach(m_chunk->data.GetData(), m_chunk->data.GetSize());
+            }
+            return &m_builder;
+        }
+
+        // Completes the event started by BeginEvent(). It becomes visible to
+        // the consumer when its chunk is published (full, or on Flush()).
+        // Returns false (and drops the event) if it overflowed max_size.
+        bool Commit() {
+            if (m_builder.HasOverflowed() || m_builder.GetCurrentSize() < m_chunk->size + sizeof(RiftObjectHeader)) {
+                m_builder.Truncate(m_chunk->size);
+                ++m_dropped;
+                return false;
+            }
+            m_builder.PadToAlignment(alignof(RiftObjectHeader));
+            m_chunk->size = m_builder.GetCurrentSize();
+            return true;
+        }
+
+        // Copies one finished object in.
+        bool Write(const void* object) {
+            const uint32 size = RiftBufferViewBase(object).GetTotalSize();
+            RiftSpanBuilder* builder = BeginEvent(align_up(size, alignof(RiftObjectHeader)));
+            if (!builder) return false;
+            builder->WriteRaw(object, size);
+            return Commit();
+        }
+
+        // Publishes the partially filled chunk, e.g. at the end of a frame.
+        void Flush() {
+            if (m_chunk && m_chunk->size > 0) {
+                m_queue.Publish(m_chunk);
+                m_chunk = nullptr;
+            }
+        }
+
+        uint64 GetDroppedCount() const { return m_dropped; }
+
+    private:
+        void Release(RiftEventQueue::Chunk* chunk) {
+            chunk->next = m_slot->free;
+            m_slot->free = chunk;
+        }
+
+        RiftEventQueue& m_queue;
+        RiftEventQueue::Slot* m_slot;
+        RiftEventQueue::Chunk* m_chunk = nullptr;
+        RiftSpanBuilder m_builder;
+        uint64 m_dropped = 0;
+    };
+
+} // namespace RiftSerializer
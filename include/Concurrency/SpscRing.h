@@ -0,0 +1,156 @@
+﻿// RiftSerializer/include/RiftSerializer/SpscRing.h
+//
+// Lock-free single-producer / single-consumer ring of variable-size
+// RiftObjects for handoff between two threads (e.g. simulation -> network).
+//
+// The producer reserves space, builds one object in place through a
+// RiftSpanBuilder and commits it; the consumer views objects in place. Every
+// object is contiguous and 8-byte aligned: when a reservation does not fit
+// before the end of the buffer, the rest of the buffer is skipped (marked
+// with a padding header when there is room for one) and the object starts
+// at offset 0.
+
+#pragma once
+
+#include "../Builder/SpanBuilder.h"
+#include "../Memory/AlignedBuffer.h"
+#include <atomic>
+
+namespace RiftSerializer {
+
+    // Magic of the header that marks the skipped tail of the buffer ('RPAD').
+    constexpr uint32 RIFT_RING_PADDING_MAGIC = 0x44415052;
+
+    // --- RiftSpscObjectRing ---
+    class RiftSpscObjectRing {
+    public:
+        // capacity is rounded up to a power of two.
+        explicit RiftSpscObjectRing(size_t capacity = 1u << 20) {
+            size_t rounded = 4096;
+            while (rounded < capacity) rounded <<= 1;
+            m_buffer.Allocate(rounded, RIFT_CACHE_LINE_SIZE);
+            m_mask = rounded - 1;
+        }
+        RiftSpscObjectRing(const RiftSpscObjectRing&) = delete;
+        RiftSpscObjectRing& operator=(const RiftSpscObjectRing&) = delete;
+
+        size_t GetCapacity() const { return m_mask + 1; }
+
+        // --- Producer ---
+
+        // Reserves max_size contiguous bytes and returns a builder over them,
+        // or nullptr if the ring does not currently have room. Build one
+        // object, then call Commit().
+        RiftSpanBuilder* BeginWrite(size_t max_size) {
+            const size_t size = align_up(std::max(max_size, sizeof(RiftObjectHeader)), alignof(RiftObjectHeader));
+            RIFT_ASSERT(size <= GetCapacity(), "Reservation is larger than the ring.");
+            const size_t index = static_cast<size_t>(m_write) & m_mask;
+            const size_t to_end = GetCapacity() - index;
+            const size_t needed = size <= to_end ? size : to_end + size;
+            if (needed > GetCapacity() - (m_write - m_cached_read)) {
+                m_cached_read = m_read.load(std::memory_order_acquire);
+                if (needed > GetCapacity() - (m_write - m_cached_read)) return nullptr;
+            }
+            if (size > to_end) {
+                if (to_end >= sizeof(RiftObjectHeader)) {
+                    RiftObjectHeader padding{};
+                    padding.magic = to_little_endian(RIFT_RING_PADDING_MAGIC);
+                    std::memcpy(m_buffer.GetData() + index, &padding, sizeof(padding));
+                }
+                m_write += to_end;
+            }
+            m_builder.Attach(m_buffer.GetData() + (static_cast<size_t>(m_write) & m_mask), size);
+            return &m_builder;
+        }
+
+        // Completes the reservation. With publish = false the object stays
+        // invisible until the next Publish() or publishing Commit(), so a
+        // batch of objects costs one atomic store. Returns false (and drops
+        // the object) if it overflowed its reservation.
+        bool Commit(bool publish = true) {
+            const bool ok = !m_builder.HasOverflowed() && m_builder.GetCurrentSize() >= sizeof(RiftObjectHeader);
+            if (ok) m_write += align_up(m_builder.GetCurrentSize(), alignof(RiftObjectHeader));
+            if (publish) Publish();
+            return ok;
+        }
+
+        void Publish() { m_written.store(m_write, std::memory_order_release); }
+
+        // Copies one finished object in (and publishes it).
+        bool Write(const void* object) {
+            const uint32 size = RiftBufferViewBase(object).GetTotalSize();
+            RiftSpanBuilder* builder = BeginWrite(size);
+            if (!builder) return false;
+            builder->WriteRaw(object, size);
+            return Commit();
+        }
+
+        // --- Consumer ---
+
+        // Calls on_object(const RiftBufferViewBase&) for up to max_count
+        // published objects, in order, then frees them with a single store.
+        // Views are valid only during the callback.
+        template<typename Callback>
+        uint32 Consume(Callback&& on_object, uint32 max_count = UINT32_MAX) {
+            const uint64 end = m_written.load(std::memory_order_acquire);
+            uint32 count = 0;
+            while (count < max_count) {
+                const void* object = Next(end);
+                if (!object) break;
+                const RiftBufferViewBase view(object);
+                on_object(view);
+                m_consumed += align_up(view.GetTotalSize(), alignof(RiftObjectHeader));
+                ++count;
+            }
+            m_read.store(m_consumed, std::memory_order_release);
+            return count;
+        }
+
+        // The oldest published object, or nullptr. Valid until Release().
+        const void* Peek() {
+            // >=: Consume() can move m_consumed past the cached position.
+            if (m_consumed >= m_cached_written) m_cached_written = m_written.load(std::memory_order_acquire);
+            return Next(m_cached_written);
+        }
+
+        void Release() {
+            const auto* header = static_cast<const RiftObjectHeader*>(Next(m_cached_written));
+            RIFT_ASSERT(header != nullptr, "Release without a peeked object.");
+            m_consumed += align_up(from_little_endian(header->total_size), alignof(RiftObjectHeader));
+            m_read.store(m_consumed, std::memory_order_release);
+        }
+
+        bool IsEmpty() const { return m_consumed == m_written.load(std::memory_order_acquire); }
+
+    private:
+        // Skips padding and returns the object at the consumer position, if published.
+        const void* Next(uint64 end) {
+            while (m_consumed < end) {
+                const size_t index = static_cast<size_t>(m_consumed) & m_mask;
+                const size_t to_end = GetCapacity() - index;
+                const auto* header = reinterpret_cast<const RiftObjectHeader*>(m_buffer.GetData() + index);
+                if (to_end < sizeof(RiftObjectHeader) || from_little_endian(header->magic) == RIFT_RING_PADDING_MAGIC) {
+                    m_consumed += to_end;
+                    continue;
+                }
+                return header;
+            }
+            return nullptr;
+        }
+
+        RiftAlignedBuffer m_buffer;
+        size_t m_mask = 0;
+
+        // Producer side
+        alignas(RIFT_CACHE_LINE_SIZE) std::atomic<uint64> m_written{ 0 }; // Published write position
+        uint64 m_write = 0;       // Local write position (includes unpublished objects)
+        uint64 m_cached_read = 0;
+        RiftSpanBuilder m_builder;
+
+        // Consumer side
+        alignas(RIFT_CACHE_LINE_SIZE) std::atomic<uint64> m_read{ 0 }; // Released read position
+        uint64 m_consumed = 0;
+        uint64 m_cached_written = 0;
+    };
+
+} // namespace RiftSerializer
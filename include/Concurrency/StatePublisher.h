@@ -0,0 +1,241 @@
+﻿// RiftSerializer/include/RiftSerializer/StatePublisher.h
+//
+// Single-writer publication of the latest serialized state (e.g. the world
+// snapshot of the current tick) to any number of reader threads, without
+// copies and without locks.
+//
+// The writer builds the next state into a pooled RiftBufferBuilder and
+// publishes it with one atomic exchange. Readers pin the current buffer and
+// view it in place. Reclamation is epoch based: every reader announces the
+// epoch it entered in its own cache line, and a replaced buffer is only reused
+// once no reader that could still see it remains. Acquiring and releasing a
+// snapshot is a bounded sequence of atomic loads and stores (wait-free); only
+// the writer ever scans the reader slots.
+
+#pragma once
+
+#include "../Accessor/Accessor.h"
+#include "../Builder/Builder.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace RiftSerializer {
+
+    class RiftStatePublisher;
+
+    // Epoch announced by a reader that holds no snapshot.
+    constexpr uint64 RIFT_STATE_READER_IDLE = UINT64_MAX;
+
+    // One per registered reader, on its own cache line.
+    struct alignas(RIFT_CACHE_LINE_SIZE) RiftStateReaderSlot {
+        std::atomic<uint64> epoch{ RIFT_STATE_READER_IDLE }; // Epoch announced while a snapshot is pinned
+        std::atomic<bool> in_use{ false };
+    };
+
+    // --- RiftStateSnapshot ---
+    // A pinned published state. Views into it stay valid until the snapshot
+    // is destroyed; keep it short-lived so the writer can recycle buffers.
+    class RiftStateSnapshot {
+    public:
+        RiftStateSnapshot(RiftStateSnapshot&& other) noexcept
+            : m_slot(other.m_slot), m_data(other.m_data), m_size(other.m_size), m_version(other.m_version) {
+            other.m_slot = nullptr;
+        }
+        RiftStateSnapshot(const RiftStateSnapshot&) = delete;
+        RiftStateSnapshot& operator=(const RiftStateSnapshot&) = delete;
+        RiftStateSnapshot& operator=(RiftStateSnapshot&&) = delete;
+        ~RiftStateSnapshot() {
+            if (m_slot) m_slot->epoch.store(RIFT_STATE_READER_IDLE, std::memory_order_release);
+        }
+
+        // False until the writer has published at least once.
+        bool IsValid() const { return m_data != nullptr; }
+        const uint8* GetData() const { return m_data; }
+        size_t GetSize() const { return m_size; }
+        // Increases by one with every Publish().
+        uint64 GetVersion() const { return m_version; }
+
+        // The first object of the state (the state must hold at least one).
+        RiftBufferViewBase GetView() const { return RiftBufferViewBase(m_data); }
+
+    private:
+        friend class RiftStateReader;
+        RiftStateSnapshot(RiftStateReaderSlot* slot, const uint8* data, size_t size, uint64 version)
+            : m_slot(slot), m_data(data), m_size(size), m_version(version) {}
+
+        RiftStateReaderSlot* m_slot;
+        const uint8* m_data;
+        size_t m_size;
+        uint64 m_version;
+    };
+
+    // --- RiftStateReader ---
+    // A registered reader. Owned by one thread; at most one snapshot per
+    // reader may be alive at a time.
+    class RiftStateReader {
+    public:
+        RiftStateReader() = default;
+        RiftStateReader(RiftStateReader&& other) noexcept : m_publisher(other.m_publisher), m_slot(other.m_slot) {
+            other.m_publisher = nullptr;
+            other.m_slot = nullptr;
+        }
+        RiftStateReader(const RiftStateReader&) = delete;
+        RiftStateReader& operator=(const RiftStateReader&) = delete;
+        RiftStateReader& operator=(RiftStateReader&&) = delete;
+        ~RiftStateReader() {
+            if (m_slot) m_slot->in_use.store(false, std::memory_order_release);
+        }
+
+        // False if the publisher had no free reader slot.
+        bool IsValid() const { return m_slot != nullptr; }
+
+        // Pins and returns the latest published state. Wait-free.
+        RiftStateSnapshot Acquire();
+
+    private:
+        friend class RiftStatePublisher;
+        RiftStateReader(RiftStatePublisher* publisher, RiftStateReaderSlot* slot) : m_publisher(publisher), m_slot(slot) {}
+
+        RiftStatePublisher* m_publisher = nullptr;
+        RiftStateReaderSlot* m_slot = nullptr;
+    };
+
+    // --- RiftStatePublisher ---
+    class RiftStatePublisher {
+    public:
+        // max_buffers bounds memory: BeginWrite() fails while that many
+        // buffers are current or still pinned by readers.
+        explicit RiftStatePublisher(uint32 max_readers = 16, uint32 max_buffers = 8, size_t initial_capacity = 64u << 10)
+            : m_slots(std::make_unique<RiftStateReaderSlot[]>(max_readers)), m_max_readers(max_readers),
+            m_max_buffers(std::max<uint32>(max_buffers, 2)), m_initial_capacity(initial_capacity) {}
+
+        RiftStatePublisher(const RiftStatePublisher&) = delete;
+        RiftStatePublisher& operator=(const RiftStatePublisher&) = delete;
+
+        // Thread-safe. Readers must be destroyed before the publisher.
+        RiftStateReader CreateReader() {
+            for (uint32 i = 0; i < m_max_readers; ++i) {
+                bool expected = false;
+                if (m_slots[i].in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                    return RiftStateReader(this, &m_slots[i]);
+                }
+            }
+            return RiftStateReader();
+        }
+
+        // --- Writer (single thread) ---
+
+        // Returns an empty builder for the next state, or nullptr if every
+        // buffer is still pinned. Build the state, then call Publish().
+        RiftBufferBuilder* BeginWrite() {
+            RIFT_ASSERT(m_writing == nullptr, "BeginWrite called twice without Publish.");
+            if (m_free.empty()) Reclaim();
+            if (m_free.empty()) {
+                if (m_buffers.size() >= m_max_buffers) return nullptr;
+                m_buffers.push_back(std::make_unique<Buffer>(m_initial_capacity));
+                m_free.push_back(m_buffers.back().get());
+            }
+            m_writing = m_free.back();
+            m_free.pop_back();
+            m_writing->builder.Reset();
+            return &m_writing->builder;
+        }
+
+        // Makes the state built since BeginWrite() the current one.
+        void Publish() {
+            RIFT_ASSERT(m_writing != nullptr, "Publish without BeginWrite.");
+            Buffer* buffer = m_writing;
+            m_writing = nullptr;
+            buffer->size = buffer->builder.GetCurrentSize();
+            if (buffer->builder.HasExternalBlobs()) {
+                // Readers need contiguous bytes that outlive the referenced arrays.
+                buffer->flat.resize(buffer->size);
+                buffer->builder.Flatten(buffer->flat.data());
+                buffer->data = buffer->flat.data();
+            }
+            else {
+                buffer->data = buffer->builder.GetBufferPointer();
+            }
+            buffer->version = ++m_version;
+
+            Buffer* previous = m_current.exchange(buffer, std::memory_order_seq_cst);
+            if (previous) {
+                // Readers that announced an epoch <= this one may hold 'previous'.
+                previous->retire_epoch = m_epoch.load(std::memory_order_seq_cst);
+                m_retired.push_back(previous);
+            }
+            m_epoch.fetch_add(1, std::memory_order_seq_cst);
+        }
+
+        // Copies a finished state in and publishes it.
+        bool Publish(const void* data, size_t size) {
+            RiftBufferBuilder* builder = BeginWrite();
+            if (!builder) return false;
+            builder->WriteRaw(data, size);
+            Publish();
+            return true;
+        }
+
+        uint64 GetVersion() const { return m_version; }
+        size_t GetBufferCount() const { return m_buffers.size(); }
+
+    private:
+        friend class RiftStateReader;
+
+        struct Buffer {
+            explicit Buffer(size_t capacity) : builder(capacity) {}
+            RiftBufferBuilder builder;
+            std::vector<uint8> flat; // Published bytes when the builder holds external blobs
+            const uint8* data = nullptr;
+            size_t size = 0;
+            uint64 version = 0;
+            uint64 retire_epoch = 0;
+        };
+
+        // Moves retired buffers that no reader can still see to the free list.
+        void Reclaim() {
+            uint64 oldest = RIFT_STATE_READER_IDLE;
+            for (uint32 i = 0; i < m_max_readers; ++i) {
+                oldest = std::min(oldest, m_slots[i].epoch.load(std::memory_order_seq_cst));
+            }
+            for (size_t i = 0; i < m_retired.size();) {
+                if (m_retired[i]->retire_epoch < oldest) {
+                    m_free.push_back(m_retired[i]);
+                    m_retired[i] = m_retired.back();
+                    m_retired.pop_back();
+                }
+                else {
+                    ++i;
+                }
+            }
+        }
+
+        std::unique_ptr<RiftStateReaderSlot[]> m_slots;
+        uint32 m_max_readers;
+        alignas(RIFT_CACHE_LINE_SIZE) std::atomic<Buffer*> m_current{ nullptr };
+        std::atomic<uint64> m_epoch{ 1 };
+
+        // Writer only
+        alignas(RIFT_CACHE_LINE_SIZE) uint32 m_max_buffers;
+        size_t m_initial_capacity;
+        uint64 m_version = 0;
+        Buffer* m_writing = nullptr;
+        std::vector<std::unique_ptr<Buffer>> m_buffers;
+        std::vector<Buffer*> m_free;
+        std::vector<Buffer*> m_retired;
+    };
+
+    // Defined after RiftStatePublisher, whose members it reads.
+    inline RiftStateSnapshot RiftStateReader::Acquire() {
+        RIFT_ASSERT(m_slot != nullptr, "Reader is not registered.");
+        RIFT_ASSERT(m_slot->epoch.load(std::memory_order_relaxed) == RIFT_STATE_READER_IDLE, "Reader already holds a snapshot.");
+        // Announce first, then load: a buffer replaced after the announcement
+        // is retired with an epoch >= the announced one and stays pinned.
+        m_slot->epoch.store(m_publisher->m_epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+        const RiftStatePublisher::Buffer* buffer = m_publisher->m_current.load(std::memory_order_seq_cst);
+        if (!buffer) return RiftStateSnapshot(m_slot, nullptr, 0, 0);
+        return RiftStateSnapshot(m_slot, buffer->data, buffer->size, buffer->version);
+    }
+
+} // namespace RiftSerializer
@@ -0,0 +1,365 @@
+﻿// RiftSerializer/include/RiftSerializer/DebugDraw.h
+//
+// Instanced debug-draw batches. Instead of one object per DebugLine or
+// DebugSphere, a frame's primitives are collected into structure-of-arrays
+// form and encoded as a single RiftObject:
+//
+//   [RiftObjectHeader][RiftDebugDrawHeader]
+//   [line starts][line ends][line colors][sphere centers][sphere radii][sphere colors]
+//
+// Each array starts on an 8-byte boundary and is tightly packed in one of the
+// common vertex formats, so a renderer can copy it into an instance buffer
+// unchanged:
+//   positions: Float32 (R32G32B32_FLOAT), Unorm16 (R16G16B16A16_UNORM, w = 0)
+//              or Unorm10 (R10G10B10A2_UNORM), relative to the batch bounds
+//   radii:     Float32 (R32_FLOAT) or Unorm16 (R16_UNORM) relative to radius_max
+//   colors:    RGBA8 (R8G8B8A8_UNORM)
+// Quantized positions decode as bounds_min + value * bounds_extent.
+
+#pragma once
+
+#include "../Accessor/Accessor.h"
+#include <glm/glm.hpp>
+#include <cmath>
+#include <vector>
+
+namespace RiftSerializer {
+
+    constexpr uint32 RIFT_DEBUG_DRAW_BATCH_SCHEMA_ID = 0xFFFF0030;
+
+    enum class RiftDebugPositionFormat : uint8 {
+        Float32 = 0, // 12 bytes
+        Unorm16,     // 8 bytes
+        Unorm10,     // 4 bytes
+    };
+
+    enum class RiftDebugRadiusFormat : uint8 {
+        Float32 = 0, // 4 bytes
+        Unorm16,     // 2 bytes
+    };
+
+    inline uint32 rift_debug_position_stride(RiftDebugPositionFormat format) {
+        switch (format) {
+        case RiftDebugPositionFormat::Unorm16: return 8;
+        case RiftDebugPositionFormat::Unorm10: return 4;
+        default: return 12;
+        }
+    }
+
+    inline uint32 rift_debug_radius_stride(RiftDebugRadiusFormat format) {
+        return format == RiftDebugRadiusFormat::Unorm16 ? 2 : 4;
+    }
+
+    // Array slots of RiftDebugDrawHeader::arrays.
+    enum RiftDebugDrawArray : uint32 {
+        RIFT_DEBUG_LINE_STARTS = 0,
+        RIFT_DEBUG_LINE_ENDS,
+        RIFT_DEBUG_LINE_COLORS,
+        RIFT_DEBUG_SPHERE_CENTERS,
+        RIFT_DEBUG_SPHERE_RADII,
+        RIFT_DEBUG_SPHERE_COLORS,
+        RIFT_DEBUG_ARRAY_COUNT,
+    };
+
+    struct alignas(8) RiftDebugDrawHeader {
+        RiftObjectHeader object; // schema_id = RIFT_DEBUG_DRAW_BATCH_SCHEMA_ID
+        uint32 line_count;
+        uint32 sphere_count;
+        uint8 position_format;   // RiftDebugPositionFormat
+        uint8 radius_format;     // RiftDebugRadiusFormat
+        uint8 reserved[2];
+        float bounds_min[3];
+        float bounds_extent[3];
+        float radius_max;
+        OffsetTableEntry arrays[RIFT_DEBUG_ARRAY_COUNT]; // offset from the object start, size in bytes
+    };
+    static_assert(sizeof(RiftDebugDrawHeader) == 104, "RiftDebugDrawHeader must be 104 bytes.");
+
+    // One array of a batch: count elements of stride bytes, ready to upload.
+    struct RiftDebugDrawSpan {
+        const uint8* data;
+        uint32 count;
+        uint32 stride;
+
+        size_t GetSizeBytes() const { return static_cast<size_t>(count) * stride; }
+    };
+
+    struct RiftDebugDrawConfig {
+        RiftDebugPositionFormat position_format = RiftDebugPositionFormat::Float32;
+        RiftDebugRadiusFormat radius_format = RiftDebugRadiusFormat::Float32;
+    };
+
+    // --- RiftDebugDrawBatchBuilder ---
+    // Collects a frame's primitives. Reuse it across frames: Clear() keeps
+    // the capacity.
+    class RiftDebugDrawBatchBuilder {
+    public:
+        explicit RiftDebugDrawBatchBuilder(const RiftDebugDrawConfig& config = RiftDebugDrawConfig()) : m_config(config) { Clear(); }
+
+        void Clear() {
+            m_line_starts.clear();
+            m_line_ends.clear();
+            m_line_colors.clear();
+            m_sphere_centers.clear();
+            m_sphere_radii.clear();
+            m_sphere_colors.clear();
+            m_min = glm::vec3(INFINITY);
+            m_max = glm::vec3(-INFINITY);
+            m_radius_max = 0.0f;
+        }
+
+        // color is RGBA8 with red in the lowest byte.
+        void AddLine(const glm::vec3& from, const glm::vec3& to, uint32 color) {
+            m_line_starts.push_back(from);
+            m_line_ends.push_back(to);
+            m_line_colors.push_back(color);
+            m_min = glm::min(m_min, glm::min(from, to));
+            m_max = glm::max(m_max, glm::max(from, to));
+        }
+
+        void AddSphere(const glm::vec3& center, float radius, uint32 color) {
+            m_sphere_centers.push_back(center);
+            m_sphere_radii.push_back(radius);
+            m_sphere_colors.push_back(color);
+            m_min = glm::min(m_min, center);
+            m_max = glm::max(m_max, center);
+            m_radius_max = std::max(m_radius_max, radius);
+        }
+
+        size_t GetLineCount() const { return m_line_starts.size(); }
+        size_t GetSphereCount() const { return m_sphere_centers.size(); }
+        bool IsEmpty() const { return m_line_starts.empty() && m_sphere_centers.empty(); }
+
+        // Exact size of the object Build() writes (e.g. for RiftEventProducer::BeginEvent).
+        size_t GetEncodedSize() const {
+            RiftDebugDrawHeader header;
+            return Layout(header);
+        }
+
+        // Appends the batch as one object. Works with RiftBufferBuilder and
+        // RiftSpanBuilder; returns the object's start offset.
+        template<typename Builder>
+        size_t Build(Builder& builder) const {
+            RiftDebugDrawHeader header{};
+            Layout(header);
+            const bool empty = IsEmpty();
+            for (int axis = 0; axis < 3; ++axis) {
+                header.bounds_min[axis] = empty ? 0.0f : m_min[axis];
+                header.bounds_extent[axis] = empty ? 0.0f : m_max[axis] - m_min[axis];
+            }
+            header.radius_max = m_radius_max;
+
+            const size_t start = builder.BeginObject();
+            builder.WriteRaw(&header, sizeof(header));
+            WritePositions(builder, m_line_starts, header);
+            WritePositions(builder, m_line_ends, header);
+            WriteArray(builder, m_line_colors.data(), m_line_colors.size() * sizeof(uint32));
+            WritePositions(builder, m_sphere_centers, header);
+            if (m_config.radius_format == RiftDebugRadiusFormat::Unorm16) {
+                const float scale = m_radius_max > 0.0f ? 65535.0f / m_radius_max : 0.0f;
+                WriteQuantized<uint16>(builder, m_sphere_radii.size(), [&](size_t i) {
+                    return static_cast<uint16>(std::clamp(m_sphere_radii[i] * scale, 0.0f, 65535.0f) + 0.5f);
+                });
+            }
+            else {
+                WriteArray(builder, m_sphere_radii.data(), m_sphere_radii.size() * sizeof(float));
+            }
+            WriteArray(builder, m_sphere_colors.data(), m_sphere_colors.size() * sizeof(uint32));
+            builder.EndObject(start, RIFT_DEBUG_DRAW_BATCH_SCHEMA_ID);
+            return start;
+        }
+
+    private:
+        // Fills counts, formats and array offsets; returns the object size.
+        size_t Layout(RiftDebugDrawHeader& header) const {
+            const uint32 position_stride = rift_debug_position_stride(m_config.position_format);
+            const uint32 counts[RIFT_DEBUG_ARRAY_COUNT] = {
+                static_cast<uint32>(m_line_starts.size()), static_cast<uint32>(m_line_ends.size()), static_cast<uint32>(m_line_colors.size()),
+                static_cast<uint32>(m_sphere_centers.size()), static_cast<uint32>(m_sphere_radii.size()), static_cast<uint32>(m_sphere_colors.size()) };
+            const uint32 strides[RIFT_DEBUG_ARRAY_COUNT] = {
+                position_stride, position_stride, 4, position_stride, rift_debug_radius_stride(m_config.radius_format), 4 };
+
+            header.line_count = to_little_endian(counts[RIFT_DEBUG_LINE_STARTS]);
+            header.sphere_count = to_little_endian(counts[RIFT_DEBUG_SPHERE_CENTERS]);
+            header.position_format = static_cast<uint8>(m_config.position_format);
+            header.radius_format = static_cast<uint8>(m_config.radius_format);
+            size_t offset = sizeof(RiftDebugDrawHeader);
+            for (uint32 i = 0; i < RIFT_DEBUG_ARRAY_COUNT; ++i) {
+                const size_t size = static_cast<size_t>(counts[i]) * strides[i];
+                header.arrays[i] = { to_little_endian(static_cast<uint32>(offset)), to_little_endian(static_cast<uint32>(size)) };
+                offset = align_up(offset + size, 8);
+            }
+            return offset;
+        }
+
+        template<typename Builder>
+        static void WriteArray(Builder& builder, const void* data, size_t size) {
+            builder.WriteRaw(data, size);
+            builder.PadToAlignment(8);
+        }
+
+        // Converts in small batches through a stack buffer.
+        template<typename T, typename Builder, typename Convert>
+        static void WriteQuantized(Builder& builder, size_t count, Convert&& convert) {
+            T batch[256];
+            for (size_t first = 0; first < count; first += 256) {
+                const size_t n = std::min<size_t>(count - first, 256);
+                for (size_t i = 0; i < n; ++i) batch[i] = convert(first + i);
+                builder.WriteRaw(batch, n * sizeof(T));
+            }
+            builder.PadToAlignment(8);
+        }
+
+        template<typename Builder>
+        void WritePositions(Builder& builder, const std::vector<glm::vec3>& positions, const RiftDebugDrawHeader& header) const {
+            const glm::vec3 min(header.bounds_min[0], header.bounds_min[1], header.bounds_min[2]);
+            const glm::vec3 extent(header.bounds_extent[0], header.bounds_extent[1], header.bounds_extent[2]);
+            switch (m_config.position_format) {
+            case RiftDebugPositionFormat::Unorm16: {
+                const glm::vec3 scale = Scale(extent, 65535.0f);
+                WriteQuantized<uint64>(builder, positions.size(), [&](size_t i) {
+                    const glm::vec3 q = glm::clamp((positions[i] - min) * scale, 0.0f, 65535.0f) + glm::vec3(0.5f);
+                    return static_cast<uint64>(q.x) | static_cast<uint64>(q.y) << 16 | static_cast<uint64>(q.z) << 32;
+                });
+                break;
+            }
+            case RiftDebugPositionFormat::Unorm10: {
+                const glm::vec3 scale = Scale(extent, 1023.0f);
+                WriteQuantized<uint32>(builder, positions.size(), [&](size_t i) {
+                    const glm::vec3 q = glm::clamp((positions[i] - min) * scale, 0.0f, 1023.0f) + glm::vec3(0.5f);
+                    return static_cast<uint32>(q.x) | static_cast<uint32>(q.y) << 10 | static_cast<uint32>(q.z) << 20;
+                });
+                break;
+            }
+            default:
+                WriteArray(builder, positions.data(), positions.size() * sizeof(glm::vec3));
+                break;
+            }
+        }
+
+        static glm::vec3 Scale(const glm::vec3& extent, float max_value) {
+            return glm::vec3(extent.x > 0.0f ? max_value / extent.x : 0.0f, extent.y > 0.0f ? max_value / extent.y : 0.0f,
+                extent.z > 0.0f ? max_value / extent.z : 0.0f);
+        }
+
+        RiftDebugDrawConfig m_config;
+        std::vector<glm::vec3> m_line_starts;
+        std::vector<glm::vec3> m_line_ends;
+        std::vector<uint32> m_line_colors;
+        std::vector<glm::vec3> m_sphere_centers;
+        std::vector<float> m_sphere_radii;
+        std::vector<uint32> m_sphere_colors;
+        glm::vec3 m_min;
+        glm::vec3 m_max;
+        float m_radius_max;
+    };
+
+    // --- RiftDebugDrawBatchView ---
+    class RiftDebugDrawBatchView : public RiftBufferViewBase {
+    public:
+        explicit RiftDebugDrawBatchView(const void* buffer) : RiftBufferViewBase(buffer) {
+            RIFT_ASSERT(GetSchemaId() == RIFT_DEBUG_DRAW_BATCH_SCHEMA_ID, "Object is not a debug-draw batch.");
+            RIFT_ASSERT(GetTotalSize() >= sizeof(RiftDebugDrawHeader), "Debug-draw batch is truncated.");
+        }
+
+        uint32 GetLineCount() const { return from_little_endian(Header().line_count); }
+        uint32 GetSphereCount() const { return from_little_endian(Header().sphere_count); }
+        RiftDebugPositionFormat GetPositionFormat() const { return static_cast<RiftDebugPositionFormat>(Header().position_format); }
+        RiftDebugRadiusFormat GetRadiusFormat() const { return static_cast<RiftDebugRadiusFormat>(Header().radius_format); }
+        glm::vec3 GetBoundsMin() const { return { Header().bounds_min[0], Header().bounds_min[1], Header().bounds_min[2] }; }
+        glm::vec3 GetBoundsExtent() const { return { Header().bounds_extent[0], Header().bounds_extent[1], Header().bounds_extent[2] }; }
+        float GetRadiusMax() const { return Header().radius_max; }
+
+        // Raw arrays, in their encoded format.
+        RiftDebugDrawSpan GetLineStarts() const { return Span(RIFT_DEBUG_LINE_STARTS, GetLineCount(), rift_debug_position_stride(GetPositionFormat())); }
+        RiftDebugDrawSpan GetLineEnds() const { return Span(RIFT_DEBUG_LINE_ENDS, GetLineCount(), rift_debug_position_stride(GetPositionFormat())); }
+        RiftDebugDrawSpan GetLineColors() const { return Span(RIFT_DEBUG_LINE_COLORS, GetLineCount(), 4); }
+        RiftDebugDrawSpan GetSphereCenters() const { return Span(RIFT_DEBUG_SPHERE_CENTERS, GetSphereCount(), rift_debug_position_stride(GetPositionFormat())); }
+        RiftDebugDrawSpan GetSphereRadii() const { return Span(RIFT_DEBUG_SPHERE_RADII, GetSphereCount(), rift_debug_radius_stride(GetRadiusFormat())); }
+        RiftDebugDrawSpan GetSphereColors() const { return Span(RIFT_DEBUG_SPHERE_COLORS, GetSphereCount(), 4); }
+
+        // Decodes a whole position array (GetLineStarts() etc.) into out[span.count].
+        void DecodePositions(const RiftDebugDrawSpan& span, glm::vec3* out) const {
+            const glm::vec3 min = GetBoundsMin();
+            switch (GetPositionFormat()) {
+            case RiftDebugPositionFormat::Unorm16: {
+                const glm::vec3 step = GetBoundsExtent() / 65535.0f;
+                for (uint32 i = 0; i < span.count; ++i) out[i] = min + Unpack16(Load<uint64>(span, i)) * step;
+                break;
+            }
+            case RiftDebugPositionFormat::Unorm10: {
+                const glm::vec3 step = GetBoundsExtent() / 1023.0f;
+                for (uint32 i = 0; i < span.count; ++i) out[i] = min + Unpack10(Load<uint32>(span, i)) * step;
+                break;
+            }
+            default:
+                std::memcpy(static_cast<void*>(out), span.data, span.GetSizeBytes());
+                break;
+            }
+        }
+
+        // Decodes all sphere radii into out[GetSphereCount()].
+        void DecodeRadii(float* out) const {
+            const RiftDebugDrawSpan radii = GetSphereRadii();
+            if (GetRadiusFormat() == RiftDebugRadiusFormat::Unorm16) {
+                const float step = GetRadiusMax() / 65535.0f;
+                for (uint32 i = 0; i < radii.count; ++i) out[i] = Load<uint16>(radii, i) * step;
+            }
+            else {
+                std::memcpy(out, radii.data, radii.GetSizeBytes());
+            }
+        }
+
+        // Decoded single elements, for CPU-side consumers.
+        glm::vec3 GetLineStart(uint32 index) const { return DecodePosition(GetLineStarts(), index); }
+        glm::vec3 GetLineEnd(uint32 index) const { return DecodePosition(GetLineEnds(), index); }
+        uint32 GetLineColor(uint32 index) const { return Load<uint32>(GetLineColors(), index); }
+        glm::vec3 GetSphereCenter(uint32 index) const { return DecodePosition(GetSphereCenters(), index); }
+        uint32 GetSphereColor(uint32 index) const { return Load<uint32>(GetSphereColors(), index); }
+        float GetSphereRadius(uint32 index) const {
+            const RiftDebugDrawSpan radii = GetSphereRadii();
+            if (GetRadiusFormat() == RiftDebugRadiusFormat::Unorm16) return Load<uint16>(radii, index) * (GetRadiusMax() / 65535.0f);
+            return Load<float>(radii, index);
+        }
+
+    private:
+        const RiftDebugDrawHeader& Header() const { return *reinterpret_cast<const RiftDebugDrawHeader*>(m_buffer_start); }
+
+        RiftDebugDrawSpan Span(uint32 array, uint32 count, uint32 stride) const {
+            const OffsetTableEntry& entry = Header().arrays[array];
+            const uint32 size = from_little_endian(entry.size);
+            RIFT_ASSERT(size == static_cast<size_t>(count) * stride, "Debug-draw array size does not match its count.");
+            return { GetPtrAtOffset(from_little_endian(entry.offset), size), count, stride };
+        }
+
+        template<typename T>
+        static T Load(const RiftDebugDrawSpan& span, uint32 index) {
+            RIFT_ASSERT(index < span.count, "Debug-draw index out of bounds.");
+            T value;
+            std::memcpy(&value, span.data + static_cast<size_t>(index) * span.stride, sizeof(T));
+            return value;
+        }
+
+        static glm::vec3 Unpack16(uint64 q) {
+            return glm::vec3(static_cast<float>(q & 0xFFFF), static_cast<float>(q >> 16 & 0xFFFF), static_cast<float>(q >> 32 & 0xFFFF));
+        }
+
+        static glm::vec3 Unpack10(uint32 q) {
+            return glm::vec3(static_cast<float>(q & 0x3FF), static_cast<float>(q >> 10 & 0x3FF), static_cast<float>(q >> 20 & 0x3FF));
+        }
+
+        glm::vec3 DecodePosition(const RiftDebugDrawSpan& span, uint32 index) const {
+            switch (GetPositionFormat()) {
+            case RiftDebugPositionFormat::Unorm16: {
+                return GetBoundsMin() + Unpack16(Load<uint64>(span, index)) * (GetBoundsExtent() / 65535.0f);
+            }
+            case RiftDebugPositionFormat::Unorm10: {
+                return GetBoundsMin() + Unpack10(Load<uint32>(span, index)) * (GetBoundsExtent() / 1023.0f);
+            }
+            default:
+                return Load<glm::vec3>(span, index);
+            }
+        }
+    };
+
+} // namespace RiftSerializer
@@ -0,0 +1,657 @@
+﻿// RiftSerializer/include/RiftSerializer/Json.h
+//
+// Generic JSON transcoder driven by the reflection tables in Reflection.h.
+// Buffer -> JSON writes into caller-provided memory and never allocates.
+// JSON -> buffer writes straight into a RiftBufferBuilder. String and
+// whitespace scanning use SSE2 when the target supports it.
+
+#pragma once
+
+#include "../Reflection/Reflection.h"
+#include "../Accessor/Accessor.h"
+#include "../Builder/Builder.h"
+#include <charconv>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RIFT_SERIALIZER_JSON_SSE2 1
+#endif
+
+namespace RiftSerializer {
+
+    namespace detail {
+        template<typename T>
+        inline void store_little_endian(uint8* p, T value) {
+            if constexpr (std::is_floating_point_v<T>) {
+                using Bits = std::conditional_t<sizeof(T) == 4, uint32, uint64>;
+                Bits bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                bits = to_little_endian(bits);
+                std::memcpy(p, &bits, sizeof(bits));
+            }
+            else {
+                value = to_little_endian(value);
+                std::memcpy(p, &value, sizeof(value));
+            }
+        }
+
+        inline bool is_json_whitespace(char c) {
+            return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+        }
+
+        // Index of the first byte in [p, p + n) that is '"', '\\' or a control
+        // character, or n if there is none.
+        inline size_t find_json_special(const char* p, size_t n) {
+            size_t i = 0;
+#ifdef RIFT_SERIALIZER_JSON_SSE2
+            const __m128i quote = _mm_set1_epi8('"');
+            const __m128i backslash = _mm_set1_epi8('\\');
+            const __m128i control = _mm_set1_epi8(0x1F);
+            for (; i + 16 <= n; i += 16) {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+                __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash));
+                hits = _mm_or_si128(hits, _mm_cmpeq_epi8(_mm_min_epu8(v, control), v)); // unsigned v <= 0x1F
+                const uint32 mask = static_cast<uint32>(_mm_movemask_epi8(hits));
+                if (mask != 0) return i + count_trailing_zeros(mask);
+            }
+#endif
+            for (; i < n; ++i) {
+                const auto c = static_cast<unsigned char>(p[i]);
+                if (c == '"' || c == '\\' || c < 0x20) return i;
+            }
+            return n;
+        }
+
+        inline const char* skip_json_whitespace(const char* p, const char* end) {
+#ifdef RIFT_SERIALIZER_JSON_SSE2
+            // Compact JSON rarely has whitespace, so check one byte before going wide.
+            while (p + 16 <= end) {
+                if (!is_json_whitespace(*p)) return p;
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                __m128i ws = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+                ws = _mm_or_si128(ws, _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))));
+                const uint32 mask = ~static_cast<uint32>(_mm_movemask_epi8(ws)) & 0xFFFFu;
+                if (mask != 0) return p + count_trailing_zeros(mask);
+                p += 16;
+            }
+#endif
+            while (p < end && is_json_whitespace(*p)) ++p;
+            return p;
+        }
+
+        inline int hex_digit_value(char c) {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        }
+    } // namespace detail
+
+    // --- RiftJsonWriter ---
+    // Appends JSON text to a caller-provided buffer. Never allocates; once the
+    // buffer is full further writes are dropped and HasOverflowed() is set.
+    class RiftJsonWriter {
+    public:
+        RiftJsonWriter(char* out, size_t capacity)
+            : m_out(out), m_capacity(capacity), m_size(0), m_overflow(false) {
+        }
+
+        const char* GetData() const { return m_out; }
+        size_t GetSize() const { return m_size; }
+        bool HasOverflowed() const { return m_overflow; }
+        void Reset() { m_size = 0; m_overflow = false; }
+
+        void WriteChar(char c) {
+            if (m_size < m_capacity) m_out[m_size++] = c;
+            else m_overflow = true;
+        }
+
+        void WriteRaw(const char* data, size_t size) {
+            if (size > m_capacity - m_size) { m_overflow = true; return; }
+            std::memcpy(m_out + m_size, data, size);
+            m_size += size;
+        }
+
+        void WriteNull() { WriteRaw("null", 4); }
+        void WriteBool(bool value) { value ? WriteRaw("true", 4) : WriteRaw("false", 5); }
+
+        template<typename T>
+        void WriteNumber(T value) {
+            if constexpr (std::is_floating_point_v<T>) {
+                if (!std::isfinite(value)) { WriteNull(); return; } // JSON has no NaN/Inf
+            }
+            const auto result = std::to_chars(m_out + m_size, m_out + m_capacity, value);
+            if (result.ec != std::errc()) { m_overflow = true; return; }
+            m_size = static_cast<size_t>(result.ptr - m_out);
+        }
+
+        // Writes a quoted, escaped JSON string.
+        void WriteString(const char* data, size_t size) {
+            WriteChar('"');
+            while (size > 0) {
+                const size_t run = detail::find_json_special(data, size);
+                WriteRaw(data, run);
+                if (run == size) break;
+                WriteEscaped(static_cast<unsigned char>(data[run]));
+                data += run + 1;
+                size -= run + 1;
+            }
+            WriteChar('"');
+        }
+
+    private:
+        void WriteEscaped(unsigned char c) {
+            switch (c) {
+            case '"':  WriteRaw("\\\"", 2); break;
+            case '\\': WriteRaw("\\\\", 2); break;
+            case '\n': WriteRaw("\\n", 2); break;
+            case '\r': WriteRaw("\\r", 2); break;
+            case '\t': WriteRaw("\\t", 2); break;
+            case '\b': WriteRaw("\\b", 2); break;
+            case '\f': WriteRaw("\\f", 2); break;
+            default: {
+                static constexpr char hex[] = "0123456789abcdef";
+                const char escaped[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF] };
+                WriteRaw(escaped, sizeof(escaped));
+                break;
+            }
+            }
+        }
+
+        char* m_out;
+        size_t m_capacity;
+        size_t m_size;
+        bool m_overflow;
+    };
+
+    // --- RiftJsonTranscoder ---
+    // Converts between RiftObjects and JSON using registered reflection tables.
+    // Objects are written as {"$schema":"Name","$schema_id":123,"field":value,...};
+    // vector types become fixed-length number arrays.
+    class RiftJsonTranscoder {
+    public:
+        // --- Buffer -> JSON ---
+
+        static bool ToJson(const RiftBufferViewBase& view, RiftJsonWriter& writer) {
+            const RiftSchemaInfo* schema = RiftSchemaRegistry::Instance().Find(view.GetSchemaId());
+            return schema != nullptr && ToJson(view, *schema, writer);
+        }
+
+        // Returns false if the object does not match the schema or the output overflowed.
+        static bool ToJson(const RiftBufferViewBase& view, const RiftSchemaInfo& schema, RiftJsonWriter& writer) {
+            const uint8* object = view.GetBufferStart();
+            const uint32 total_size = view.GetTotalSize();
+            if (view.GetSchemaId() != schema.schema_id || schema.inline_size > total_size) return false;
+
+            writer.WriteRaw("{\"$schema\":", 11);
+            writer.WriteString(schema.name, std::strlen(schema.name));
+            writer.WriteRaw(",\"$schema_id\":", 14);
+            writer.WriteNumber(schema.schema_id);
+
+            for (uint32 i = 0; i < schema.field_count; ++i) {
+                const RiftFieldInfo& field = schema.fields[i];
+                writer.WriteChar(',');
+                writer.WriteString(field.name, field.name_length);
+                writer.WriteChar(':');
+                if (!WriteField(field, object, total_size, writer)) return false;
+            }
+            writer.WriteChar('}');
+            return !writer.HasOverflowed();
+        }
+
+        // Convenience overload. Returns the number of bytes written, or 0 on failure.
+        static size_t ToJson(const RiftBufferViewBase& view, char* out, size_t capacity) {
+            RiftJsonWriter writer(out, capacity);
+            return ToJson(view, writer) ? writer.GetSize() : 0;
+        }
+
+        // --- JSON -> Buffer ---
+
+        // Parses one JSON object into a new RiftObject appended to the builder.
+        // Returns the number of input bytes consumed (including trailing
+        // whitespace), or 0 on failure, in which case the builder is rolled back.
+        static size_t FromJson(const char* json, size_t length, const RiftSchemaInfo& schema, RiftBufferBuilder& builder) {
+            JsonReader reader(json, length, builder, &schema);
+            return reader.Parse();
+        }
+
+        // Same, resolving the schema from a leading "$schema_id" member.
+        static size_t FromJson(const char* json, size_t length, RiftBufferBuilder& builder) {
+            JsonReader reader(json, length, builder, nullptr);
+            return reader.Parse();
+        }
+
+    private:
+        template<typename T>
+        static void WriteNumberAt(const uint8* p, RiftJsonWriter& writer) {
+            writer.WriteNumber(detail::load_little_endian<T>(p));
+        }
+
+        static void WriteScalar(RiftFieldType type, const uint8* p, RiftJsonWriter& writer) {
+            switch (type) {
+            case RiftFieldType::Bool:   writer.WriteBool(*p != 0); break;
+            case RiftFieldType::Int8:   WriteNumberAt<int8>(p, writer); break;
+            case RiftFieldType::UInt8:  WriteNumberAt<uint8>(p, writer); break;
+            case RiftFieldType::Int16:  WriteNumberAt<int16>(p, writer); break;
+            case RiftFieldType::UInt16: WriteNumberAt<uint16>(p, writer); break;
+            case RiftFieldType::Int32:  WriteNumberAt<int32>(p, writer); break;
+            case RiftFieldType::UInt32: WriteNumberAt<uint32>(p, writer); break;
+            case RiftFieldType::Int64:  WriteNumberAt<int64>(p, writer); break;
+            case RiftFieldType::UInt64: WriteNumberAt<uint64>(p, writer); break;
+            case RiftFieldType::Float:  WriteNumberAt<float>(p, writer); break;
+            case RiftFieldType::Double: WriteNumberAt<double>(p, writer); break;
+            case RiftFieldType::Vec2:
+            case RiftFieldType::Vec3:
+            case RiftFieldType::Vec4:
+            case RiftFieldType::Quat: {
+                const uint32 components = GetFieldTypeComponents(type);
+                writer.WriteChar('[');
+                for (uint32 c = 0; c < components; ++c) {
+                    if (c > 0) writer.WriteChar(',');
+                    WriteNumberAt<float>(p + c * sizeof(float), writer);
+                }
+                writer.WriteChar(']');
+                break;
+            }
+            default: writer.WriteNull(); break;
+            }
+        }
+
+        static bool WriteField(const RiftFieldInfo& field, const uint8* object, uint32 total_size, RiftJsonWriter& writer) {
+            const size_t slot_size = IsVariableSizeFieldType(field.type) ? sizeof(OffsetTableEntry) : GetFieldTypeSize(field.type);
+            if (slot_size == 0 || static_cast<uint64>(field.offset) + slot_size > total_size) return false;
+            const uint8* slot = object + field.offset;
+
+            if (!IsVariableSizeFieldType(field.type)) {
+                WriteScalar(field.type, slot, writer);
+                return true;
+            }
+
+            const uint32 data_offset = detail::load_little_endian<uint32>(slot);
+            const uint32 count = detail::load_little_endian<uint32>(slot + sizeof(uint32));
+            if (field.type == RiftFieldType::String) {
+                if (count == 0) { writer.WriteRaw("\"\"", 2); return true; }
+                if (static_cast<uint64>(data_offset) + count > total_size) return false;
+                writer.WriteString(reinterpret_cast<const char*>(object + data_offset), count);
+                return true;
+            }
+
+            const size_t element_size = GetFieldTypeSize(field.element_type);
+            if (element_size == 0) return false;
+            if (count > 0 && static_cast<uint64>(data_offset) + static_cast<uint64>(count) * element_size > total_size) return false;
+            writer.WriteChar('[');
+            for (uint32 i = 0; i < count; ++i) {
+                if (i > 0) writer.WriteChar(',');
+                WriteScalar(field.element_type, object + data_offset + i * element_size, writer);
+            }
+            writer.WriteChar(']');
+            return true;
+        }
+
+        // Single-pass recursive-descent reader writing directly into the builder.
+        class JsonReader {
+        public:
+            JsonReader(const char* json, size_t length, RiftBufferBuilder& builder, const RiftSchemaInfo* schema)
+                : m_begin(json), m_p(json), m_end(json + length), m_builder(builder), m_schema(schema),
+                m_rollback_size(builder.GetCurrentSize()), m_object_start(0), m_object_open(false) {
+            }
+
+            size_t Parse() {
+                if (!ParseObject()) {
+                    m_builder.Truncate(m_rollback_size);
+                    return 0;
+                }
+                m_p = detail::skip_json_whitespace(m_p, m_end);
+                return static_cast<size_t>(m_p - m_begin);
+            }
+
+        private:
+            bool Expect(char c) {
+                m_p = detail::skip_json_whitespace(m_p, m_end);
+                if (m_p >= m_end || *m_p != c) return false;
+                ++m_p;
+                return true;
+            }
+
+            bool Peek(char c) {
+                m_p = detail::skip_json_whitespace(m_p, m_end);
+                return m_p < m_end && *m_p == c;
+            }
+
+            void OpenObject() {
+                m_object_start = m_builder.BeginObject();
+                m_builder.Reserve(m_schema->inline_size); // Zero-filled; absent fields stay default.
+                m_object_open = true;
+            }
+
+            bool ParseObject() {
+                if (!Expect('{')) return false;
+                if (m_schema) OpenObject();
+
+                bool first = true;
+                while (!Peek('}')) {
+                    if (!first && !Expect(',')) return false;
+                    first = false;
+
+                    const char* key = nullptr;
+                    size_t key_length = 0;
+                    bool escaped = false;
+                    if (!ScanString(key, key_length, escaped) || !Expect(':')) return false;
+
+                    if (key_length > 0 && key[0] == '$') {
+                        if (!ParseMetaMember(key, key_length)) return false;
+                        continue;
+                    }
+                    if (!m_object_open) return false; // Schema must be known before the first field.
+
+                    const RiftFieldInfo* field = escaped ? nullptr : FindField(key, key_length);
+                    if (!(field ? ParseField(*field) : SkipValue())) return false;
+                }
+                ++m_p;
+                if (!m_object_open) return false;
+                m_builder.EndObject(m_object_start, m_schema->schema_id);
+                return true;
+            }
+
+            bool ParseMetaMember(const char* key, size_t key_length) {
+                if (key_length == 10 && std::memcmp(key, "$schema_id", 10) == 0) {
+                    uint32 schema_id = 0;
+                    if (!ParseInteger(schema_id)) return false;
+                    if (m_schema) return m_schema->schema_id == schema_id;
+                    m_schema = RiftSchemaRegistry::Instance().Find(schema_id);
+                    if (!m_schema) return false;
+                    OpenObject();
+                    return true;
+                }
+                return SkipValue(); // "$schema" is informational only.
+            }
+
+            const RiftFieldInfo* FindField(const char* key, size_t key_length) {
+                // Fields usually arrive in declaration order, so try the next one first.
+                if (m_next_field < m_schema->field_count) {
+                    const RiftFieldInfo& hint = m_schema->fields[m_next_field];
+                    if (hint.name_length == key_length && std::memcmp(hint.name, key, key_length) == 0) {
+                        ++m_next_field;
+                        return &hint;
+                    }
+                }
+                const RiftFieldInfo* field = m_schema->FindField(key, key_length);
+                if (field) m_next_field = static_cast<uint32>(field - m_schema->fields) + 1;
+                return field;
+            }
+
+            // Scans a string token. On return [out, out + length) is the raw,
+            // still-escaped content between the quotes.
+            bool ScanString(const char*& out, size_t& length, bool& escaped) {
+                if (!Expect('"')) return false;
+                const char* start = m_p;
+                escaped = false;
+                for (;;) {
+                    m_p += detail::find_json_special(m_p, static_cast<size_t>(m_end - m_p));
+                    if (m_p >= m_end) return false;
+                    if (*m_p == '"') break;
+                    if (*m_p != '\\' || m_p + 1 >= m_end) return false; // Raw control characters are invalid.
+                    escaped = true;
+                    m_p += 2;
+                }
+                out = start;
+                length = static_cast<size_t>(m_p - start);
+                ++m_p;
+                return true;
+            }
+
+            // Appends the unescaped form of a scanned string to the builder and
+            // returns the number of bytes written, or -1 on a malformed escape.
+            int64 WriteUnescaped(const char* p, size_t length) {
+                const char* end = p + length;
+                int64 written = 0;
+                while (p < end) {
+                    const char* run_end = p;
+                    while (run_end < end && *run_end != '\\') ++run_end;
+                    m_builder.WriteRaw(p, static_cast<size_t>(run_end - p));
+                    written += run_end - p;
+                    if (run_end == end) break;
+
+                    p = run_end + 1;
+                    char decoded = 0;
+                    switch (*p) {
+                    case '"':  decoded = '"'; break;
+                    case '\\': decoded = '\\'; break;
+                    case '/':  decoded = '/'; break;
+                    case 'b':  decoded = '\b'; break;
+                    case 'f':  decoded = '\f'; break;
+                    case 'n':  decoded = '\n'; break;
+                    case 'r':  decoded = '\r'; break;
+                    case 't':  decoded = '\t'; break;
+                    case 'u': {
+                        uint32 code_point = 0;
+                        if (!ParseHex4(p + 1, end, code_point)) return -1;
+                        p += 4;
+                        if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+                            uint32 low = 0;
+                            if (p + 2 >= end || p[1] != '\\' || p[2] != 'u' || !ParseHex4(p + 3, end, low)) return -1;
+                            if (low < 0xDC00 || low > 0xDFFF) return -1;
+                            code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                            p += 6;
+                        }
+                        written += WriteUtf8(code_point);
+                        ++p;
+                        continue;
+                    }
+                    default: return -1;
+                    }
+                    m_builder.WriteRaw(&decoded, 1);
+                    ++written;
+                    ++p;
+                }
+                return written;
+            }
+
+            static bool ParseHex4(const char* p, const char* end, uint32& out) {
+                if (end - p < 4) return false;
+                out = 0;
+                for (int i = 0; i < 4; ++i) {
+                    const int digit = detail::hex_digit_value(p[i]);
+                    if (digit < 0) return false;
+                    out = (out << 4) | static_cast<uint32>(digit);
+                }
+                return true;
+            }
+
+            int64 WriteUtf8(uint32 cp) {
+                uint8 bytes[4];
+                size_t count;
+                if (cp < 0x80) { bytes[0] = static_cast<uint8>(cp); count = 1; }
+                else if (cp < 0x800) { bytes[0] = static_cast<uint8>(0xC0 | (cp >> 6)); bytes[1] = static_cast<uint8>(0x80 | (cp & 0x3F)); count = 2; }
+                else if (cp < 0x10000) { bytes[0] = static_cast<uint8>(0xE0 | (cp >> 12)); bytes[1] = static_cast<uint8>(0x80 | ((cp >> 6) & 0x3F)); bytes[2] = static_cast<uint8>(0x80 | (cp & 0x3F)); count = 3; }
+                else { bytes[0] = static_cast<uint8>(0xF0 | (cp >> 18)); bytes[1] = static_cast<uint8>(0x80 | ((cp >> 12) & 0x3F)); bytes[2] = static_cast<uint8>(0x80 | ((cp >> 6) & 0x3F)); bytes[3] = static_cast<uint8>(0x80 | (cp & 0x3F)); count = 4; }
+                m_builder.WriteRaw(bytes, count);
+                return static_cast<int64>(count);
+            }
+
+            template<typename T>
+            bool ParseInteger(T& out) {
+                m_p = detail::skip_json_whitespace(m_p, m_end);
+                std::conditional_t<std::is_signed_v<T>, int64, uint64> value = 0;
+                const auto result = std::from_chars(m_p, m_end, value);
+                if (result.ec != std::errc()) return false;
+                if (value < static_cast<decltype(value)>(std::numeric_limits<T>::min()) ||
+                    value > static_cast<decltype(value)>(std::numeric_limits<T>::max())) return false;
+                m_p = result.ptr;
+                out = static_cast<T>(value);
+                return true;
+            }
+
+            bool ParseLiteral(const char* literal, size_t length) {
+                m_p = detail::skip_json_whitespace(m_p, m_end);
+                if (static_cast<size_t>(m_end - m_p) < length || std::memcmp(m_p, literal, length) != 0) return false;
+                m_p += length;
+                return true;
+            }
+
+            template<typename T>
+            bool ParseFloat(T& out) {
+                if (Peek('n')) {
+                    if (!ParseLiteral("null", 4)) return false;
+                    out = std::numeric_limits<T>::quiet_NaN();
+                    return true;
+                }
+                // from_chars also accepts "inf", "infinity" and "nan", which are not JSON.
+                const char* digits = (m_p < m_end && *m_p == '-') ? m_p + 1 : m_p;
+                if (digits >= m_end || *digits < '0' || *digits > '9') return false;
+                double value = 0.0;
+                const auto result = std::from_chars(m_p, m_end, value);
+                if (result.ec != std::errc()) return false;
+                m_p = result.ptr;
+                out = static_cast<T>(value);
+                return true;
+            }
+
+            template<typename T>
+            bool ParseNumberInto(uint8* out) {
+                T value{};
+                bool ok;
+                if constexpr (std::is_floating_point_v<T>) ok = ParseFloat(value);
+                else ok = ParseInteger(value);
+                if (ok) detail::store_little_endian(out, value);
+                return ok;
+            }
+
+            // Parses a fixed-size value into out (GetFieldTypeSize(type) bytes, little endian).
+            bool ParseScalar(RiftFieldType type, uint8* out) {
+                switch (type) {
+                case RiftFieldType::Bool:
+                    if (Peek('t')) { out[0] = 1; return ParseLiteral("true", 4); }
+                    out[0] = 0;
+                    return ParseLiteral("false", 5);
+                case RiftFieldType::Int8:   return ParseNumberInto<int8>(out);
+                case RiftFieldType::UInt8:  return ParseNumberInto<uint8>(out);
+                case RiftFieldType::Int16:  return ParseNumberInto<int16>(out);
+                case RiftFieldType::UInt16: return ParseNumberInto<uint16>(out);
+                case RiftFieldType::Int32:  return ParseNumberInto<int32>(out);
+                case RiftFieldType::UInt32: return ParseNumberInto<uint32>(out);
+                case RiftFieldType::Int64:  return ParseNumberInto<int64>(out);
+                case RiftFieldType::UInt64: return ParseNumberInto<uint64>(out);
+                case RiftFieldType::Float:  return ParseNumberInto<float>(out);
+                case RiftFieldType::Double: return ParseNumberInto<double>(out);
+                case RiftFieldType::Vec2:
+                case RiftFieldType::Vec3:
+                case RiftFieldType::Vec4:
+                case RiftFieldType::Quat: {
+                    const uint32 components = GetFieldTypeComponents(type);
+                    if (!Expect('[')) return false;
+                    for (uint32 c = 0; c < components; ++c) {
+                        if (c > 0 && !Expect(',')) return false;
+                        if (!ParseNumberInto<float>(out + c * sizeof(float))) return false;
+                    }
+                    return Expect(']');
+                }
+                default:
+                    return false;
+                }
+            }
+
+            bool ParseField(const RiftFieldInfo& field) {
+                if (static_cast<uint64>(field.offset) + (IsVariableSizeFieldType(field.type) ? sizeof(OffsetTableEntry) : GetFieldTypeSize(field.type)) > m_schema->inline_size) {
+                    return false;
+                }
+                const size_t slot = m_object_start + field.offset;
+
+                if (field.type == RiftFieldType::String) {
+                    const char* raw = nullptr;
+                    size_t raw_length = 0;
+                    bool escaped = false;
+                    if (!ScanString(raw, raw_length, escaped)) return false;
+                    OffsetTableEntry entry{ 0, 0 };
+                    if (raw_length > 0) {
+                        const size_t start = m_builder.GetCurrentSize();
+                        int64 length = static_cast<int64>(raw_length);
+                        if (escaped) length = WriteUnescaped(raw, raw_length);
+                        else m_builder.WriteRaw(raw, raw_length);
+                        if (length < 0) return false;
+                        const char terminator = '\0';
+                        m_builder.WriteRaw(&terminator, 1);
+                        entry = { to_little_endian(static_cast<uint32>(start - m_object_start)), to_little_endian(static_cast<uint32>(length)) };
+                    }
+                    m_builder.WriteAt(slot, &entry, sizeof(entry));
+                    return true;
+                }
+
+                if (field.type == RiftFieldType::Array) {
+                    const size_t element_size = GetFieldTypeSize(field.element_type);
+                    if (element_size == 0 || !Expect('[')) return false;
+                    OffsetTableEntry entry{ 0, 0 };
+                    if (!Peek(']')) {
+                        m_builder.PadToAlignment(GetFieldTypeAlignment(field.element_type));
+                        const size_t start = m_builder.GetCurrentSize();
+                        uint32 count = 0;
+                        for (;;) {
+                            uint8 element[16];
+                            if (!ParseScalar(field.element_type, element)) return false;
+                            m_builder.WriteRaw(element, element_size);
+                            ++count;
+                            if (!Peek(',')) break;
+                            ++m_p;
+                        }
+                        entry = { to_little_endian(static_cast<uint32>(start - m_object_start)), to_little_endian(count) };
+                    }
+                    if (!Expect(']')) return false;
+                    m_builder.WriteAt(slot, &entry, sizeof(entry));
+                    return true;
+                }
+
+                uint8 value[16];
+                if (!ParseScalar(field.type, value)) return false;
+                m_builder.WriteAt(slot, value, GetFieldTypeSize(field.type));
+                return true;
+            }
+
+            // Skips any JSON value (used for members the schema does not know).
+            bool SkipValue() {
+                m_p = detail::skip_json_whitespace(m_p, m_end);
+                if (m_p >= m_end) return false;
+                if (*m_p == '"') {
+                    const char* s;
+                    size_t n;
+                    bool e;
+                    return ScanString(s, n, e);
+                }
+                if (*m_p == '{' || *m_p == '[') {
+                    int depth = 0;
+                    while (m_p < m_end) {
+                        const char c = *m_p;
+                        if (c == '"') {
+                            const char* s;
+                            size_t n;
+                            bool e;
+                            if (!ScanString(s, n, e)) return false;
+                            continue;
+                        }
+                        if (c == '{' || c == '[') ++depth;
+                        else if (c == '}' || c == ']') {
+                            if (--depth == 0) { ++m_p; return true; }
+                        }
+                        ++m_p;
+                    }
+                    return false;
+                }
+                const char* start = m_p;
+                while (m_p < m_end && *m_p != ',' && *m_p != '}' && *m_p != ']' && !detail::is_json_whitespace(*m_p)) ++m_p;
+                return m_p != start;
+            }
+
+            const char* m_begin;
+            const char* m_p;
+            const char* m_end;
+            RiftBufferBuilder& m_builder;
+            const RiftSchemaInfo* m_schema;
+            size_t m_rollback_size;
+            size_t m_object_start;
+            bool m_object_open;
+            uint32 m_next_field = 0;
+        };
+    };
+
+} // namespace RiftSerializer
@@ -0,0 +1,431 @@
+﻿// RiftSerializer/include/RiftSerializer/LogWriter.h
+//
+// Append-only object log (e.g. gameplay replays) with group commit.
+//
+// Layout:
+//   [RiftLogFileHeader][object 0][pad to 8][object 1][pad to 8]...
+//
+// The producer copies finished objects into a single-producer byte ring
+// (wait-free: no locks, no CAS loops, no syscalls). A background thread
+// drains the ring into page-aligned batch buffers, issues large writes and
+// syncs according to RiftLogSyncPolicy. With use_async_io the batches are
+// written through RiftAsyncIo (io_uring on Linux) with several in flight.
+
+#pragma once
+
+#include "../AsyncIO/AsyncIO.h"
+#include "../Builder/Builder.h"
+#include "../Memory/AlignedBuffer.h"
+#include "../Platform/File.h"
+#include "../Stats/Histogram.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+namespace RiftSerializer {
+
+    // 'RFL1' in Little Endian (version 1)
+    constexpr uint32 RIFT_LOG_MAGIC_NUMBER = 0x314C4652;
+    constexpr uint32 RIFT_LOG_VERSION = 1;
+
+    struct alignas(8) RiftLogFileHeader {
+        uint32 magic;    // 'RFL1'
+        uint32 version;
+        uint64 reserved;
+    };
+    static_assert(sizeof(RiftLogFileHeader) == 16, "RiftLogFileHeader must be 16 bytes.");
+
+    enum class RiftLogSyncPolicy {
+        Never,              // Leave flushing to the OS
+        ByBytes,            // Sync once sync_bytes have been written since the last sync
+        ByInterval,         // Sync at most every sync_interval_ms while data is pending
+        ByBytesOrInterval,  // Whichever comes first
+    };
+
+    struct RiftLogWriterConfig {
+        size_t queue_capacity = 16u << 20;  // Producer ring size in bytes (rounded up to a power of two)
+        size_t batch_size = 1u << 20;       // Bytes per write call
+        uint32 max_batch_delay_us = 2000;   // A partial batch is written once it is this old
+        uint32 idle_sleep_us = 200;         // Writer thread back-off when the ring is empty
+        RiftLogSyncPolicy sync_policy = RiftLogSyncPolicy::ByBytesOrInterval;
+        uint64 sync_bytes = 8u << 20;
+        uint32 sync_interval_ms = 100;
+        bool use_async_io = false;          // Overlap writes via RiftAsyncIo instead of blocking writes
+        uint32 async_batches = 4;           // Batch buffers (and so writes in flight) in async mode
+    };
+
+    struct RiftLogWriterStats {
+        uint64 appended_objects;
+        uint64 appended_bytes;
+        uint64 dropped_objects;     // Appends rejected because the ring was full
+        uint64 written_bytes;
+        uint64 write_calls;
+        uint64 sync_calls;
+        uint64 queue_depth_bytes;   // Bytes appended but not yet taken by the writer thread
+    };
+
+    // --- RiftLogWriter ---
+    // Append() may be called from one producer thread at a time. Open() and
+    // Close() must not race with Append().
+    class RiftLogWriter {
+    public:
+        explicit RiftLogWriter(const RiftLogWriterConfig& config = RiftLogWriterConfig())
+            : m_config(config) {
+            size_t capacity = 4096;
+            while (capacity < config.queue_capacity) capacity <<= 1;
+            m_ring.Allocate(capacity, RIFT_CACHE_LINE_SIZE);
+            m_ring_mask = capacity - 1;
+            m_config.batch_size = align_up(std::max<size_t>(config.batch_size, 4096), 4096);
+            const uint32 batches = config.use_async_io ? std::max<uint32>(config.async_batches, 2) : 1;
+            m_batches = std::make_unique<RiftIoBufferPool>(batches, m_config.batch_size);
+            m_submit_times.resize(batches);
+            m_submit_sizes.resize(batches);
+        }
+        ~RiftLogWriter() { Close(); }
+        RiftLogWriter(const RiftLogWriter&) = delete;
+        RiftLogWriter& operator=(const RiftLogWriter&) = delete;
+
+        bool Open(const char* path) {
+            Close();
+            if (!m_file.Open(path, RiftFileMode::Write)) return false;
+
+            m_head.store(0, std::memory_order_relaxed);
+            m_tail.store(0, std::memory_order_relaxed);
+            m_cached_head = 0;
+            m_file_offset = 0;
+            m_write_failed = false;
+
+            m_async = m_config.use_async_io && m_io.Init(m_batches->GetBufferCount());
+            if (m_async) m_io.RegisterBuffers(*m_batches);
+            m_batch_index = static_cast<uint32>(m_batches->Acquire());
+
+            RiftLogFileHeader header{};
+            header.magic = to_little_endian(RIFT_LOG_MAGIC_NUMBER);
+            header.version = to_little_endian(RIFT_LOG_VERSION);
+            std::memcpy(m_batches->GetBuffer(m_batch_index), &header, sizeof(header));
+            m_batch_fill = sizeof(header);
+
+            m_running.store(true, std::memory_order_release);
+            m_thread = std::thread([this] { Run(); });
+            return true;
+        }
+
+        // Flushes everything appended so far, syncs (unless the policy is Never)
+        // and closes the file.
+        void Close() {
+            if (!m_thread.joinable()) return;
+            m_running.store(false, std::memory_order_release);
+            m_thread.join();
+            m_io.Close();
+            m_batches->Release(m_batch_index);
+            m_file.Close();
+        }
+
+        bool IsOpen() const { return m_thread.joinable(); }
+        // Size of the producer ring; no single Append() can exceed it.
+        size_t GetQueueCapacity() const { return m_ring_mask + 1; }
+        // True if a write or sync has failed since Open().
+        bool HasFailed() const { return m_write_failed.load(std::memory_order_relaxed); }
+        RiftAsyncIoBackend GetIoBackend() const { return m_async ? m_io.GetBackend() : RiftAsyncIoBackend::None; }
+
+        // Wait-free. Copies one finished object (or any 8-byte aligned run of
+        // objects) into the ring. Returns false, and counts a drop, if the ring
+        // does not currently have room.
+        bool Append(const void* data, size_t size) {
+            return AppendWith(size, [&](uint64 tail) { CopyToRing(tail, data, size); });
+        }
+
+        // Gather form: the slices are appended back to back as one unit, or
+        // not at all.
+        bool Append(const RiftIoSlice* slices, size_t count) {
+            size_t size = 0;
+            for (size_t i = 0; i < count; ++i) size += slices[i].size;
+            return AppendWith(size, [&](uint64 tail) {
+                for (size_t i = 0; i < count; ++i) {
+                    CopyToRing(tail, slices[i].data, slices[i].size);
+                    tail += slices[i].size;
+                }
+            });
+        }
+
+        // Appends every object currently held by the builder, external blobs included.
+        bool Append(const RiftBufferBuilder& builder) {
+            return AppendWith(builder.GetCurrentSize(), [&](uint64 tail) {
+                builder.ForEachIoSlice([&](const RiftIoSlice& slice) {
+                    CopyToRing(tail, slice.data, slice.size);
+                    tail += slice.size;
+                });
+            });
+        }
+
+        RiftLogWriterStats GetStats() const {
+            RiftLogWriterStats stats;
+            stats.appended_objects = m_appended_objects.load(std::memory_order_relaxed);
+            stats.appended_bytes = m_appended_bytes.load(std::memory_order_relaxed);
+            stats.dropped_objects = m_dropped_objects.load(std::memory_order_relaxed);
+            stats.written_bytes = m_written_bytes.load(std::memory_order_relaxed);
+            stats.write_calls = m_write_calls.load(std::memory_order_relaxed);
+            stats.sync_calls = m_sync_calls.load(std::memory_order_relaxed);
+            stats.queue_depth_bytes = m_tail.load(std::memory_order_relaxed) - m_head.load(std::memory_order_relaxed);
+            return stats;
+        }
+
+        // Ring occupancy in bytes, sampled each time the writer thread drains.
+        const RiftHistogram& GetQueueDepthHistogram() const { return m_queue_depth; }
+        // Duration of each write call in nanoseconds.
+        const RiftHistogram& GetWriteLatencyHistogram() const { return m_write_latency; }
+        // Duration of each sync call in nanoseconds.
+        const RiftHistogram& GetSyncLatencyHistogram() const { return m_sync_latency; }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        // Reserves size bytes (padded to 8) at the tail, lets copy(tail) fill
+        // them and publishes them.
+        template<typename Copy>
+        bool AppendWith(size_t size, Copy&& copy) {
+            RIFT_ASSERT(IsOpen(), "Log writer is not open.");
+            const size_t padded = align_up(size, alignof(RiftObjectHeader));
+            const uint64 tail = m_tail.load(std::memory_order_relaxed);
+            const size_t capacity = m_ring_mask + 1;
+            if (padded > capacity - (tail - m_cached_head)) {
+                m_cached_head = m_head.load(std::memory_order_acquire);
+                if (padded > capacity - (tail - m_cached_head)) {
+                    Bump(m_dropped_objects, 1);
+                    return false;
+                }
+            }
+
+            copy(tail);
+            if (padded != size) {
+                static constexpr uint8 zeros[alignof(RiftObjectHeader)] = {};
+                CopyToRing(tail + size, zeros, padded - size);
+            }
+            m_tail.store(tail + padded, std::memory_order_release);
+            Bump(m_appended_objects, 1);
+            Bump(m_appended_bytes, padded);
+            return true;
+        }
+
+        // Counters with a single writer thread: a plain load/store pair avoids a locked RMW.
+        static void Bump(std::atomic<uint64>& counter, uint64 amount) {
+            counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+
+        void CopyToRing(uint64 position, const void* data, size_t size) {
+            const size_t start = static_cast<size_t>(position) & m_ring_mask;
+            const size_t first = std::min(size, m_ring_mask + 1 - start);
+            std::memcpy(m_ring.GetData() + start, data, first);
+            std::memcpy(m_ring.GetData(), static_cast<const uint8*>(data) + first, size - first);
+        }
+
+        void CopyFromRing(uint64 position, void* out, size_t size) const {
+            const size_t start = static_cast<size_t>(position) & m_ring_mask;
+            const size_t first = std::min(size, m_ring_mask + 1 - start);
+            std::memcpy(out, m_ring.GetData() + start, first);
+            std::memcpy(static_cast<uint8*>(out) + first, m_ring.GetData(), size - first);
+        }
+
+        static uint64 ElapsedNs(Clock::time_point start) {
+            return static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+        }
+
+        void WriteBatch() {
+            uint8* data = m_batches->GetBuffer(m_batch_index);
+            Bump(m_write_calls, 1);
+            Bump(m_written_bytes, m_batch_fill);
+            m_unsynced_bytes += m_batch_fill;
+
+            if (!m_async) {
+                const auto start = Clock::now();
+                if (!m_file.Write(data, m_batch_fill)) m_write_failed.store(true, std::memory_order_relaxed);
+                m_write_latency.Record(ElapsedNs(start));
+                m_file_offset += m_batch_fill;
+                m_batch_fill = 0;
+                return;
+            }
+
+            // Hand the batch to the kernel and continue filling another buffer.
+            m_submit_times[m_batch_index] = Clock::now();
+            m_submit_sizes[m_batch_index] = m_batch_fill;
+            const RiftIoRequest request{ RiftIoOp::Write, &m_file, data, static_cast<uint32>(m_batch_fill), m_file_offset,
+                static_cast<int32>(m_batch_index), m_batch_index };
+            if (!m_io.Prepare(request)) {
+                m_write_failed.store(true, std::memory_order_relaxed);
+                m_batches->Release(m_batch_index);
+            }
+            m_io.Submit();
+            m_file_offset += m_batch_fill;
+            m_batch_fill = 0;
+
+            int32 next = m_batches->Acquire();
+            while (next < 0) {
+                ReapWrites(true);
+                next = m_batches->Acquire();
+            }
+            m_batch_index = static_cast<uint32>(next);
+        }
+
+        void ReapWrites(bool wait) {
+            RiftIoCompletion completions[16];
+            const uint32 count = wait ? m_io.WaitAndReap(completions, 16) : m_io.Reap(completions, 16);
+            for (uint32 i = 0; i < count; ++i) {
+                const auto index = static_cast<uint32>(completions[i].user_data);
+                m_write_latency.Record(ElapsedNs(m_submit_times[index]));
+                if (completions[i].result != static_cast<int64>(m_submit_sizes[index])) m_write_failed.store(true, std::memory_order_relaxed);
+                m_batches->Release(index);
+            }
+        }
+
+        void SyncFile() {
+            while (m_async && m_io.GetInFlight() > 0) ReapWrites(true); // Sync only covers completed writes.
+            const auto start = Clock::now();
+            if (!m_file.Sync()) m_write_failed.store(true, std::memory_order_relaxed);
+            m_sync_latency.Record(ElapsedNs(start));
+            Bump(m_sync_calls, 1);
+            m_unsynced_bytes = 0;
+            m_last_sync = Clock::now();
+        }
+
+        bool ShouldSync(Clock::time_point now) const {
+            if (m_unsynced_bytes == 0) return false;
+            const bool by_bytes = m_unsynced_bytes >= m_config.sync_bytes;
+            const bool by_time = now - m_last_sync >= std::chrono::milliseconds(m_config.sync_interval_ms);
+            switch (m_config.sync_policy) {
+            case RiftLogSyncPolicy::ByBytes:           return by_bytes;
+            case RiftLogSyncPolicy::ByInterval:        return by_time;
+            case RiftLogSyncPolicy::ByBytesOrInterval: return by_bytes || by_time;
+            default:                                   return false;
+            }
+        }
+
+        void Run() {
+            m_unsynced_bytes = 0;
+            m_last_sync = Clock::now();
+            Clock::time_point batch_started = m_last_sync;
+
+            for (;;) {
+                // Read the flag before the tail so every append made before Close() is seen.
+                const bool stopping = !m_running.load(std::memory_order_acquire);
+                const uint64 tail = m_tail.load(std::memory_order_acquire);
+                const uint64 head = m_head.load(std::memory_order_relaxed);
+                const uint64 available = tail - head;
+
+                size_t taken = 0;
+                if (available > 0) {
+                    m_queue_depth.Record(available);
+                    taken = static_cast<size_t>(std::min<uint64>(available, m_config.batch_size - m_batch_fill));
+                    if (m_batch_fill == 0) batch_started = Clock::now();
+                    CopyFromRing(head, m_batches->GetBuffer(m_batch_index) + m_batch_fill, taken);
+                    m_batch_fill += taken;
+                    m_head.store(head + taken, std::memory_order_release);
+                }
+
+                const bool drained = taken == available;
+                const auto now = Clock::now();
+                if (m_batch_fill == m_config.batch_size ||
+                    (m_batch_fill > 0 && ((stopping && drained) || now - batch_started >= std::chrono::microseconds(m_config.max_batch_delay_us)))) {
+                    WriteBatch();
+                }
+                if (m_async && m_io.GetInFlight() > 0) ReapWrites(false);
+                if (ShouldSync(now)) SyncFile();
+
+                if (stopping && drained && m_batch_fill == 0) break;
+                if (taken == 0) std::this_thread::sleep_for(std::chrono::microseconds(m_config.idle_sleep_us));
+            }
+
+            while (m_async && m_io.GetInFlight() > 0) ReapWrites(true);
+            if (m_config.sync_policy != RiftLogSyncPolicy::Never && m_unsynced_bytes > 0) SyncFile();
+        }
+
+        RiftLogWriterConfig m_config;
+
+        // Producer side
+        alignas(RIFT_CACHE_LINE_SIZE) std::atomic<uint64> m_tail{ 0 };
+        uint64 m_cached_head = 0;
+        std::atomic<uint64> m_appended_objects{ 0 };
+        std::atomic<uint64> m_appended_bytes{ 0 };
+        std::atomic<uint64> m_dropped_objects{ 0 };
+
+        // Consumer side
+        alignas(RIFT_CACHE_LINE_SIZE) std::atomic<uint64> m_head{ 0 };
+        std::atomic<uint64> m_written_bytes{ 0 };
+        std::atomic<uint64> m_write_calls{ 0 };
+        std::atomic<uint64> m_sync_calls{ 0 };
+        size_t m_batch_fill = 0;
+        uint32 m_batch_index = 0;
+        uint64 m_file_offset = 0;
+        uint64 m_unsynced_bytes = 0;
+        Clock::time_point m_last_sync;
+
+        alignas(RIFT_CACHE_LINE_SIZE) std::atomic<bool> m_running{ false };
+        RiftAlignedBuffer m_ring;
+        size_t m_ring_mask = 0;
+        std::unique_ptr<RiftIoBufferPool> m_batches;
+        std::vector<Clock::time_point> m_submit_times;
+        std::vector<size_t> m_submit_sizes;
+        RiftAsyncIo m_io;
+        bool m_async = false;
+        std::atomic<bool> m_write_failed{ false };
+        RiftFile m_file;
+        std::thread m_thread;
+        RiftHistogram m_queue_depth;
+        RiftHistogram m_write_latency;
+        RiftHistogram m_sync_latency;
+    };
+
+    // --- RiftLogReader ---
+    // Maps a log file and walks its objects in order. A torn tail (from a
+    // crash mid-write) simply ends the iteration.
+    class RiftLogReader {
+    public:
+        bool Open(const char* path) {
+            m_offset = 0;
+            if (!m_file.Open(path)) return false;
+            const auto* header = reinterpret_cast<const RiftLogFileHeader*>(m_file.GetData());
+            if (m_file.GetSize() < sizeof(RiftLogFileHeader) ||
+                from_little_endian(header->magic) != RIFT_LOG_MAGIC_NUMBER ||
+                from_little_endian(header->version) != RIFT_LOG_VERSION) {
+                m_file.Close();
+                return false;
+            }
+            m_offset = sizeof(RiftLogFileHeader);
+            return true;
+        }
+
+        void Close() { m_file.Close(); }
+
+        // Returns the next object, or nullptr at the end of the valid data.
+        const void* Next() {
+            const void* object = PeekAt(m_offset);
+            if (object) m_offset += align_up(from_little_endian(static_cast<const RiftObjectHeader*>(object)->total_size), alignof(RiftObjectHeader));
+            return object;
+        }
+
+        // Returns the object starting at the given file offset, or nullptr if
+        // there is no complete object there.
+        const void* PeekAt(uint64 offset) const {
+            // Offsets may come from file contents (e.g. a replay trailer), so compare without wrapping.
+            if (!m_file.IsOpen() || offset % alignof(RiftObjectHeader) != 0 || offset > m_file.GetSize() ||
+                m_file.GetSize() - offset < sizeof(RiftObjectHeader)) {
+                return nullptr;
+            }
+            const auto* header = reinterpret_cast<const RiftObjectHeader*>(m_file.GetData() + offset);
+            const uint32 size = from_little_endian(header->total_size);
+            if (from_little_endian(header->magic) != RIFT_MAGIC_NUMBER || size < sizeof(RiftObjectHeader) || size > m_file.GetSize() - offset) {
+                return nullptr;
+            }
+            return header;
+        }
+
+        void Seek(uint64 offset) { m_offset = offset; }
+        uint64 GetOffset() const { return m_offset; }
+        const RiftMappedFile& GetMappedFile() const { return m_file; }
+
+    private:
+        RiftMappedFile m_file;
+        uint64 m_offset = 0;
+    };
+
+} // namespace RiftSerializer
@@ -0,0 +1,694 @@
+﻿// RiftSerializer/include/RiftSerializer/Logger.h
+//
+// Binary structured logging. A log call stores only its call site's id, a
+// timestamp and the raw argument bytes as one RiftObject in a per-thread
+// chunk (RiftEventQueue), so the calling thread never formats text, takes a
+// lock or makes a syscall. Messages are formatted lazily: by sinks on the
+// logger's background thread, or offline from a binary log file.
+//
+//   static RiftTextLogSink sink(stderr); // Must outlive the logger
+//   static RiftBinaryLogger logger;
+//   logger.AddSink(sink.GetSink());
+//   logger.Start();
+//   RIFT_BLOG(logger, RiftLogLevel::Info, "player {} joined at {:.2f}", player_id, time);
+//
+// Format strings use {} placeholders; {:x} prints integers in hex and {:.N}
+// sets the precision of floating-point values. Arguments may be integers,
+// enums, floating-point values, bool, char, pointers and strings.
+//
+// Records become visible to the background thread when their chunk fills,
+// when the thread calls FlushThread(), at Warn level and above, or on the
+// first log call after each flush interval.
+
+#pragma once
+
+#include "../Concurrency/EventQueue.h"
+#include "../LogWriter/LogWriter.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <string>
+#include <string_view>
+
+namespace RiftSerializer {
+
+    enum class RiftLogLevel : uint8 {
+        Trace = 0,
+        Debug,
+        Info,
+        Warn,
+        Error,
+        Critical,
+        Off,
+    };
+
+    inline const char* rift_log_level_name(RiftLogLevel level) {
+        static const char* const names[] = { "trace", "debug", "info", "warning", "error", "critical", "off" };
+        return names[std::min<uint32>(static_cast<uint32>(level), 6)];
+    }
+
+    // Reserved schema ids for the logger's own objects.
+    constexpr uint32 RIFT_LOG_RECORD_SCHEMA_ID = 0xFFFF0020;
+    constexpr uint32 RIFT_LOG_FORMAT_SCHEMA_ID = 0xFFFF0021;
+
+    // Fixed part of a record object; the packed arguments follow.
+    struct alignas(8) RiftLogRecordHeader {
+        RiftObjectHeader object; // schema_id = RIFT_LOG_RECORD_SCHEMA_ID
+        uint64 timestamp_ns;     // Since the Unix epoch
+        uint32 site_id;
+        uint32 thread_id;
+    };
+    static_assert(sizeof(RiftLogRecordHeader) == 32, "RiftLogRecordHeader must be 32 bytes.");
+
+    // Fixed part of a call-site definition in a binary log file; the format,
+    // file and signature strings follow, each null-terminated.
+    struct alignas(8) RiftLogFormatHeader {
+        RiftObjectHeader object; // schema_id = RIFT_LOG_FORMAT_SCHEMA_ID
+        uint32 site_id;
+        uint32 line;
+        uint32 level;
+        uint32 reserved;
+    };
+    static_assert(sizeof(RiftLogFormatHeader) == 32, "RiftLogFormatHeader must be 32 bytes.");
+
+    // Largest jump in site ids RiftBinaryLogDecoder accepts between the
+    // definitions in a file.
+    constexpr uint32 RIFT_LOG_MAX_SITE_ID_GAP = 1u << 16;
+
+    // --- RiftLogSite ---
+    // One static instance per log call site (created by RIFT_BLOG). The id
+    // and argument signature are assigned on the first call.
+    struct RiftLogSite {
+        RiftLogSite(RiftLogLevel level_, const char* format_, const char* file_, uint32 line_)
+            : level(level_), format(format_), file(file_), line(line_) {}
+
+        RiftLogLevel level;
+        const char* format;
+        const char* file;
+        uint32 line;
+        const char* signature = ""; // One type code per argument (see detail::log_arg)
+        std::atomic<uint32> id{ 0 };
+    };
+
+    namespace detail {
+        // Argument encoding: integers, pointers and floating-point values take
+        // 8 bytes, bool and char 1, strings a uint32 length plus the bytes.
+        template<typename T, typename = void>
+        struct log_arg;
+
+        template<typename T>
+        struct log_arg<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>>> {
+            static constexpr char code = std::is_signed_v<T> ? 'i' : 'u';
+            static size_t size(T) { return sizeof(uint64); }
+            template<typename Builder>
+            static void write(Builder& builder, T value) {
+                const auto stored = to_little_endian(static_cast<uint64>(static_cast<std::conditional_t<std::is_signed_v<T>, int64, uint64>>(value)));
+                builder.WriteRaw(&stored, sizeof(stored));
+            }
+        };
+
+        template<typename T>
+        struct log_arg<T, std::enable_if_t<std::is_enum_v<T>>> : log_arg<std::underlying_type_t<T>> {
+            template<typename Builder>
+            static void write(Builder& builder, T value) { log_arg<std::underlying_type_t<T>>::write(builder, static_cast<std::underlying_type_t<T>>(value)); }
+            static size_t size(T) { return sizeof(uint64); }
+        };
+
+        template<typename T>
+        struct log_arg<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+            static constexpr char code = 'd';
+            static size_t size(T) { return sizeof(double); }
+            template<typename Builder>
+            static void write(Builder& builder, T value) {
+                const double stored = static_cast<double>(value);
+                uint64 bits;
+                std::memcpy(&bits, &stored, sizeof(bits));
+                bits = to_little_endian(bits);
+                builder.WriteRaw(&bits, sizeof(bits));
+            }
+        };
+
+        template<>
+        struct log_arg<bool> {
+            static constexpr char code = 'b';
+            static size_t size(bool) { return 1; }
+            template<typename Builder>
+            static void write(Builder& builder, bool value) {
+                const uint8 stored = value ? 1 : 0;
+                builder.WriteRaw(&stored, 1);
+            }
+        };
+
+        template<>
+        struct log_arg<char> {
+            static constexpr char code = 'c';
+            static size_t size(char) { return 1; }
+            template<typename Builder>
+            static void write(Builder& builder, char value) { builder.WriteRaw(&value, 1); }
+        };
+
+        template<>
+        struct log_arg<std::string_view> {
+            static constexpr char code = 's';
+            static size_t size(std::string_view value) { return sizeof(uint32) + value.size(); }
+            template<typename Builder>
+            static void write(Builder& builder, std::string_view value) {
+                const uint32 length = to_little_endian(static_cast<uint32>(value.size()));
+                builder.WriteRaw(&length, sizeof(length));
+                builder.WriteRaw(value.data(), value.size());
+            }
+        };
+
+        template<> struct log_arg<std::string> : log_arg<std::string_view> {};
+        template<> struct log_arg<const char*> : log_arg<std::string_view> {
+            static size_t size(const char* value) { return log_arg<std::string_view>::size(value ? value : "(null)"); }
+            template<typename Builder>
+            static void write(Builder& builder, const char* value) { log_arg<std::string_view>::write(builder, value ? value : "(null)"); }
+        };
+        template<> struct log_arg<char*> : log_arg<const char*> {};
+
+        template<typename T>
+        struct log_arg<T*, std::enable_if_t<!std::is_same_v<std::remove_cv_t<T>, char>>> {
+            static constexpr char code = 'p';
+            static size_t size(const T*) { return sizeof(uint64); }
+            template<typename Builder>
+            static void write(Builder& builder, const T* value) {
+                const auto stored = to_little_endian(static_cast<uint64>(reinterpret_cast<uintptr_t>(value)));
+                builder.WriteRaw(&stored, sizeof(stored));
+            }
+        };
+
+        // Arrays decay (string literals become const char*).
+        template<typename T>
+        using log_arg_t = log_arg<std::decay_t<T>>;
+
+        template<typename... Args>
+        struct log_signature {
+            static constexpr char value[sizeof...(Args) + 1] = { log_arg_t<Args>::code..., '\0' };
+        };
+
+        // Reads one stored argument and appends it as text. Returns false if
+        // the record is truncated.
+        inline bool append_log_arg(char code, std::string_view spec, const uint8*& p, const uint8* end, std::string& out) {
+            char text[64];
+            int length = 0;
+            const bool hex = spec.find('x') != std::string_view::npos;
+            if (code == 'i' || code == 'u' || code == 'd' || code == 'p') {
+                if (end - p < 8) return false;
+                uint64 bits;
+                std::memcpy(&bits, p, sizeof(bits));
+                bits = from_little_endian(bits);
+                p += 8;
+                if (code == 'd') {
+                    double value;
+                    std::memcpy(&value, &bits, sizeof(value));
+                    const size_t dot = spec.find('.');
+                    if (dot != std::string_view::npos) {
+                        length = std::snprintf(text, sizeof(text), "%.*f", static_cast<int>(std::strtol(spec.data() + dot + 1, nullptr, 10)), value);
+                    }
+                    else {
+                        length = std::snprintf(text, sizeof(text), "%g", value);
+                    }
+                }
+                else if (code == 'p' || hex) {
+                    length = std::snprintf(text, sizeof(text), code == 'p' ? "0x%llx" : "%llx", static_cast<unsigned long long>(bits));
+                }
+                else if (code == 'i') {
+                    length = std::snprintf(text, sizeof(text), "%lld", static_cast<long long>(static_cast<int64>(bits)));
+                }
+                else {
+                    length = std::snprintf(text, sizeof(text), "%llu", static_cast<unsigned long long>(bits));
+                }
+                // snprintf returns the untruncated length (e.g. "{:.80}" of a large double).
+                out.append(text, static_cast<size_t>(std::clamp<int>(length, 0, static_cast<int>(sizeof(text)) - 1)));
+                return true;
+            }
+            if (code == 'b' || code == 'c') {
+                if (end - p < 1) return false;
+                if (code == 'b') out += *p ? "true" : "false";
+                else out += static_cast<char>(*p);
+                p += 1;
+                return true;
+            }
+            if (code == 's') {
+                if (end - p < 4) return false;
+                uint32 size;
+                std::memcpy(&size, p, sizeof(size));
+                size = from_little_endian(size);
+                p += 4;
+                if (static_cast<size_t>(end - p) < size) return false;
+                out.append(reinterpret_cast<const char*>(p), size);
+                p += size;
+                return true;
+            }
+            return false;
+        }
+    } // namespace detail
+
+    // --- RiftLogRegistry ---
+    // Process-wide table of call sites. Ids start at 1 and never change.
+    class RiftLogRegistry {
+    public:
+        static RiftLogRegistry& Get() {
+            static RiftLogRegistry registry;
+            return registry;
+        }
+
+        uint32 Register(RiftLogSite& site, const char* signature) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            uint32 id = site.id.load(std::memory_order_relaxed);
+            if (id != 0) return id; // Another thread got here first
+            site.signature = signature;
+            m_sites.push_back(&site);
+            id = static_cast<uint32>(m_sites.size());
+            site.id.store(id, std::memory_order_release);
+            return id;
+        }
+
+        // nullptr for unknown ids. Takes a lock; callers cache the result.
+        const RiftLogSite* Find(uint32 id) const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return id > 0 && id <= m_sites.size() ? m_sites[id - 1] : nullptr;
+        }
+
+    private:
+        mutable std::mutex m_mutex;
+        std::deque<const RiftLogSite*> m_sites;
+    };
+
+    // --- RiftLogRecord ---
+    // A record handed to sinks (or produced by RiftBinaryLogDecoder). Points
+    // into the record object; valid only during the callback.
+    struct RiftLogRecord {
+        const RiftLogSite* site;
+        uint64 timestamp_ns;
+        uint32 thread_id;
+        const uint8* args;
+        size_t args_size;
+        const void* object; // The complete record object
+
+        RiftLogLevel GetLevel() const { return site->level; }
+
+        // Appends the formatted message.
+        void Format(std::string& out) const {
+            const char* signature = site->signature;
+            const uint8* p = args;
+            const uint8* end = args + args_size;
+            for (const char* f = site->format; *f; ++f) {
+                if ((f[0] == '{' && f[1] == '{') || (f[0] == '}' && f[1] == '}')) {
+                    out += *f++;
+                    continue;
+                }
+                const char* close = f[0] == '{' ? std::strchr(f, '}') : nullptr;
+                if (!close) {
+                    out += *f;
+                    continue;
+                }
+                const std::string_view placeholder(f, static_cast<size_t>(close - f + 1));
+                const std::string_view spec = placeholder.substr(1, placeholder.size() - 2);
+                if (!*signature || !detail::append_log_arg(*signature, spec, p, end, out)) {
+                    out.append(placeholder); // Missing or truncated argument
+                }
+                else {
+                    ++signature;
+                }
+                f = close;
+            }
+        }
+
+        // "2026-01-31 12:00:00.123456 [info] [T3] message"
+        void FormatLine(std::string& out) const {
+            const auto seconds = static_cast<std::time_t>(timestamp_ns / 1000000000);
+            std::tm local{};
+#ifdef _WIN32
+            localtime_s(&local, &seconds);
+#else
+            localtime_r(&seconds, &local);
+#endif
+            char prefix[96];
+            const size_t length = std::strftime(prefix, sizeof(prefix), "%Y-%m-%d %H:%M:%S", &local);
+            std::snprintf(prefix + length, sizeof(prefix) - length, ".%06u [%s] [T%u] ",
+                static_cast<uint32>(timestamp_ns % 1000000000 / 1000), rift_log_level_name(site->level), thread_id);
+            out += prefix;
+            Format(out);
+        }
+    };
+
+    // A sink receives every record on the logger's background thread, in the
+    // order the records were drained. flush may be null.
+    struct RiftLogSink {
+        void (*write)(void* context, const RiftLogRecord& record);
+        void (*flush)(void* context);
+        void* context;
+    };
+
+    struct RiftBinaryLoggerConfig {
+        size_t chunk_size = 64u << 10;         // Per-thread chunk; bounds the largest record
+        uint32 max_chunks_per_thread = 16;     // Records are dropped once all are in flight
+        uint32 flush_interval_ms = 50;
+        RiftLogLevel level = RiftLogLevel::Info;
+    };
+
+    // --- RiftBinaryLogger ---
+    class RiftBinaryLogger {
+    public:
+        explicit RiftBinaryLogger(const RiftBinaryLoggerConfig& config = RiftBinaryLoggerConfig())
+            : m_core(std::make_shared<Core>(config)), m_flush_interval_ms(config.flush_interval_ms) {
+            m_level.store(static_cast<uint8>(config.level), std::memory_order_relaxed);
+        }
+        ~RiftBinaryLogger() {
+            Stop();
+            m_core->closed.store(true, std::memory_order_relaxed);
+        }
+
+        RiftBinaryLogger(const RiftBinaryLogger&) = delete;
+        RiftBinaryLogger& operator=(const RiftBinaryLogger&) = delete;
+
+        // Logger used by the RIFT_BLOG_<LEVEL> shorthands. Has no sinks until
+        // the application adds some and calls Start().
+        static RiftBinaryLogger& GetDefault() {
+            static RiftBinaryLogger logger;
+            return logger;
+        }
+
+        // Sinks must be added before Start() and outlive the logger.
+        void AddSink(const RiftLogSink& sink) {
+            RIFT_ASSERT(!m_thread.joinable(), "Sinks must be added before Start.");
+            m_sinks.push_back(sink);
+        }
+
+        bool Start() {
+            if (m_thread.joinable()) return false;
+            m_running = true;
+            m_thread = std::thread([this] { Run(); });
+            return true;
+        }
+
+        // Delivers everything already published, then stops the background
+        // thread. Records still in other threads' unflushed chunks are not seen.
+        void Stop() {
+            if (!m_thread.joinable()) return;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_running = false;
+            }
+            m_wake.notify_all();
+            m_thread.join();
+        }
+
+        void SetLevel(RiftLogLevel level) { m_level.store(static_cast<uint8>(level), std::memory_order_relaxed); }
+        RiftLogLevel GetLevel() const { return static_cast<RiftLogLevel>(m_level.load(std::memory_order_relaxed)); }
+        bool ShouldLog(RiftLogLevel level) const { return static_cast<uint8>(level) >= m_level.load(std::memory_order_relaxed); }
+
+        // Records that were dropped: larger than a chunk, or every chunk of
+        // their thread was in flight.
+        uint64 GetDroppedCount() const { return m_core->dropped.load(std::memory_order_relaxed); }
+
+        // Hot path (use RIFT_BLOG rather than calling this directly).
+        template<typename... Args>
+        void Log(RiftLogSite& site, const Args&... args) {
+            if (!ShouldLog(site.level)) return;
+            uint32 id = site.id.load(std::memory_order_acquire);
+            if (id == 0) id = RiftLogRegistry::Get().Register(site, detail::log_signature<Args...>::value);
+
+            ThreadState& state = GetThreadState();
+            const size_t size = align_up(sizeof(RiftLogRecordHeader) + (size_t(0) + ... + detail::log_arg_t<Args>::size(args)), alignof(RiftObjectHeader));
+            // A record must fit in one chunk (e.g. a string argument longer than chunk_size).
+            RiftSpanBuilder* builder = size <= m_core->queue.GetConfig().chunk_size ? state.producer->BeginEvent(size) : nullptr;
+            if (!builder) {
+                m_core->dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            const size_t start = builder->BeginObject();
+            RiftLogRecordHeader header{};
+            header.timestamp_ns = to_little_endian(static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count()));
+            header.site_id = to_little_endian(id);
+            header.thread_id = to_little_endian(state.thread_id);
+            builder->WriteRaw(&header, sizeof(header));
+            (detail::log_arg_t<Args>::write(*builder, args), ...);
+            builder->EndObject(start, RIFT_LOG_RECORD_SCHEMA_ID);
+            if (!state.producer->Commit()) {
+                m_core->dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            const uint64 epoch = m_core->flush_epoch.load(std::memory_order_relaxed);
+            if (site.level >= RiftLogLevel::Warn || epoch != state.flush_epoch) {
+                state.flush_epoch = epoch;
+                state.producer->Flush();
+            }
+        }
+
+        // Publishes the calling thread's pending records (e.g. at frame end).
+        void FlushThread() { GetThreadState().producer->Flush(); }
+
+    private:
+        // Shared with the thread-local producers so that the queue outlives
+        // every producer, even one whose thread exits after the logger.
+        struct Core {
+            explicit Core(const RiftBinaryLoggerConfig& config) : queue(RiftEventQueueConfig{ config.chunk_size, config.max_chunks_per_thread }) {}
+            RiftEventQueue queue;
+            std::atomic<uint64> dropped{ 0 };
+            std::atomic<bool> closed{ false }; // The logger is gone; threads drop their state for it lazily
+            alignas(RIFT_CACHE_LINE_SIZE) std::atomic<uint64> flush_epoch{ 0 };
+        };
+
+        struct ThreadState {
+            std::shared_ptr<Core> core; // Declared first: the producer must be destroyed before the queue
+            std::unique_ptr<RiftEventProducer> producer;
+            uint64 flush_epoch = 0;
+            uint32 thread_id = 0;
+        };
+
+        // Each thread keeps one state per logger it has used, so alternating
+        // between loggers does not recreate producers. There are rarely more
+        // than a few, so a list with a last-used shortcut is enough.
+        ThreadState& GetThreadState() {
+            static std::atomic<uint32> next_thread_id{ 0 };
+            thread_local const uint32 thread_id = next_thread_id.fetch_add(1, std::memory_order_relaxed) + 1;
+            thread_local std::vector<std::unique_ptr<ThreadState>> states;
+            thread_local ThreadState* last = nullptr;
+            if (last && last->core == m_core) return *last;
+
+            for (const auto& state : states) {
+                if (state->core == m_core) return *(last = state.get());
+            }
+            states.erase(std::remove_if(states.begin(), states.end(),
+                [](const std::unique_ptr<ThreadState>& state) { return state->core->closed.load(std::memory_order_relaxed); }), states.end());
+            auto state = std::make_unique<ThreadState>();
+            state->core = m_core;
+            state->producer = std::make_unique<RiftEventProducer>(m_core->queue);
+            state->thread_id = thread_id;
+            last = state.get();
+            states.push_back(std::move(state));
+            return *last;
+        }
+
+        void Run() {
+            std::vector<const RiftLogSite*> sites; // Cache of the registry, indexed by id - 1
+            const auto deliver = [&](const RiftBufferViewBase& view) {
+                if (view.GetSchemaId() != RIFT_LOG_RECORD_SCHEMA_ID || view.GetTotalSize() < sizeof(RiftLogRecordHeader)) return;
+                const auto* header = reinterpret_cast<const RiftLogRecordHeader*>(view.GetBufferStart());
+                const uint32 id = from_little_endian(header->site_id);
+                while (sites.size() < id) {
+                    const RiftLogSite* site = RiftLogRegistry::Get().Find(static_cast<uint32>(sites.size() + 1));
+                    if (!site) return;
+                    sites.push_back(site);
+                }
+                if (id == 0) return;
+                const RiftLogRecord record{ sites[id - 1], from_little_endian(header->timestamp_ns), from_little_endian(header->thread_id),
+                    view.GetBufferStart() + sizeof(RiftLogRecordHeader), view.GetTotalSize() - sizeof(RiftLogRecordHeader), view.GetBufferStart() };
+                for (const RiftLogSink& sink : m_sinks) sink.write(sink.context, record);
+            };
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            for (;;) {
+                const bool running = m_running;
+                lock.unlock();
+                m_core->flush_epoch.fetch_add(1, std::memory_order_relaxed);
+                if (m_core->queue.Drain(deliver) > 0) {
+                    for (const RiftLogSink& sink : m_sinks) {
+                        if (sink.flush) sink.flush(sink.context);
+                    }
+                }
+                lock.lock();
+                if (!running) return;
+                m_wake.wait_for(lock, std::chrono::milliseconds(m_flush_interval_ms), [&] { return !m_running; });
+            }
+        }
+
+        std::shared_ptr<Core> m_core;
+        std::atomic<uint8> m_level{ 0 };
+        uint32 m_flush_interval_ms;
+        std::vector<RiftLogSink> m_sinks;
+        std::thread m_thread;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        bool m_running = false;
+    };
+
+    // --- RiftTextLogSink ---
+    // Writes formatted lines to a FILE* (stderr, a text file).
+    class RiftTextLogSink {
+    public:
+        explicit RiftTextLogSink(std::FILE* file, RiftLogLevel level = RiftLogLevel::Trace) : m_file(file), m_level(level) {}
+
+        RiftLogSink GetSink() {
+            return { [](void* context, const RiftLogRecord& record) { static_cast<RiftTextLogSink*>(context)->Write(record); },
+                [](void* context) { std::fflush(static_cast<RiftTextLogSink*>(context)->m_file); }, this };
+        }
+
+        void Write(const RiftLogRecord& record) {
+            if (record.GetLevel() < m_level) return;
+            m_line.clear();
+            record.FormatLine(m_line);
+            m_line += '\n';
+            std::fwrite(m_line.data(), 1, m_line.size(), m_file);
+        }
+
+    private:
+        std::FILE* m_file;
+        RiftLogLevel m_level;
+        std::string m_line;
+    };
+
+    // --- RiftBinaryLogFileSink ---
+    // Stores records unformatted in a RiftLog file (see LogWriter.h). Each
+    // call site's definition is written before its first record, so the file
+    // can be decoded offline with RiftBinaryLogDecoder.
+    class RiftBinaryLogFileSink {
+    public:
+        explicit RiftBinaryLogFileSink(const RiftLogWriterConfig& config = RiftLogWriterConfig()) : m_log(config) {}
+
+        bool Open(const char* path) {
+            m_written.clear();
+            return m_log.Open(path);
+        }
+        void Close() { m_log.Close(); }
+
+        RiftLogSink GetSink() {
+            return { [](void* context, const RiftLogRecord& record) { static_cast<RiftBinaryLogFileSink*>(context)->Write(record); }, nullptr, this };
+        }
+
+        // Records the log writer could not queue.
+        uint64 GetDroppedCount() const { return m_dropped; }
+
+        void Write(const RiftLogRecord& record) {
+            const uint32 id = record.site->id.load(std::memory_order_relaxed);
+            if (id >= m_written.size()) m_written.resize(id + 1, false);
+            if (!m_written[id]) {
+                m_written[id] = WriteSite(*record.site, id);
+            }
+            if (!m_log.Append(record.object, RiftBufferViewBase(record.object).GetTotalSize())) ++m_dropped;
+        }
+
+    private:
+        bool WriteSite(const RiftLogSite& site, uint32 id) {
+            m_staging.Reset();
+            const size_t start = m_staging.BeginObject();
+            RiftLogFormatHeader header{};
+            header.site_id = to_little_endian(id);
+            header.line = to_little_endian(site.line);
+            header.level = to_little_endian(static_cast<uint32>(site.level));
+            m_staging.WriteRaw(&header, sizeof(header));
+            for (const char* text : { site.format, site.file, site.signature }) {
+                m_staging.WriteRaw(text, std::strlen(text) + 1);
+            }
+            m_staging.EndObject(start, RIFT_LOG_FORMAT_SCHEMA_ID);
+            return m_log.Append(m_staging.GetBufferPointer(), m_staging.GetCurrentSize());
+        }
+
+        RiftLogWriter m_log;
+        RiftBufferBuilder m_staging{ 1024 };
+        std::vector<bool> m_written; // Site ids already defined in the file
+        uint64 m_dropped = 0;
+    };
+
+    // --- RiftBinaryLogDecoder ---
+    // Offline reader for files written by RiftBinaryLogFileSink.
+    class RiftBinaryLogDecoder {
+    public:
+        bool Open(const char* path) {
+            m_sites.clear();
+            m_strings.clear();
+            m_by_id.clear();
+            return m_log.Open(path);
+        }
+
+        // Calls on_record(const RiftLogRecord&) for every record, in file
+        // order. Returns the number of records; records whose call site is
+        // not defined in the file are skipped.
+        template<typename Callback>
+        uint64 ForEachRecord(Callback&& on_record) {
+            uint64 count = 0;
+            m_log.Seek(sizeof(RiftLogFileHeader));
+            while (const void* object = m_log.Next()) {
+                const RiftBufferViewBase view(object);
+                if (view.GetSchemaId() == RIFT_LOG_FORMAT_SCHEMA_ID) {
+                    DefineSite(view);
+                }
+                else if (view.GetSchemaId() == RIFT_LOG_RECORD_SCHEMA_ID && view.GetTotalSize() >= sizeof(RiftLogRecordHeader)) {
+                    const auto* header = static_cast<const RiftLogRecordHeader*>(object);
+                    const uint32 id = from_little_endian(header->site_id);
+                    if (id >= m_by_id.size() || !m_by_id[id]) continue;
+                    on_record(RiftLogRecord{ m_by_id[id], from_little_endian(header->timestamp_ns), from_little_endian(header->thread_id),
+                        view.GetBufferStart() + sizeof(RiftLogRecordHeader), view.GetTotalSize() - sizeof(RiftLogRecordHeader), object });
+                    ++count;
+                }
+            }
+            return count;
+        }
+
+    private:
+        void DefineSite(const RiftBufferViewBase& view) {
+            if (view.GetTotalSize() < sizeof(RiftLogFormatHeader)) return;
+            const auto* header = reinterpret_cast<const RiftLogFormatHeader*>(view.GetBufferStart());
+            // Ids are the writer's registry ids, so a file may skip some, but
+            // never by more than RIFT_LOG_MAX_SITE_ID_GAP; a corrupt id must not size m_by_id.
+            const uint32 id = from_little_endian(header->site_id);
+            if (id == 0 || id - 1 > m_sites.size() + RIFT_LOG_MAX_SITE_ID_GAP) return;
+            const char* text = reinterpret_cast<const char*>(view.GetBufferStart() + sizeof(RiftLogFormatHeader));
+            const char* end = reinterpret_cast<const char*>(view.GetBufferStart() + view.GetTotalSize());
+            const char* strings[3];
+            for (const char*& string : strings) {
+                const char* terminator = std::find(text, end, '\0');
+                if (terminator == end) return;
+                m_strings.emplace_back(text, terminator);
+                string = m_strings.back().c_str();
+                text = terminator + 1;
+            }
+            const auto level = static_cast<RiftLogLevel>(std::min<uint32>(from_little_endian(header->level), static_cast<uint32>(RiftLogLevel::Off)));
+            m_sites.emplace_back(level, strings[0], strings[1], from_little_endian(header->line));
+            m_sites.back().signature = strings[2];
+            m_sites.back().id.store(id, std::memory_order_relaxed);
+            if (id >= m_by_id.size()) m_by_id.resize(id + 1, nullptr);
+            m_by_id[id] = &m_sites.back();
+        }
+
+        RiftLogReader m_log;
+        std::deque<RiftLogSite> m_sites;
+        std::deque<std::string> m_strings;
+        std::vector<const RiftLogSite*> m_by_id;
+    };
+
+} // namespace RiftSerializer
+
+// Logs through the given RiftBinaryLogger. Arguments are only evaluated when
+// the level is enabled.
+#define RIFT_BLOG(logger, level, format, ...) \
+    do { \
+        static ::RiftSerializer::RiftLogSite rift_log_site_(level, format, __FILE__, __LINE__); \
+        if ((logger).ShouldLog(level)) (logger).Log(rift_log_site_, ##__VA_ARGS__); \
+    } while (0)
+
+#define RIFT_BLOG_TRACE(format, ...) RIFT_BLOG(::RiftSerializer::RiftBinaryLogger::GetDefault(), ::RiftSerializer::RiftLogLevel::Trace, format, ##__VA_ARGS__)
+#define RIFT_BLOG_DEBUG(format, ...) RIFT_BLOG(::RiftSerializer::RiftBinaryLogger::GetDefault(), ::RiftSerializer::RiftLogLevel::Debug, format, ##__VA_ARGS__)
+#define RIFT_BLOG_INFO(format, ...) RIFT_BLOG(::RiftSerializer::RiftBinaryLogger::GetDefault(), ::RiftSerializer::RiftLogLevel::Info, format, ##__VA_ARGS__)
+#define RIFT_BLOG_WARN(format, ...) RIFT_BLOG(::RiftSerializer::RiftBinaryLogger::GetDefault(), ::RiftSerializer::RiftLogLevel::Warn, format, ##__VA_ARGS__)
+#define RIFT_BLOG_ERROR(format, ...) RIFT_BLOG(::RiftSerializer::RiftBinaryLogger::GetDefault(), ::RiftSerializer::RiftLogLevel::Error, format, ##__VA_ARGS__)
+#define RIFT_BLOG_CRITICAL(format, ...) RIFT_BLOG(::RiftSerializer::RiftBinaryLogger::GetDefault(), ::RiftSerializer::RiftLogLevel::Critical, format, ##__VA_ARGS__)
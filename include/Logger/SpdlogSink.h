@@ -0,0 +1,55 @@
+﻿// RiftSerializer/include/RiftSerializer/SpdlogSink.h
+//
+// Forwards binary log records to an spdlog logger, so existing spdlog sinks
+// (console, rotating files) produce the human-readable output. Formatting
+// happens on the RiftBinaryLogger background thread; the record's original
+// timestamp and call site are kept.
+//
+// Only this header depends on spdlog.
+
+#pragma once
+
+#include "Logger.h"
+#include "../Common/SpdlogDiagnostics.h"
+
+namespace RiftSerializer {
+
+    inline spdlog::level::level_enum rift_to_spdlog_level(RiftLogLevel level) {
+        switch (level) {
+        case RiftLogLevel::Trace: return spdlog::level::trace;
+        case RiftLogLevel::Debug: return spdlog::level::debug;
+        case RiftLogLevel::Info: return spdlog::level::info;
+        case RiftLogLevel::Warn: return spdlog::level::warn;
+        case RiftLogLevel::Error: return spdlog::level::err;
+        case RiftLogLevel::Critical: return spdlog::level::critical;
+        default: return spdlog::level::off;
+        }
+    }
+
+    // --- RiftSpdlogSink ---
+    class RiftSpdlogSink {
+    public:
+        // The logger must outlive the sink.
+        explicit RiftSpdlogSink(std::shared_ptr<spdlog::logger> logger) : m_logger(std::move(logger)) {}
+
+        RiftLogSink GetSink() {
+            return { [](void* context, const RiftLogRecord& record) { static_cast<RiftSpdlogSink*>(context)->Write(record); },
+                [](void* context) { static_cast<RiftSpdlogSink*>(context)->m_logger->flush(); }, this };
+        }
+
+        void Write(const RiftLogRecord& record) {
+            const spdlog::level::level_enum level = rift_to_spdlog_level(record.GetLevel());
+            if (!m_logger->should_log(level)) return;
+            m_message.clear();
+            record.Format(m_message);
+            const auto time = spdlog::log_clock::time_point(std::chrono::duration_cast<spdlog::log_clock::duration>(
+                std::chrono::nanoseconds(record.timestamp_ns)));
+            m_logger->log(time, spdlog::source_loc{ record.site->file, static_cast<int>(record.site->line), "" }, level, m_message);
+        }
+
+    private:
+        std::shared_ptr<spdlog::logger> m_logger;
+        std::string m_message;
+    };
+
+} // namespace RiftSerializer
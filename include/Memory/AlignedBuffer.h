@@ -0,0 +1,65 @@
+﻿// RiftSerializer/include/RiftSerializer/AlignedBuffer.h
+#pragma once
+
+#include "../Common/Common.h"
+#include <new>
+
+namespace RiftSerializer {
+
+    // --- RiftAlignedBuffer ---
+    // A fixed-size, move-only heap buffer with a caller-chosen alignment
+    // (e.g. 8 for RiftObjects, 4096 for direct I/O). Never reallocates.
+    class RiftAlignedBuffer {
+    public:
+        RiftAlignedBuffer() = default;
+        RiftAlignedBuffer(size_t size, size_t alignment) { Allocate(size, alignment); }
+        ~RiftAlignedBuffer() { Free(); }
+        RiftAlignedBuffer(const RiftAlignedBuffer&) = delete;
+        RiftAlignedBuffer& operator=(const RiftAlignedBuffer&) = delete;
+        RiftAlignedBuffer(RiftAlignedBuffer&& other) noexcept
+            : m_data(other.m_data), m_size(other.m_size), m_alignment(other.m_alignment) {
+            other.m_data = nullptr;
+            other.m_size = 0;
+        }
+        RiftAlignedBuffer& operator=(RiftAlignedBuffer&& other) noexcept {
+            if (this != &other) {
+                Free();
+                m_data = other.m_data;
+                m_size = other.m_size;
+                m_alignment = other.m_alignment;
+                other.m_data = nullptr;
+                other.m_size = 0;
+            }
+            return *this;
+        }
+
+        // Zero-filled on allocation.
+        void Allocate(size_t size, size_t alignment) {
+            RIFT_ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of two.");
+            Free();
+            if (size == 0) return;
+            m_data = static_cast<uint8*>(::operator new(size, std::align_val_t(alignment)));
+            std::memset(m_data, 0, size);
+            m_size = size;
+            m_alignment = alignment;
+        }
+
+        void Free() {
+            if (!m_data) return;
+            ::operator delete(m_data, std::align_val_t(m_alignment));
+            m_data = nullptr;
+            m_size = 0;
+        }
+
+        uint8* GetData() { return m_data; }
+        const uint8* GetData() const { return m_data; }
+        size_t GetSize() const { return m_size; }
+        size_t GetAlignment() const { return m_alignment; }
+
+    private:
+        uint8* m_data = nullptr;
+        size_t m_size = 0;
+        size_t m_alignment = 1;
+    };
+
+} // namespace RiftSerializer
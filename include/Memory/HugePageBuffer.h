@@ -0,0 +1,108 @@
+﻿// RiftSerializer/include/RiftSerializer/HugePageBuffer.h
+#pragma once
+
+#include "../Common/Common.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace RiftSerializer {
+
+    // --- RiftHugePageBuffer ---
+    // A large, page-aligned, move-only buffer backed by huge pages when the OS
+    // provides them (explicit huge pages first, then transparent huge pages on
+    // Linux, large pages on Windows), and by regular pages otherwise.
+    class RiftHugePageBuffer {
+    public:
+        static constexpr size_t HUGE_PAGE_SIZE = 2u << 20;
+
+        RiftHugePageBuffer() = default;
+        explicit RiftHugePageBuffer(size_t size) { Allocate(size); }
+        ~RiftHugePageBuffer() { Free(); }
+        RiftHugePageBuffer(const RiftHugePageBuffer&) = delete;
+        RiftHugePageBuffer& operator=(const RiftHugePageBuffer&) = delete;
+        RiftHugePageBuffer(RiftHugePageBuffer&& other) noexcept
+            : m_data(other.m_data), m_size(other.m_size), m_mapped_size(other.m_mapped_size), m_huge(other.m_huge) {
+            other.m_data = nullptr;
+            other.m_size = other.m_mapped_size = 0;
+        }
+        RiftHugePageBuffer& operator=(RiftHugePageBuffer&& other) noexcept {
+            if (this != &other) {
+                Free();
+                m_data = other.m_data;
+                m_size = other.m_size;
+                m_mapped_size = other.m_mapped_size;
+                m_huge = other.m_huge;
+                other.m_data = nullptr;
+                other.m_size = other.m_mapped_size = 0;
+            }
+            return *this;
+        }
+
+        bool Allocate(size_t size) {
+            Free();
+            if (size == 0) return false;
+            const size_t rounded = align_up(size, HUGE_PAGE_SIZE);
+#ifdef _WIN32
+            const SIZE_T large_page = GetLargePageMinimum();
+            if (large_page != 0) {
+                m_data = static_cast<uint8*>(VirtualAlloc(nullptr, align_up(size, large_page), MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE));
+                m_huge = m_data != nullptr;
+            }
+            if (!m_data) m_data = static_cast<uint8*>(VirtualAlloc(nullptr, rounded, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+#else
+            void* data = MAP_FAILED;
+#ifdef MAP_HUGETLB
+            data = ::mmap(nullptr, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            m_huge = data != MAP_FAILED;
+#endif
+            if (data == MAP_FAILED) {
+                data = ::mmap(nullptr, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (data == MAP_FAILED) return false;
+#ifdef MADV_HUGEPAGE
+                ::madvise(data, rounded, MADV_HUGEPAGE);
+#endif
+            }
+            m_data = static_cast<uint8*>(data);
+#endif
+            if (!m_data) return false;
+            m_size = size;
+            m_mapped_size = rounded;
+            return true;
+        }
+
+        void Free() {
+            if (!m_data) return;
+#ifdef _WIN32
+            VirtualFree(m_data, 0, MEM_RELEASE);
+#else
+            ::munmap(m_data, m_mapped_size);
+#endif
+            m_data = nullptr;
+            m_size = m_mapped_size = 0;
+            m_huge = false;
+        }
+
+        uint8* GetData() { return m_data; }
+        const uint8* GetData() const { return m_data; }
+        size_t GetSize() const { return m_size; }
+        // True if explicit huge/large pages were obtained (transparent huge pages are not reported).
+        bool IsHugePageBacked() const { return m_huge; }
+
+    private:
+        uint8* m_data = nullptr;
+        size_t m_size = 0;
+        size_t m_mapped_size = 0;
+        bool m_huge = false;
+    };
+
+} // namespace RiftSerializer
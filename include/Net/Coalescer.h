@@ -0,0 +1,178 @@
+﻿// RiftSerializer/include/RiftSerializer/Coalescer.h
+//
+// Packs many small finished RiftObjects (DebugEvent, DebugLine, ...) into
+// shared datagrams instead of sending one datagram per object.
+//
+// Packet layout:
+//   [RiftPacketHeader (8 bytes)][object 0][pad to 8][object 1][pad to 8]...
+//
+// Objects keep their 8-byte alignment inside the packet, so a receiver that
+// reads datagrams into 8-byte aligned buffers can view every object in place.
+
+#pragma once
+
+#include "Socket.h"
+#include "../Accessor/Accessor.h"
+#include "../Memory/AlignedBuffer.h"
+#include <chrono>
+#include <vector>
+
+namespace RiftSerializer {
+
+    // 'RFP1' in Little Endian (version 1)
+    constexpr uint32 RIFT_PACKET_MAGIC_NUMBER = 0x31504652;
+
+    struct alignas(8) RiftPacketHeader {
+        uint32 magic;        // 'RFP1'
+        uint16 object_count;
+        uint16 flags;        // Reserved
+    };
+    static_assert(sizeof(RiftPacketHeader) == 8, "RiftPacketHeader must be 8 bytes.");
+
+    struct RiftCoalescerConfig {
+        size_t packet_budget = 1200; // Maximum datagram size, header included
+        uint32 max_delay_us = 1000;  // Oldest pending object is sent at most this late (checked by Poll())
+        uint32 max_packets = 32;     // Full packets buffered before they are sent in one batch
+    };
+
+    struct RiftCoalescerStats {
+        uint64 objects;
+        uint64 packets;
+        uint64 send_calls;
+        uint64 dropped_packets; // The socket refused them (e.g. would block)
+    };
+
+    // --- RiftCoalescer ---
+    // Not thread-safe; owned by the thread that sends on the socket.
+    class RiftCoalescer {
+    public:
+        explicit RiftCoalescer(RiftUdpSocket& socket, const RiftCoalescerConfig& config = RiftCoalescerConfig())
+            : m_socket(socket), m_config(config),
+            m_stride(align_up(config.packet_budget, alignof(RiftObjectHeader))),
+            m_packets(m_stride * std::max<uint32>(config.max_packets, 1), alignof(RiftObjectHeader)),
+            m_sizes(std::max<uint32>(config.max_packets, 1)),
+            m_slices(m_sizes.size()),
+            m_datagrams(m_sizes.size()) {
+            RIFT_ASSERT(config.packet_budget > sizeof(RiftPacketHeader) + sizeof(RiftObjectHeader), "Packet budget is too small.");
+        }
+        ~RiftCoalescer() { Flush(); }
+
+        // Largest object that fits in a packet on its own.
+        size_t GetMaxObjectSize() const { return m_config.packet_budget - sizeof(RiftPacketHeader); }
+
+        // Copies one finished object into the current packet. Returns false
+        // if the object is larger than GetMaxObjectSize().
+        bool Add(const void* object) {
+            const uint32 size = RiftBufferViewBase(object).GetTotalSize();
+            if (size > GetMaxObjectSize()) return false;
+
+            size_t offset = align_up(m_sizes[m_current], alignof(RiftObjectHeader));
+            if (m_sizes[m_current] != 0 && offset + size > m_config.packet_budget) {
+                if (m_current + 1 == m_sizes.size()) Flush();
+                else ++m_current;
+                offset = 0;
+            }
+            uint8* packet = m_packets.GetData() + m_current * m_stride;
+            if (offset == 0) {
+                if (m_current == 0) m_oldest = Clock::now();
+                offset = sizeof(RiftPacketHeader);
+                std::memset(packet, 0, sizeof(RiftPacketHeader));
+            }
+            std::memcpy(packet + offset, object, size);
+            std::memset(packet + offset + size, 0, align_up(size, alignof(RiftObjectHeader)) - size);
+            m_sizes[m_current] = offset + size;
+            ++reinterpret_cast<RiftPacketHeader*>(packet)->object_count;
+            ++m_stats.objects;
+            return true;
+        }
+
+        // Sends every pending packet, full or not, in one batch. Returns the number sent.
+        uint32 Flush() {
+            const uint32 count = static_cast<uint32>(m_sizes[m_current] != 0 ? m_current + 1 : m_current);
+            if (count == 0) return 0;
+            for (uint32 i = 0; i < count; ++i) {
+                auto* header = reinterpret_cast<RiftPacketHeader*>(m_packets.GetData() + i * m_stride);
+                header->magic = to_little_endian(RIFT_PACKET_MAGIC_NUMBER);
+                header->object_count = to_little_endian(header->object_count);
+                m_slices[i] = { header, m_sizes[i] };
+                m_datagrams[i] = { &m_slices[i], 1, static_cast<uint32>(m_sizes[i]) };
+                m_sizes[i] = 0;
+            }
+            const uint32 sent = m_socket.SendBatch(m_datagrams.data(), count);
+            m_stats.packets += sent;
+            m_stats.dropped_packets += count - sent;
+            ++m_stats.send_calls;
+            m_current = 0;
+            return sent;
+        }
+
+        // Flushes if the oldest pending object has waited max_delay_us. Call
+        // this from the network loop at least that often.
+        uint32 Poll() {
+            if (m_sizes[0] == 0 || Clock::now() - m_oldest < std::chrono::microseconds(m_config.max_delay_us)) return 0;
+            return Flush();
+        }
+
+        bool HasPending() const { return m_sizes[0] != 0; }
+        const RiftCoalescerStats& GetStats() const { return m_stats; }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        RiftUdpSocket& m_socket;
+        RiftCoalescerConfig m_config;
+        size_t m_stride;
+        RiftAlignedBuffer m_packets;
+        std::vector<size_t> m_sizes; // Bytes used per packet; 0 = empty
+        std::vector<RiftIoSlice> m_slices;
+        std::vector<RiftDatagram> m_datagrams;
+        size_t m_current = 0;
+        Clock::time_point m_oldest;
+        RiftCoalescerStats m_stats{};
+    };
+
+    // --- RiftCoalescedPacket ---
+    // Zero-copy view of a received packet. The datagram must have been
+    // received into an 8-byte aligned buffer.
+    class RiftCoalescedPacket {
+    public:
+        RiftCoalescedPacket(const void* data, size_t size)
+            : m_data(static_cast<const uint8*>(data)), m_size(size) {
+        }
+
+        bool IsValid() const {
+            return m_size >= sizeof(RiftPacketHeader) && is_aligned(m_data, alignof(RiftObjectHeader)) &&
+                from_little_endian(Header()->magic) == RIFT_PACKET_MAGIC_NUMBER;
+        }
+
+        uint32 GetObjectCount() const { return from_little_endian(Header()->object_count); }
+
+        // Calls visitor(const RiftBufferViewBase&) for every object, in send
+        // order. Returns false if the packet is invalid or an object is
+        // truncated or malformed; objects before that point were still visited.
+        template<typename Visitor>
+        bool ForEachObject(Visitor&& visitor) const {
+            if (!IsValid()) return false;
+            size_t offset = sizeof(RiftPacketHeader);
+            for (uint32 i = 0; i < GetObjectCount(); ++i) {
+                if (offset + sizeof(RiftObjectHeader) > m_size) return false;
+                const auto* header = reinterpret_cast<const RiftObjectHeader*>(m_data + offset);
+                const uint32 size = from_little_endian(header->total_size);
+                if (from_little_endian(header->magic) != RIFT_MAGIC_NUMBER || size < sizeof(RiftObjectHeader) || offset + size > m_size) {
+                    return false;
+                }
+                const RiftBufferViewBase view(header);
+                visitor(view);
+                offset = align_up(offset + size, alignof(RiftObjectHeader));
+            }
+            return true;
+        }
+
+    private:
+        const RiftPacketHeader* Header() const { return reinterpret_cast<const RiftPacketHeader*>(m_data); }
+
+        const uint8* m_data;
+        size_t m_size;
+    };
+
+} // namespace RiftSerializer
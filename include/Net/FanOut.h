@@ -0,0 +1,182 @@
+﻿// RiftSerializer/include/RiftSerializer/FanOut.h
+//
+// Serialize once, send to many. Each tick every entity is serialized exactly
+// once into a shared RiftFanOutPool. Per-client packets are then gather lists
+// that reference those blocks behind a small per-client header, so
+// serialization cost scales with the entity count, not entities x clients.
+//
+// Packet layout (readable with RiftCoalescedPacket):
+//   [RiftPacketHeader][RiftFanOutHeader object][entity object][pad]...
+
+#pragma once
+
+#include "Coalescer.h"
+#include "../Builder/Builder.h"
+#include <vector>
+
+namespace RiftSerializer {
+
+    // Reserved schema id of the per-client header object.
+    constexpr uint32 RIFT_FANOUT_HEADER_SCHEMA_ID = 0xFFFF0010;
+
+    // First object of every fan-out packet.
+    struct alignas(8) RiftFanOutHeader {
+        RiftObjectHeader object; // schema_id = RIFT_FANOUT_HEADER_SCHEMA_ID
+        uint64 tick;
+        uint32 client_id;
+        uint16 packet_index;     // Position of this packet within the client's tick
+        uint16 packet_count;
+    };
+    static_assert(sizeof(RiftFanOutHeader) == 32, "RiftFanOutHeader must be 32 bytes.");
+
+    // --- RiftFanOutPool ---
+    // The tick's shared, serialized blocks. Blocks are identified by the id
+    // returned from Add*() and stay valid until the next BeginTick().
+    class RiftFanOutPool {
+    public:
+        explicit RiftFanOutPool(size_t initial_capacity = 1u << 20) : m_builder(initial_capacity) {}
+
+        void BeginTick() {
+            m_builder.Reset();
+            m_blocks.clear();
+            m_flat_size = 0;
+        }
+
+        // Build one object into the builder, then pass its start offset to AddBuilt().
+        RiftBufferBuilder& GetBuilder() { return m_builder; }
+
+        uint32 AddBuilt(size_t object_start) {
+            m_builder.PadToAlignment(alignof(RiftObjectHeader));
+            m_blocks.push_back({ object_start, m_builder.GetCurrentSize() - object_start });
+            return static_cast<uint32>(m_blocks.size() - 1);
+        }
+
+        // Copies an already finished object into the pool.
+        uint32 AddObject(const void* object) {
+            const size_t start = m_builder.BeginObject();
+            m_builder.WriteRaw(object, RiftBufferViewBase(object).GetTotalSize());
+            return AddBuilt(start);
+        }
+
+        uint32 GetBlockCount() const { return static_cast<uint32>(m_blocks.size()); }
+        // Size including padding to 8 bytes.
+        size_t GetBlockSize(uint32 id) const { return m_blocks[id].size; }
+        // Valid until the pool is next modified. If blocks were built with
+        // AddArrayRef(), the pool is flattened into one copy on first access.
+        const uint8* GetBlockData(uint32 id) const {
+            if (!m_builder.HasExternalBlobs()) return m_builder.GetBufferPointer() + m_blocks[id].offset;
+            if (m_flat_size != m_builder.GetCurrentSize()) {
+                m_flat.resize(m_builder.GetCurrentSize());
+                m_builder.Flatten(m_flat.data());
+                m_flat_size = m_flat.size();
+            }
+            return m_flat.data() + m_blocks[id].offset;
+        }
+
+    private:
+        struct Block {
+            size_t offset;
+            size_t size;
+        };
+
+        RiftBufferBuilder m_builder;
+        std::vector<Block> m_blocks;
+        mutable std::vector<uint8> m_flat; // Flattened m_builder when it holds external blobs
+        mutable size_t m_flat_size = 0;    // Stream size m_flat was taken at; 0 = stale
+    };
+
+    // --- RiftFanOutAssembler ---
+    // Builds one client's datagrams for a tick. Nothing from the pool is
+    // copied; only the per-packet headers are written. Reuse one assembler
+    // for all clients so its buffers stop growing after the first ticks.
+    class RiftFanOutAssembler {
+    public:
+        explicit RiftFanOutAssembler(size_t packet_budget = 1200) : m_packet_budget(packet_budget) {
+            RIFT_ASSERT(packet_budget > sizeof(PacketHeader), "Packet budget is too small.");
+        }
+
+        // Splits the given blocks into as few datagrams as fit the budget, in
+        // order. Blocks larger than a packet are skipped (see GetSkippedCount()).
+        // Returns the number of datagrams; they reference the pool and stay
+        // valid until the next Assemble() or pool change.
+        uint32 Assemble(const RiftFanOutPool& pool, uint64 tick, uint32 client_id, const uint32* block_ids, size_t count) {
+            m_headers.clear();
+            m_slices.clear();
+            m_datagrams.clear();
+            m_skipped = 0;
+
+            // Headers first, so the pointers taken below stay stable.
+            const size_t room = m_packet_budget - sizeof(PacketHeader);
+            size_t packets = 0;
+            size_t fill = room;
+            for (size_t i = 0; i < count; ++i) {
+                const size_t size = pool.GetBlockSize(block_ids[i]);
+                if (size > room) continue;
+                if (fill + size > room) {
+                    ++packets;
+                    fill = 0;
+                }
+                fill += size;
+            }
+            if (packets == 0) packets = 1; // An empty update still tells the client the tick happened.
+            m_headers.resize(packets);
+            m_slices.reserve(packets + count);
+
+            size_t packet = 0;
+            fill = 0;
+            StartPacket(0, tick, client_id, packets);
+            for (size_t i = 0; i < count; ++i) {
+                const size_t size = pool.GetBlockSize(block_ids[i]);
+                if (size > room) {
+                    ++m_skipped;
+                    continue;
+                }
+                if (fill + size > room) {
+                    StartPacket(++packet, tick, client_id, packets);
+                    fill = 0;
+                }
+                m_slices.push_back({ pool.GetBlockData(block_ids[i]), size });
+                ++m_datagrams.back().slice_count;
+                m_datagrams.back().size += static_cast<uint32>(size);
+                ++m_headers[packet].packet.object_count;
+                fill += size;
+            }
+            for (PacketHeader& header : m_headers) header.packet.object_count = to_little_endian(header.packet.object_count);
+            return static_cast<uint32>(m_datagrams.size());
+        }
+
+        uint32 GetDatagramCount() const { return static_cast<uint32>(m_datagrams.size()); }
+        const RiftDatagram* GetDatagrams() const { return m_datagrams.data(); }
+        uint32 GetSkippedCount() const { return m_skipped; }
+
+    private:
+        struct PacketHeader {
+            RiftPacketHeader packet;
+            RiftFanOutHeader client;
+        };
+
+        void StartPacket(size_t index, uint64 tick, uint32 client_id, size_t packets) {
+            PacketHeader& header = m_headers[index];
+            header = PacketHeader{};
+            header.packet.magic = to_little_endian(RIFT_PACKET_MAGIC_NUMBER);
+            header.packet.object_count = 1; // The client header; converted to little-endian at the end
+            header.client.object.magic = to_little_endian(RIFT_MAGIC_NUMBER);
+            header.client.object.schema_id = to_little_endian(RIFT_FANOUT_HEADER_SCHEMA_ID);
+            header.client.object.total_size = to_little_endian(static_cast<uint32>(sizeof(RiftFanOutHeader)));
+            header.client.tick = to_little_endian(tick);
+            header.client.client_id = to_little_endian(client_id);
+            header.client.packet_index = to_little_endian(static_cast<uint16>(index));
+            header.client.packet_count = to_little_endian(static_cast<uint16>(packets));
+
+            m_datagrams.push_back({ m_slices.data() + m_slices.size(), 1, static_cast<uint32>(sizeof(PacketHeader)) });
+            m_slices.push_back({ &header, sizeof(PacketHeader) });
+        }
+
+        size_t m_packet_budget;
+        std::vector<PacketHeader> m_headers;
+        std::vector<RiftIoSlice> m_slices;
+        std::vector<RiftDatagram> m_datagrams;
+        uint32 m_skipped = 0;
+    };
+
+} // namespace RiftSerializer
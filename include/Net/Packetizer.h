@@ -0,0 +1,219 @@
+﻿// RiftSerializer/include/RiftSerializer/Packetizer.h
+//
+// Splits serialized messages into datagrams that fit a UDP payload budget,
+// and reassembles them on the receiving side.
+//
+// Datagram layout:
+//   [RiftFragmentHeader (12 bytes)][fragment payload]
+//
+// The packetizer never copies payload bytes: each datagram is a gather list
+// of its header plus slices of the caller's buffer, ready for sendmsg/writev.
+// The reassembler writes fragments straight to their final position in a
+// preallocated, 8-byte aligned slot, so a completed message can be viewed in
+// place.
+
+#pragma once
+
+#include "../Accessor/Accessor.h"
+#include "../Memory/AlignedBuffer.h"
+#include <vector>
+
+namespace RiftSerializer {
+
+    constexpr size_t RIFT_DEFAULT_DATAGRAM_SIZE = 1200;
+
+    // Stored little-endian; read and written with memcpy (datagrams are unaligned).
+    struct RiftFragmentHeader {
+        uint32 message_id;
+        uint32 message_size;     // Total bytes of the reassembled message
+        uint16 fragment_index;
+        uint16 fragment_payload; // Payload bytes of every fragment except possibly the last
+    };
+    static_assert(sizeof(RiftFragmentHeader) == 12, "RiftFragmentHeader must be 12 bytes.");
+
+    // --- RiftPacketizer ---
+    // Each RiftDatagram it produces is the fragment header followed by one or
+    // more slices of the message.
+    class RiftPacketizer {
+    public:
+        explicit RiftPacketizer(size_t datagram_size = RIFT_DEFAULT_DATAGRAM_SIZE)
+            : m_fragment_payload(static_cast<uint16>(std::min<size_t>(datagram_size - sizeof(RiftFragmentHeader), UINT16_MAX))) {
+            RIFT_ASSERT(datagram_size > sizeof(RiftFragmentHeader), "Datagram size is too small for a fragment header.");
+        }
+
+        size_t GetMaxMessageSize() const { return static_cast<size_t>(m_fragment_payload) * UINT16_MAX; }
+
+        // Splits one message into datagrams. The message must stay alive and
+        // unchanged until the datagrams have been sent. Returns the number of
+        // datagrams, or 0 if the message is empty or too large. Datagrams stay
+        // valid until the next call.
+        uint32 Packetize(uint32 message_id, const void* data, size_t size) {
+            const RiftIoSlice slice{ data, size };
+            return Packetize(message_id, &slice, 1);
+        }
+
+        // Same, for a message given as a gather list (e.g. from RiftBufferBuilder::GetIoSlices()).
+        uint32 Packetize(uint32 message_id, const RiftIoSlice* message, size_t slice_count) {
+            m_headers.clear();
+            m_slices.clear();
+            m_datagrams.clear();
+
+            size_t size = 0;
+            for (size_t i = 0; i < slice_count; ++i) size += message[i].size;
+            if (size == 0 || size > GetMaxMessageSize() || size > UINT32_MAX) return 0;
+
+            const uint32 count = static_cast<uint32>((size + m_fragment_payload - 1) / m_fragment_payload);
+            m_headers.resize(count);
+            // Header + first payload slice per datagram, plus one more per message slice boundary.
+            // Reserving the bound up front keeps the slice pointers stable.
+            m_slices.reserve(2 * static_cast<size_t>(count) + slice_count);
+            size_t slice = 0;
+            size_t slice_offset = 0;
+            for (uint32 i = 0; i < count; ++i) {
+                RiftFragmentHeader& header = m_headers[i];
+                header.message_id = to_little_endian(message_id);
+                header.message_size = to_little_endian(static_cast<uint32>(size));
+                header.fragment_index = to_little_endian(static_cast<uint16>(i));
+                header.fragment_payload = to_little_endian(m_fragment_payload);
+
+                RiftDatagram datagram{ m_slices.data() + m_slices.size(), 1, sizeof(RiftFragmentHeader) };
+                m_slices.push_back({ &header, sizeof(RiftFragmentHeader) });
+                size_t remaining = std::min<size_t>(m_fragment_payload, size - static_cast<size_t>(i) * m_fragment_payload);
+                while (remaining > 0) {
+                    const size_t take = std::min(remaining, message[slice].size - slice_offset);
+                    if (take > 0) {
+                        m_slices.push_back({ static_cast<const uint8*>(message[slice].data) + slice_offset, take });
+                        ++datagram.slice_count;
+                        datagram.size += static_cast<uint32>(take);
+                        remaining -= take;
+                        slice_offset += take;
+                    }
+                    if (slice_offset == message[slice].size) {
+                        ++slice;
+                        slice_offset = 0;
+                    }
+                }
+                m_datagrams.push_back(datagram);
+            }
+            return count;
+        }
+
+        uint32 GetDatagramCount() const { return static_cast<uint32>(m_datagrams.size()); }
+        const RiftDatagram& GetDatagram(uint32 index) const { return m_datagrams[index]; }
+        const RiftDatagram* GetDatagrams() const { return m_datagrams.data(); }
+
+    private:
+        uint16 m_fragment_payload;
+        std::vector<RiftFragmentHeader> m_headers;
+        std::vector<RiftIoSlice> m_slices;
+        std::vector<RiftDatagram> m_datagrams;
+    };
+
+    struct RiftReassemblerStats {
+        uint64 completed_messages;
+        uint64 evicted_messages;    // Incomplete messages overwritten by a newer message id
+        uint64 duplicate_fragments;
+        uint64 rejected_datagrams;  // Malformed, oversized, or for an already completed message
+    };
+
+    // --- RiftReassembler ---
+    // slot_count messages can be in flight at once; message ids map to slots
+    // by id % slot_count, so senders should use consecutive ids. A fragment
+    // for a newer id evicts an incomplete older message from its slot. All
+    // memory is allocated up front.
+    class RiftReassembler {
+    public:
+        explicit RiftReassembler(size_t max_message_size = 64u << 10, uint32 slot_count = 64, size_t min_fragment_payload = 512)
+            : m_max_message_size(align_up(max_message_size, alignof(RiftObjectHeader))),
+            m_bitmap_words((max_message_size / min_fragment_payload + 64) / 64),
+            m_buffer(m_max_message_size * slot_count, alignof(RiftObjectHeader)),
+            m_slots(slot_count),
+            m_bitmaps(m_bitmap_words * slot_count) {
+        }
+
+        // Handles one received datagram. When it completes a message, calls
+        // on_message(message_id, const uint8* data, size_t size); data is
+        // 8-byte aligned and only valid during the callback.
+        template<typename Callback>
+        bool OnDatagram(const void* datagram, size_t size, Callback&& on_message) {
+            RiftFragmentHeader header;
+            if (size <= sizeof(header)) return Reject();
+            std::memcpy(&header, datagram, sizeof(header));
+            const uint32 message_id = from_little_endian(header.message_id);
+            const uint32 message_size = from_little_endian(header.message_size);
+            const size_t index = from_little_endian(header.fragment_index);
+            const size_t fragment_payload = from_little_endian(header.fragment_payload);
+            const size_t payload = size - sizeof(header);
+            const size_t offset = index * fragment_payload;
+            if (fragment_payload == 0 || message_size == 0 || message_size > m_max_message_size ||
+                offset >= message_size || payload != std::min(fragment_payload, message_size - offset) ||
+                index >= m_bitmap_words * 64) {
+                return Reject();
+            }
+
+            Slot& slot = m_slots[message_id % m_slots.size()];
+            if (!slot.active || slot.message_id != message_id) {
+                if (slot.active && static_cast<int32>(message_id - slot.message_id) < 0) return Reject(); // Stale
+                if (!slot.active && slot.completed && static_cast<int32>(message_id - slot.message_id) <= 0) return Reject();
+                if (slot.active) ++m_stats.evicted_messages;
+                slot.active = true;
+                slot.completed = false;
+                slot.message_id = message_id;
+                slot.message_size = message_size;
+                slot.fragment_payload = fragment_payload;
+                slot.received = 0;
+                std::fill_n(Bitmap(slot), m_bitmap_words, 0);
+            }
+            else if (slot.message_size != message_size || slot.fragment_payload != fragment_payload) {
+                return Reject();
+            }
+
+            uint64& word = Bitmap(slot)[index / 64];
+            const uint64 bit = uint64(1) << (index % 64);
+            if (word & bit) {
+                ++m_stats.duplicate_fragments;
+                return true;
+            }
+            word |= bit;
+            uint8* data = m_buffer.GetData() + SlotIndex(slot) * m_max_message_size;
+            std::memcpy(data + offset, static_cast<const uint8*>(datagram) + sizeof(header), payload);
+            slot.received += payload;
+
+            if (slot.received == slot.message_size) {
+                slot.active = false;
+                slot.completed = true;
+                ++m_stats.completed_messages;
+                on_message(message_id, static_cast<const uint8*>(data), static_cast<size_t>(message_size));
+            }
+            return true;
+        }
+
+        const RiftReassemblerStats& GetStats() const { return m_stats; }
+
+    private:
+        struct Slot {
+            uint32 message_id = 0;
+            uint32 message_size = 0;
+            size_t fragment_payload = 0; // Fixed by the first fragment; offsets are index * fragment_payload
+            size_t received = 0;
+            bool active = false;    // Collecting fragments
+            bool completed = false; // message_id was delivered; late duplicates are rejected
+        };
+
+        bool Reject() {
+            ++m_stats.rejected_datagrams;
+            return false;
+        }
+
+        size_t SlotIndex(const Slot& slot) const { return static_cast<size_t>(&slot - m_slots.data()); }
+        uint64* Bitmap(const Slot& slot) { return m_bitmaps.data() + SlotIndex(slot) * m_bitmap_words; }
+
+        size_t m_max_message_size;
+        size_t m_bitmap_words;
+        RiftAlignedBuffer m_buffer;
+        std::vector<Slot> m_slots;
+        std::vector<uint64> m_bitmaps;
+        RiftReassemblerStats m_stats{};
+    };
+
+} // namespace RiftSerializer
@@ -0,0 +1,244 @@
+﻿// RiftSerializer/include/RiftSerializer/Socket.h
+//
+// Minimal IPv4 UDP socket for the net components. Gather sends map directly
+// onto sendmsg/WSASendTo, and on Linux batches of datagrams go out and come
+// in with a single sendmmsg/recvmmsg call.
+
+#pragma once
+
+#include "../Common/Common.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstddef>
+#endif
+
+namespace RiftSerializer {
+
+    // --- RiftUdpSocket ---
+    // Move-only. Sends go to the address given to Connect().
+    class RiftUdpSocket {
+    public:
+#ifdef _WIN32
+        using NativeHandle = SOCKET;
+#else
+        using NativeHandle = int;
+#endif
+        // Datagrams handed to the kernel per sendmmsg/recvmmsg call.
+        static constexpr uint32 MAX_BATCH = 64;
+
+        RiftUdpSocket() = default;
+        ~RiftUdpSocket() { Close(); }
+        RiftUdpSocket(const RiftUdpSocket&) = delete;
+        RiftUdpSocket& operator=(const RiftUdpSocket&) = delete;
+        RiftUdpSocket(RiftUdpSocket&& other) noexcept : m_handle(other.m_handle) { other.m_handle = InvalidHandle(); }
+        RiftUdpSocket& operator=(RiftUdpSocket&& other) noexcept {
+            if (this != &other) {
+                Close();
+                m_handle = other.m_handle;
+                other.m_handle = InvalidHandle();
+            }
+            return *this;
+        }
+
+        // Binds to address:port; port 0 picks an ephemeral port (see GetLocalPort()).
+        bool Open(uint16 port = 0, const char* address = "127.0.0.1") {
+            Close();
+#ifdef _WIN32
+            static const bool winsock_ready = [] { WSADATA data; return WSAStartup(MAKEWORD(2, 2), &data) == 0; }();
+            if (!winsock_ready) return false;
+#endif
+            m_handle = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+            if (!IsOpen()) return false;
+            sockaddr_in local{};
+            if (!MakeAddress(address, port, local) || ::bind(m_handle, reinterpret_cast<const sockaddr*>(&local), sizeof(local)) != 0) {
+                Close();
+                return false;
+            }
+            return true;
+        }
+
+        // Sets the default destination for all sends (and filters receives to that peer).
+        bool Connect(const char* address, uint16 port) {
+            sockaddr_in remote{};
+            return MakeAddress(address, port, remote) && ::connect(m_handle, reinterpret_cast<const sockaddr*>(&remote), sizeof(remote)) == 0;
+        }
+
+        void Close() {
+            if (!IsOpen()) return;
+#ifdef _WIN32
+            ::closesocket(m_handle);
+#else
+            ::close(m_handle);
+#endif
+            m_handle = InvalidHandle();
+        }
+
+        bool IsOpen() const { return m_handle != InvalidHandle(); }
+        NativeHandle GetNativeHandle() const { return m_handle; }
+
+        uint16 GetLocalPort() const {
+            sockaddr_in local{};
+            socklen_t length = sizeof(local);
+            if (::getsockname(m_handle, reinterpret_cast<sockaddr*>(&local), &length) != 0) return 0;
+            return ntohs(local.sin_port);
+        }
+
+        bool SetNonBlocking(bool non_blocking) {
+#ifdef _WIN32
+            u_long mode = non_blocking ? 1 : 0;
+            return ::ioctlsocket(m_handle, FIONBIO, &mode) == 0;
+#else
+            const int flags = ::fcntl(m_handle, F_GETFL, 0);
+            return flags >= 0 && ::fcntl(m_handle, F_SETFL, non_blocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK)) == 0;
+#endif
+        }
+
+        bool SetBufferSizes(int send_bytes, int receive_bytes) {
+            return ::setsockopt(m_handle, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char*>(&send_bytes), sizeof(send_bytes)) == 0 &&
+                ::setsockopt(m_handle, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&receive_bytes), sizeof(receive_bytes)) == 0;
+        }
+
+        bool Send(const void* data, size_t size) {
+            const RiftIoSlice slice{ data, size };
+            return SendGather(&slice, 1);
+        }
+
+        // Sends the slices as one datagram.
+        bool SendGather(const RiftIoSlice* slices, size_t count) {
+#ifdef _WIN32
+            WSABUF buffers[MAX_BATCH];
+            if (count > MAX_BATCH) return false;
+            for (size_t i = 0; i < count; ++i) {
+                buffers[i].buf = static_cast<CHAR*>(const_cast<void*>(slices[i].data));
+                buffers[i].len = static_cast<ULONG>(slices[i].size);
+            }
+            DWORD sent = 0;
+            return ::WSASend(m_handle, buffers, static_cast<DWORD>(count), &sent, 0, nullptr, nullptr) == 0;
+#else
+            static_assert(sizeof(RiftIoSlice) == sizeof(iovec) && offsetof(iovec, iov_len) == offsetof(RiftIoSlice, size),
+                "RiftIoSlice must match iovec.");
+            msghdr message{};
+            message.msg_iov = reinterpret_cast<iovec*>(const_cast<RiftIoSlice*>(slices));
+            message.msg_iovlen = count;
+            for (;;) {
+                if (::sendmsg(m_handle, &message, 0) >= 0) return true;
+                if (errno != EINTR) return false;
+            }
+#endif
+        }
+
+        // Sends each datagram as its own packet. Returns how many were sent;
+        // fewer than count means the socket would block or failed.
+        uint32 SendBatch(const RiftDatagram* datagrams, uint32 count) {
+#if defined(__linux__)
+            uint32 sent = 0;
+            while (sent < count) {
+                mmsghdr messages[MAX_BATCH];
+                const uint32 batch = std::min(count - sent, MAX_BATCH);
+                for (uint32 i = 0; i < batch; ++i) {
+                    messages[i] = mmsghdr{};
+                    messages[i].msg_hdr.msg_iov = reinterpret_cast<iovec*>(const_cast<RiftIoSlice*>(datagrams[sent + i].slices));
+                    messages[i].msg_hdr.msg_iovlen = datagrams[sent + i].slice_count;
+                }
+                const int result = ::sendmmsg(m_handle, messages, batch, 0);
+                if (result < 0) {
+                    if (errno == EINTR) continue;
+                    break;
+                }
+                sent += static_cast<uint32>(result);
+                if (static_cast<uint32>(result) < batch) break;
+            }
+            return sent;
+#else
+            for (uint32 i = 0; i < count; ++i) {
+                if (!SendGather(datagrams[i].slices, datagrams[i].slice_count)) return i;
+            }
+            return count;
+#endif
+        }
+
+        // Receives one datagram. Returns its size, 0 if nothing is available on
+        // a non-blocking socket, or -1 on error.
+        int64 Receive(void* buffer, size_t capacity) {
+            for (;;) {
+#ifdef _WIN32
+                const int result = ::recv(m_handle, static_cast<char*>(buffer), static_cast<int>(capacity), 0);
+                if (result >= 0) return result;
+                return ::WSAGetLastError() == WSAEWOULDBLOCK ? 0 : -1;
+#else
+                const ssize_t result = ::recv(m_handle, buffer, capacity, 0);
+                if (result >= 0) return result;
+                if (errno == EINTR) continue;
+                return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+#endif
+            }
+        }
+
+        // Receives up to count datagrams into consecutive buffers of stride
+        // bytes starting at buffers, storing each size in sizes. Waits for the
+        // first datagram only (on a blocking socket). Returns the number
+        // received, 0 if none are available on a non-blocking socket. Without
+        // recvmmsg this receives one datagram per call.
+        uint32 ReceiveBatch(uint8* buffers, size_t stride, uint32 count, size_t* sizes) {
+#if defined(__linux__)
+            mmsghdr messages[MAX_BATCH];
+            iovec vectors[MAX_BATCH];
+            count = std::min(count, MAX_BATCH);
+            for (uint32 i = 0; i < count; ++i) {
+                vectors[i] = { buffers + i * stride, stride };
+                messages[i] = mmsghdr{};
+                messages[i].msg_hdr.msg_iov = &vectors[i];
+                messages[i].msg_hdr.msg_iovlen = 1;
+            }
+            int result;
+            do {
+                result = ::recvmmsg(m_handle, messages, count, MSG_WAITFORONE, nullptr);
+            } while (result < 0 && errno == EINTR);
+            if (result <= 0) return 0;
+            for (int i = 0; i < result; ++i) sizes[i] = messages[i].msg_len;
+            return static_cast<uint32>(result);
+#else
+            if (count == 0) return 0;
+            const int64 size = Receive(buffers, stride);
+            if (size <= 0) return 0;
+            sizes[0] = static_cast<size_t>(size);
+            return 1;
+#endif
+        }
+
+    private:
+        static NativeHandle InvalidHandle() {
+#ifdef _WIN32
+            return INVALID_SOCKET;
+#else
+            return -1;
+#endif
+        }
+
+        static bool MakeAddress(const char* address, uint16 port, sockaddr_in& out) {
+            out.sin_family = AF_INET;
+            out.sin_port = htons(port);
+            return ::inet_pton(AF_INET, address, &out.sin_addr) == 1;
+        }
+
+        NativeHandle m_handle = InvalidHandle();
+    };
+
+} // namespace RiftSerializer
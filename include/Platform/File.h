@@ -0,0 +1,335 @@
+﻿// RiftSerializer/include/RiftSerializer/File.h
+//
+// Minimal platform file layer used by the archive and log components:
+// a positional-I/O file handle and a read-only memory mapping.
+
+#pragma once
+
+#include "../Common/Common.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <climits>
+#include <cstddef>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace RiftSerializer {
+
+    enum class RiftFileMode {
+        Read,      // Existing file, read-only
+        Write,     // Create or truncate, write-only
+        ReadWrite, // Create if missing, read-write
+    };
+
+    // --- RiftFile ---
+    // An owning, move-only file handle. All calls transfer the full amount or fail.
+    class RiftFile {
+    public:
+#ifdef _WIN32
+        using NativeHandle = HANDLE;
+#else
+        using NativeHandle = int;
+#endif
+
+        RiftFile() = default;
+        ~RiftFile() { Close(); }
+        RiftFile(const RiftFile&) = delete;
+        RiftFile& operator=(const RiftFile&) = delete;
+        RiftFile(RiftFile&& other) noexcept : m_handle(other.m_handle) { other.m_handle = InvalidHandle(); }
+        RiftFile& operator=(RiftFile&& other) noexcept {
+            if (this != &other) {
+                Close();
+                m_handle = other.m_handle;
+                other.m_handle = InvalidHandle();
+            }
+            return *this;
+        }
+
+        // direct_io bypasses the OS page cache (O_DIRECT / FILE_FLAG_NO_BUFFERING).
+        // Buffers, offsets and sizes must then be multiples of the device block
+        // size; page alignment is always sufficient.
+        bool Open(const char* path, RiftFileMode mode, bool direct_io = false) {
+            Close();
+#ifdef _WIN32
+            const DWORD access = mode == RiftFileMode::Read ? GENERIC_READ
+                : mode == RiftFileMode::Write ? GENERIC_WRITE : (GENERIC_READ | GENERIC_WRITE);
+            const DWORD disposition = mode == RiftFileMode::Read ? OPEN_EXISTING
+                : mode == RiftFileMode::Write ? CREATE_ALWAYS : OPEN_ALWAYS;
+            const DWORD attributes = direct_io ? (FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH) : FILE_ATTRIBUTE_NORMAL;
+            m_handle = CreateFileA(path, access, FILE_SHARE_READ, nullptr, disposition, attributes, nullptr);
+#else
+            const int flags = mode == RiftFileMode::Read ? O_RDONLY
+                : mode == RiftFileMode::Write ? (O_WRONLY | O_CREAT | O_TRUNC) : (O_RDWR | O_CREAT);
+#ifdef O_DIRECT
+            m_handle = ::open(path, flags | O_CLOEXEC | (direct_io ? O_DIRECT : 0), 0644);
+#else
+            m_handle = ::open(path, flags | O_CLOEXEC, 0644);
+#ifdef F_NOCACHE
+            if (direct_io && m_handle >= 0) ::fcntl(m_handle, F_NOCACHE, 1);
+#endif
+#endif
+#endif
+            return IsOpen();
+        }
+
+        void Close() {
+            if (!IsOpen()) return;
+#ifdef _WIN32
+            CloseHandle(m_handle);
+#else
+            ::close(m_handle);
+#endif
+            m_handle = InvalidHandle();
+        }
+
+        bool IsOpen() const { return m_handle != InvalidHandle(); }
+        NativeHandle GetNativeHandle() const { return m_handle; }
+
+        // Writes at the current file position.
+        bool Write(const void* data, size_t size) {
+            const auto* bytes = static_cast<const uint8*>(data);
+            while (size > 0) {
+#ifdef _WIN32
+                DWORD written = 0;
+                const DWORD chunk = static_cast<DWORD>(std::min<size_t>(size, 1u << 30));
+                if (!WriteFile(m_handle, bytes, chunk, &written, nullptr)) return false;
+#else
+                const ssize_t written = ::write(m_handle, bytes, size);
+                if (written < 0) {
+                    if (errno == EINTR) continue;
+                    return false;
+                }
+#endif
+                bytes += written;
+                size -= static_cast<size_t>(written);
+            }
+            return true;
+        }
+
+        // Writes the slices in order at the current file position (writev on POSIX).
+        bool WriteGather(const RiftIoSlice* slices, size_t count) {
+#ifdef _WIN32
+            for (size_t i = 0; i < count; ++i) {
+                if (!Write(slices[i].data, slices[i].size)) return false;
+            }
+            return true;
+#else
+            static_assert(sizeof(RiftIoSlice) == sizeof(iovec) && offsetof(iovec, iov_len) == offsetof(RiftIoSlice, size),
+                "RiftIoSlice must match iovec.");
+            while (count > 0) {
+                const int batch = static_cast<int>(std::min<size_t>(count, IOV_MAX));
+                ssize_t written = ::writev(m_handle, reinterpret_cast<const iovec*>(slices), batch);
+                if (written < 0) {
+                    if (errno == EINTR) continue;
+                    return false;
+                }
+                // Skip fully written slices, then finish a partially written one with plain writes.
+                while (count > 0 && static_cast<size_t>(written) >= slices->size) {
+                    written -= static_cast<ssize_t>(slices->size);
+                    ++slices;
+                    --count;
+                }
+                if (written > 0) {
+                    if (!Write(static_cast<const uint8*>(slices->data) + written, slices->size - static_cast<size_t>(written))) return false;
+                    ++slices;
+                    --count;
+                }
+            }
+            return true;
+#endif
+        }
+
+        bool WriteAt(uint64 offset, const void* data, size_t size) {
+            const auto* bytes = static_cast<const uint8*>(data);
+            while (size > 0) {
+#ifdef _WIN32
+                OVERLAPPED overlapped{};
+                overlapped.Offset = static_cast<DWORD>(offset);
+                overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+                DWORD written = 0;
+                const DWORD chunk = static_cast<DWORD>(std::min<size_t>(size, 1u << 30));
+                if (!WriteFile(m_handle, bytes, chunk, &written, &overlapped)) return false;
+#else
+                const ssize_t written = ::pwrite(m_handle, bytes, size, static_cast<off_t>(offset));
+                if (written < 0) {
+                    if (errno == EINTR) continue;
+                    return false;
+                }
+#endif
+                bytes += written;
+                offset += static_cast<uint64>(written);
+                size -= static_cast<size_t>(written);
+            }
+            return true;
+        }
+
+        // Fails if the file ends before size bytes were read.
+        bool ReadAt(uint64 offset, void* data, size_t size) const {
+            auto* bytes = static_cast<uint8*>(data);
+            while (size > 0) {
+#ifdef _WIN32
+                OVERLAPPED overlapped{};
+                overlapped.Offset = static_cast<DWORD>(offset);
+                overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+                DWORD read = 0;
+                const DWORD chunk = static_cast<DWORD>(std::min<size_t>(size, 1u << 30));
+                if (!ReadFile(m_handle, bytes, chunk, &read, &overlapped) || read == 0) return false;
+#else
+                const ssize_t read = ::pread(m_handle, bytes, size, static_cast<off_t>(offset));
+                if (read < 0 && errno == EINTR) continue;
+                if (read <= 0) return false;
+#endif
+                bytes += read;
+                offset += static_cast<uint64>(read);
+                size -= static_cast<size_t>(read);
+            }
+            return true;
+        }
+
+        // Reads up to size bytes, stopping early at end of file. Returns the
+        // number of bytes read, or -1 on error.
+        int64 ReadAtMost(uint64 offset, void* data, size_t size) const {
+            auto* bytes = static_cast<uint8*>(data);
+            size_t total = 0;
+            while (total < size) {
+#ifdef _WIN32
+                OVERLAPPED overlapped{};
+                overlapped.Offset = static_cast<DWORD>(offset + total);
+                overlapped.OffsetHigh = static_cast<DWORD>((offset + total) >> 32);
+                DWORD read = 0;
+                const DWORD chunk = static_cast<DWORD>(std::min<size_t>(size - total, 1u << 30));
+                if (!ReadFile(m_handle, bytes + total, chunk, &read, &overlapped)) {
+                    if (GetLastError() == ERROR_HANDLE_EOF) break;
+                    return -1;
+                }
+#else
+                const ssize_t read = ::pread(m_handle, bytes + total, size - total, static_cast<off_t>(offset + total));
+                if (read < 0) {
+                    if (errno == EINTR) continue;
+                    return -1;
+                }
+#endif
+                if (read == 0) break;
+                total += static_cast<size_t>(read);
+            }
+            return static_cast<int64>(total);
+        }
+
+        // Flushes file data to stable storage.
+        bool Sync() {
+#ifdef _WIN32
+            return FlushFileBuffers(m_handle) != 0;
+#elif defined(__linux__)
+            return ::fdatasync(m_handle) == 0;
+#else
+            return ::fsync(m_handle) == 0;
+#endif
+        }
+
+        uint64 GetSize() const {
+#ifdef _WIN32
+            LARGE_INTEGER size;
+            return GetFileSizeEx(m_handle, &size) ? static_cast<uint64>(size.QuadPart) : 0;
+#else
+            struct stat st;
+            return ::fstat(m_handle, &st) == 0 ? static_cast<uint64>(st.st_size) : 0;
+#endif
+        }
+
+    private:
+        static NativeHandle InvalidHandle() {
+#ifdef _WIN32
+            return INVALID_HANDLE_VALUE;
+#else
+            return -1;
+#endif
+        }
+
+        NativeHandle m_handle = InvalidHandle();
+    };
+
+    // --- RiftMappedFile ---
+    // A read-only mapping of a whole file. The mapping is page-aligned, so any
+    // 8-byte aligned file offset is a valid RiftObjectHeader address.
+    class RiftMappedFile {
+    public:
+        RiftMappedFile() = default;
+        ~RiftMappedFile() { Close(); }
+        RiftMappedFile(const RiftMappedFile&) = delete;
+        RiftMappedFile& operator=(const RiftMappedFile&) = delete;
+
+        bool Open(const char* path) {
+            Close();
+            RiftFile file;
+            if (!file.Open(path, RiftFileMode::Read)) return false;
+            const uint64 size = file.GetSize();
+            if (size == 0 || size > static_cast<uint64>(SIZE_MAX)) return false;
+#ifdef _WIN32
+            m_mapping = CreateFileMappingA(file.GetNativeHandle(), nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!m_mapping) return false;
+            void* data = MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+            if (!data) {
+                CloseHandle(m_mapping);
+                m_mapping = nullptr;
+                return false;
+            }
+#else
+            void* data = ::mmap(nullptr, static_cast<size_t>(size), PROT_READ, MAP_SHARED, file.GetNativeHandle(), 0);
+            if (data == MAP_FAILED) return false;
+#endif
+            m_data = static_cast<const uint8*>(data);
+            m_size = static_cast<size_t>(size);
+            return true;
+        }
+
+        void Close() {
+            if (!m_data) return;
+#ifdef _WIN32
+            UnmapViewOfFile(m_data);
+            CloseHandle(m_mapping);
+            m_mapping = nullptr;
+#else
+            ::munmap(const_cast<uint8*>(m_data), m_size);
+#endif
+            m_data = nullptr;
+            m_size = 0;
+        }
+
+        bool IsOpen() const { return m_data != nullptr; }
+        const uint8* GetData() const { return m_data; }
+        size_t GetSize() const { return m_size; }
+
+        // Hints that [offset, offset + size) will be read soon.
+        void Prefetch(size_t offset, size_t size) const {
+#ifndef _WIN32
+            if (offset >= m_size) return;
+            const size_t page_start = offset & ~(static_cast<size_t>(::sysconf(_SC_PAGESIZE)) - 1);
+            ::madvise(const_cast<uint8*>(m_data) + page_start, std::min(size + (offset - page_start), m_size - page_start), MADV_WILLNEED);
+#else
+            (void)offset;
+            (void)size;
+#endif
+        }
+
+    private:
+        const uint8* m_data = nullptr;
+        size_t m_size = 0;
+#ifdef _WIN32
+        HANDLE m_mapping = nullptr;
+#endif
+    };
+
+} // namespace RiftSerializer
@@ -0,0 +1,156 @@
+﻿// RiftSerializer/include/RiftSerializer/SharedMemory.h
+//
+// Named shared-memory regions for cross-process transports. One process
+// creates the region, others open it by name; every process sees the same
+// bytes at a page-aligned address.
+
+#pragma once
+
+#include "../Common/Common.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <string>
+#endif
+
+namespace RiftSerializer {
+
+    // --- RiftSharedMemory ---
+    // A move-only mapping of a named region. Names follow the POSIX shm_open
+    // convention ("/rift-telemetry"); on Windows the leading slash is dropped.
+    class RiftSharedMemory {
+    public:
+        RiftSharedMemory() = default;
+        ~RiftSharedMemory() { Close(); }
+        RiftSharedMemory(const RiftSharedMemory&) = delete;
+        RiftSharedMemory& operator=(const RiftSharedMemory&) = delete;
+        RiftSharedMemory(RiftSharedMemory&& other) noexcept { MoveFrom(other); }
+        RiftSharedMemory& operator=(RiftSharedMemory&& other) noexcept {
+            if (this != &other) {
+                Close();
+                MoveFrom(other);
+            }
+            return *this;
+        }
+
+        // Creates a zero-filled region. The creator owns the name and removes it
+        // on Close(). A stale POSIX region left by a crashed process is replaced;
+        // on Windows creation fails while another process still holds the name.
+        bool Create(const char* name, size_t size) {
+            Close();
+            if (size == 0) return false;
+#ifdef _WIN32
+            m_mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                static_cast<DWORD>(static_cast<uint64>(size) >> 32), static_cast<DWORD>(size), NativeName(name));
+            if (!m_mapping) return false;
+            if (GetLastError() == ERROR_ALREADY_EXISTS) return Fail();
+            return Map(size);
+#else
+            ::shm_unlink(name);
+            const int fd = ::shm_open(name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+            if (fd < 0) return false;
+            m_name = name;
+            const bool ok = ::ftruncate(fd, static_cast<off_t>(size)) == 0 && Map(fd, size);
+            ::close(fd);
+            return ok || Fail();
+#endif
+        }
+
+        // Opens a region created by another process.
+        bool Open(const char* name) {
+            Close();
+#ifdef _WIN32
+            m_mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, NativeName(name));
+            if (!m_mapping) return false;
+            return Map(0);
+#else
+            const int fd = ::shm_open(name, O_RDWR | O_CLOEXEC, 0600);
+            if (fd < 0) return false;
+            struct stat st;
+            const bool ok = ::fstat(fd, &st) == 0 && st.st_size > 0 && Map(fd, static_cast<size_t>(st.st_size));
+            ::close(fd);
+            return ok || Fail();
+#endif
+        }
+
+        void Close() {
+#ifdef _WIN32
+            if (m_data) UnmapViewOfFile(m_data);
+            if (m_mapping) CloseHandle(m_mapping);
+            m_mapping = nullptr;
+#else
+            if (m_data) ::munmap(m_data, m_size);
+            if (!m_name.empty()) ::shm_unlink(m_name.c_str());
+            m_name.clear();
+#endif
+            m_data = nullptr;
+            m_size = 0;
+        }
+
+        bool IsOpen() const { return m_data != nullptr; }
+        uint8* GetData() const { return m_data; }
+        size_t GetSize() const { return m_size; }
+
+    private:
+        bool Fail() {
+            Close();
+            return false;
+        }
+
+#ifdef _WIN32
+        static const char* NativeName(const char* name) { return name[0] == '/' ? name + 1 : name; }
+
+        bool Map(size_t size) {
+            m_data = static_cast<uint8*>(MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, size));
+            if (!m_data) return Fail();
+            MEMORY_BASIC_INFORMATION info;
+            m_size = size != 0 ? size : (VirtualQuery(m_data, &info, sizeof(info)) ? info.RegionSize : 0);
+            return true;
+        }
+
+        void MoveFrom(RiftSharedMemory& other) {
+            m_data = other.m_data;
+            m_size = other.m_size;
+            m_mapping = other.m_mapping;
+            other.m_data = nullptr;
+            other.m_size = 0;
+            other.m_mapping = nullptr;
+        }
+
+        HANDLE m_mapping = nullptr;
+#else
+        bool Map(int fd, size_t size) {
+            void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (data == MAP_FAILED) return false;
+            m_data = static_cast<uint8*>(data);
+            m_size = size;
+            return true;
+        }
+
+        void MoveFrom(RiftSharedMemory& other) {
+            m_data = other.m_data;
+            m_size = other.m_size;
+            m_name = std::move(other.m_name);
+            other.m_data = nullptr;
+            other.m_size = 0;
+            other.m_name.clear();
+        }
+
+        std::string m_name; // Set only for the creating process
+#endif
+        uint8* m_data = nullptr;
+        size_t m_size = 0;
+    };
+
+} // namespace RiftSerializer
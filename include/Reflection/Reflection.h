@@ -0,0 +1,204 @@
+﻿// RiftSerializer/include/RiftSerializer/Reflection.h
+//
+// Binary reflection tables describing the inline layout of each schema.
+// The schema compiler emits one constexpr RiftSchemaInfo per schema and
+// registers it with RIFT_SERIALIZER_REGISTER_SCHEMA, so generic tooling
+// (JSON transcoding, dumping, analysis) can walk any buffer by schema_id.
+
+#pragma once
+
+#include "../Types/Types.h"
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace RiftSerializer {
+
+    // --- RiftFieldType ---
+    // The wire representation of a single field slot.
+    enum class RiftFieldType : uint8 {
+        None = 0,
+        Bool,
+        Int8,
+        UInt8,
+        Int16,
+        UInt16,
+        Int32,
+        UInt32,
+        Int64,
+        UInt64,
+        Float,
+        Double,
+        Vec2,
+        Vec3,
+        Vec4,
+        Quat,
+        String, // Inline OffsetTableEntry -> null-terminated char data, size = character count.
+        Array,  // Inline OffsetTableEntry -> element_type[size].
+    };
+
+    // Size in bytes of a fixed-size field type (0 for variable-size types).
+    inline constexpr size_t GetFieldTypeSize(RiftFieldType type) {
+        switch (type) {
+        case RiftFieldType::Bool:
+        case RiftFieldType::Int8:
+        case RiftFieldType::UInt8:   return 1;
+        case RiftFieldType::Int16:
+        case RiftFieldType::UInt16:  return 2;
+        case RiftFieldType::Int32:
+        case RiftFieldType::UInt32:
+        case RiftFieldType::Float:   return 4;
+        case RiftFieldType::Int64:
+        case RiftFieldType::UInt64:
+        case RiftFieldType::Double:  return 8;
+        case RiftFieldType::Vec2:    return 8;
+        case RiftFieldType::Vec3:    return 12;
+        case RiftFieldType::Vec4:
+        case RiftFieldType::Quat:    return 16;
+        default:                     return 0;
+        }
+    }
+
+    // Alignment of a field type as written by RiftBufferBuilder.
+    inline constexpr size_t GetFieldTypeAlignment(RiftFieldType type) {
+        switch (type) {
+        case RiftFieldType::Vec2:
+        case RiftFieldType::Vec3:
+        case RiftFieldType::Vec4:
+        case RiftFieldType::Quat:    return 4;
+        case RiftFieldType::String:
+        case RiftFieldType::Array:   return alignof(OffsetTableEntry);
+        default:                     return GetFieldTypeSize(type);
+        }
+    }
+
+    // Number of float components of a vector type (0 for non-vector types).
+    inline constexpr uint32 GetFieldTypeComponents(RiftFieldType type) {
+        switch (type) {
+        case RiftFieldType::Vec2:    return 2;
+        case RiftFieldType::Vec3:    return 3;
+        case RiftFieldType::Vec4:
+        case RiftFieldType::Quat:    return 4;
+        default:                     return 0;
+        }
+    }
+
+    inline constexpr const char* GetFieldTypeName(RiftFieldType type) {
+        switch (type) {
+        case RiftFieldType::Bool:    return "bool";
+        case RiftFieldType::Int8:    return "int8";
+        case RiftFieldType::UInt8:   return "uint8";
+        case RiftFieldType::Int16:   return "int16";
+        case RiftFieldType::UInt16:  return "uint16";
+        case RiftFieldType::Int32:   return "int32";
+        case RiftFieldType::UInt32:  return "uint32";
+        case RiftFieldType::Int64:   return "int64";
+        case RiftFieldType::UInt64:  return "uint64";
+        case RiftFieldType::Float:   return "float";
+        case RiftFieldType::Double:  return "double";
+        case RiftFieldType::Vec2:    return "vec2";
+        case RiftFieldType::Vec3:    return "vec3";
+        case RiftFieldType::Vec4:    return "vec4";
+        case RiftFieldType::Quat:    return "quat";
+        case RiftFieldType::String:  return "string";
+        case RiftFieldType::Array:   return "array";
+        default:                     return "none";
+        }
+    }
+
+    inline constexpr bool IsVariableSizeFieldType(RiftFieldType type) {
+        return type == RiftFieldType::String || type == RiftFieldType::Array;
+    }
+
+    namespace detail {
+        // Reads a field slot, which need not be aligned.
+        template<typename T>
+        inline T load_little_endian(const uint8* p) {
+            if constexpr (std::is_floating_point_v<T>) {
+                using Bits = std::conditional_t<sizeof(T) == 4, uint32, uint64>;
+                Bits bits;
+                std::memcpy(&bits, p, sizeof(bits));
+                bits = from_little_endian(bits);
+                T value;
+                std::memcpy(&value, &bits, sizeof(value));
+                return value;
+            }
+            else {
+                T value;
+                std::memcpy(&value, p, sizeof(value));
+                return from_little_endian(value);
+            }
+        }
+    } // namespace detail
+
+    // --- RiftFieldInfo ---
+    // One entry per field, in declaration order.
+    struct RiftFieldInfo {
+        const char* name;
+        uint32 name_length;
+        uint32 offset;              // Offset of the inline slot from the start of the object
+        RiftFieldType type;
+        RiftFieldType element_type; // Element type for Array fields, None otherwise
+    };
+
+    // --- RiftSchemaInfo ---
+    // The reflection table of one schema.
+    struct RiftSchemaInfo {
+        uint32 schema_id;
+        uint32 inline_size;         // Header + inline field slots; variable data starts after this
+        const char* name;
+        const RiftFieldInfo* fields;
+        uint32 field_count;
+
+        const RiftFieldInfo* FindField(const char* field_name, size_t length) const {
+            for (uint32 i = 0; i < field_count; ++i) {
+                if (fields[i].name_length == length && std::memcmp(fields[i].name, field_name, length) == 0) {
+                    return &fields[i];
+                }
+            }
+            return nullptr;
+        }
+    };
+
+    // --- RiftSchemaRegistry ---
+    // Process-wide lookup of reflection tables by schema_id. Registration
+    // happens during static initialization from generated headers; lookups
+    // afterwards are a binary search and are safe from any thread.
+    class RiftSchemaRegistry {
+    public:
+        static RiftSchemaRegistry& Instance() {
+            static RiftSchemaRegistry registry;
+            return registry;
+        }
+
+        bool Register(const RiftSchemaInfo* info) {
+            RIFT_ASSERT(info != nullptr, "Cannot register a null schema.");
+            auto it = std::lower_bound(m_schemas.begin(), m_schemas.end(), info->schema_id,
+                [](const RiftSchemaInfo* a, uint32 id) { return a->schema_id < id; });
+            if (it != m_schemas.end() && (*it)->schema_id == info->schema_id) {
+                RIFT_ASSERT(*it == info, "Two different schemas registered with the same schema_id.");
+                return false;
+            }
+            m_schemas.insert(it, info);
+            return true;
+        }
+
+        const RiftSchemaInfo* Find(uint32 schema_id) const {
+            auto it = std::lower_bound(m_schemas.begin(), m_schemas.end(), schema_id,
+                [](const RiftSchemaInfo* a, uint32 id) { return a->schema_id < id; });
+            return (it != m_schemas.end() && (*it)->schema_id == schema_id) ? *it : nullptr;
+        }
+
+        const std::vector<const RiftSchemaInfo*>& GetAll() const { return m_schemas; }
+
+    private:
+        RiftSchemaRegistry() = default;
+        std::vector<const RiftSchemaInfo*> m_schemas;
+    };
+
+    // Used by generated headers after defining their RiftSchemaInfo:
+    //   RIFT_SERIALIZER_REGISTER_SCHEMA(Entity_State_SchemaInfo)
+#define RIFT_SERIALIZER_REGISTER_SCHEMA(Info) \
+    inline const bool Info##_registered = ::RiftSerializer::RiftSchemaRegistry::Instance().Register(&Info);
+
+} // namespace RiftSerializer
@@ -0,0 +1,339 @@
+﻿// RiftSerializer/include/RiftSerializer/SchemaAnalyzer.h
+//
+// Layout and content statistics for schemas, used to decide on field order,
+// quantization and elision.
+//
+// rift_analyze_schema_layout() works from the reflection table alone: slot
+// sizes, alignment holes and a field order that packs the inline slots
+// without holes. RiftSchemaCorpusStats walks real objects and records, per
+// field, how often it holds its default (all-zero slot, empty string or
+// array), the variable bytes it contributes, the distribution of string and
+// array lengths and the range of numeric values. RiftSchemaAnalyzer feeds
+// memory-mapped logs and replays through RiftParallelProcessor with one
+// RiftSchemaCorpusStats per task and merges them, so results do not depend
+// on the thread count.
+
+#pragma once
+
+#include "Reflection.h"
+#include "../Runtime/ParallelProcessor.h"
+#include "../LogWriter/LogWriter.h"
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace RiftSerializer {
+
+    // --- RiftSizeDistribution ---
+    // Power-of-two buckets like RiftHistogram, but plain counters so per-task
+    // copies can be merged.
+    struct RiftSizeDistribution {
+        static constexpr uint32 BUCKET_COUNT = 34; // 0, [1,2), [2,4), ... [2^32, ...)
+
+        uint64 buckets[BUCKET_COUNT] = {};
+        uint64 count = 0;
+        uint64 sum = 0;
+        uint64 max = 0;
+
+        void Record(uint64 value) {
+            const uint32 bucket = value == 0 ? 0 : 64 - detail::count_leading_zeros(value);
+            buckets[std::min(bucket, BUCKET_COUNT - 1)] += 1;
+            count += 1;
+            sum += value;
+            max = std::max(max, value);
+        }
+
+        void Merge(const RiftSizeDistribution& other) {
+            for (uint32 i = 0; i < BUCKET_COUNT; ++i) buckets[i] += other.buckets[i];
+            count += other.count;
+            sum += other.sum;
+            max = std::max(max, other.max);
+        }
+
+        double GetMean() const { return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0; }
+
+        // Upper bound of the bucket containing the given percentile (0-100).
+        uint64 GetPercentile(double percentile) const {
+            if (count == 0) return 0;
+            const uint64 target = static_cast<uint64>(static_cast<double>(count) * percentile / 100.0);
+            uint64 seen = 0;
+            for (uint32 i = 0; i < BUCKET_COUNT; ++i) {
+                seen += buckets[i];
+                if (seen > target) return i == 0 ? 0 : std::min<uint64>(max, (uint64(1) << i) - 1);
+            }
+            return max;
+        }
+    };
+
+    // --- Static layout ---
+
+    struct RiftFieldLayout {
+        uint32 field_index;    // Into RiftSchemaInfo::fields
+        uint32 slot_size;      // Inline bytes (an OffsetTableEntry for strings and arrays)
+        uint32 alignment;
+        uint32 padding_before; // Hole between the previous slot (or the header) and this one
+    };
+
+    struct RiftSchemaLayout {
+        std::vector<RiftFieldLayout> fields;  // By offset
+        uint32 slot_bytes = 0;                // Sum of the slot sizes
+        uint32 padding_bytes = 0;             // inline_size minus header and slots: holes plus tail
+        // Field indices sorted by alignment, then size, both descending. Empty
+        // when that order would not make the inline part smaller.
+        std::vector<uint32> suggested_order;
+        uint32 suggested_inline_size = 0;
+    };
+
+    inline uint32 rift_field_slot_size(const RiftFieldInfo& field) {
+        return static_cast<uint32>(IsVariableSizeFieldType(field.type) ? sizeof(OffsetTableEntry) : GetFieldTypeSize(field.type));
+    }
+
+    inline RiftSchemaLayout rift_analyze_schema_layout(const RiftSchemaInfo& schema) {
+        RiftSchemaLayout layout;
+        uint32 max_alignment = 1;
+        for (uint32 i = 0; i < schema.field_count; ++i) {
+            const uint32 alignment = static_cast<uint32>(std::max<size_t>(GetFieldTypeAlignment(schema.fields[i].type), 1));
+            layout.fields.push_back({ i, rift_field_slot_size(schema.fields[i]), alignment, 0 });
+            layout.slot_bytes += layout.fields.back().slot_size;
+            max_alignment = std::max(max_alignment, alignment);
+        }
+        layout.padding_bytes = schema.inline_size > sizeof(RiftObjectHeader) + layout.slot_bytes
+            ? schema.inline_size - static_cast<uint32>(sizeof(RiftObjectHeader)) - layout.slot_bytes : 0;
+
+        std::stable_sort(layout.fields.begin(), layout.fields.end(), [&](const RiftFieldLayout& a, const RiftFieldLayout& b) {
+            return schema.fields[a.field_index].offset < schema.fields[b.field_index].offset;
+        });
+        uint32 end = sizeof(RiftObjectHeader);
+        for (RiftFieldLayout& field : layout.fields) {
+            const uint32 offset = schema.fields[field.field_index].offset;
+            field.padding_before = offset > end ? offset - end : 0;
+            end = std::max(end, offset + field.slot_size);
+        }
+
+        // The header is 8-byte aligned and alignments are powers of two, so
+        // descending alignment leaves no holes between slots.
+        std::vector<RiftFieldLayout> packed = layout.fields;
+        std::stable_sort(packed.begin(), packed.end(), [](const RiftFieldLayout& a, const RiftFieldLayout& b) {
+            if (a.alignment != b.alignment) return a.alignment > b.alignment;
+            if (a.slot_size != b.slot_size) return a.slot_size > b.slot_size;
+            return a.field_index < b.field_index;
+        });
+        const auto packed_size = static_cast<uint32>(align_up(sizeof(RiftObjectHeader) + layout.slot_bytes, max_alignment));
+        if (packed_size < schema.inline_size) {
+            layout.suggested_inline_size = packed_size;
+            for (const RiftFieldLayout& field : packed) layout.suggested_order.push_back(field.field_index);
+        }
+        else {
+            layout.suggested_inline_size = schema.inline_size;
+        }
+        return layout;
+    }
+
+    // --- Corpus statistics ---
+
+    struct RiftFieldUsage {
+        uint64 present = 0;        // Objects large enough to hold the slot
+        uint64 defaults = 0;       // All-zero slot, or empty string / array
+        uint64 variable_bytes = 0; // String bytes (with terminator) or array element bytes
+        uint64 invalid = 0;        // String / array data outside the object
+        RiftSizeDistribution lengths; // String characters or array elements, per occurrence
+        double min_value = std::numeric_limits<double>::infinity();  // Over numeric slots and vector components
+        double max_value = -std::numeric_limits<double>::infinity();
+
+        bool HasRange() const { return min_value <= max_value; }
+        double GetDefaultShare() const { return present ? static_cast<double>(defaults) / static_cast<double>(present) : 0.0; }
+
+        void Merge(const RiftFieldUsage& other) {
+            present += other.present;
+            defaults += other.defaults;
+            variable_bytes += other.variable_bytes;
+            invalid += other.invalid;
+            lengths.Merge(other.lengths);
+            min_value = std::min(min_value, other.min_value);
+            max_value = std::max(max_value, other.max_value);
+        }
+    };
+
+    struct RiftSchemaUsage {
+        uint32 schema_id = 0;
+        const RiftSchemaInfo* schema = nullptr; // Null if the schema is not registered
+        uint64 objects = 0;
+        uint64 bytes = 0;          // Sum of total_size
+        uint64 stream_bytes = 0;   // Same, padded to 8 as stored in a stream
+        uint64 truncated = 0;      // Objects smaller than the schema's inline_size (fields not analyzed)
+        RiftSizeDistribution object_sizes;
+        std::vector<RiftFieldUsage> fields; // Parallel to schema->fields
+
+        uint64 GetVariableBytes() const {
+            uint64 total = 0;
+            for (const RiftFieldUsage& field : fields) total += field.variable_bytes;
+            return total;
+        }
+
+        void Merge(const RiftSchemaUsage& other) {
+            objects += other.objects;
+            bytes += other.bytes;
+            stream_bytes += other.stream_bytes;
+            truncated += other.truncated;
+            object_sizes.Merge(other.object_sizes);
+            for (size_t i = 0; i < fields.size(); ++i) fields[i].Merge(other.fields[i]);
+        }
+    };
+
+    // --- RiftSchemaCorpusStats ---
+    // Accumulates RiftSchemaUsage per schema_id. Not thread-safe; use one per
+    // task and Merge().
+    class RiftSchemaCorpusStats {
+    public:
+        void Add(const RiftBufferViewBase& view) {
+            RiftSchemaUsage& usage = Find(view.GetSchemaId());
+            const uint32 total_size = view.GetTotalSize();
+            usage.objects += 1;
+            usage.bytes += total_size;
+            usage.stream_bytes += align_up(total_size, alignof(RiftObjectHeader));
+            usage.object_sizes.Record(total_size);
+            if (!usage.schema) return;
+            if (total_size < usage.schema->inline_size) {
+                usage.truncated += 1;
+                return;
+            }
+            for (uint32 i = 0; i < usage.schema->field_count; ++i) {
+                AddField(usage.schema->fields[i], view.GetBufferStart(), total_size, usage.fields[i]);
+            }
+        }
+
+        void Merge(const RiftSchemaCorpusStats& other) {
+            for (const RiftSchemaUsage& usage : other.m_schemas) Find(usage.schema_id).Merge(usage);
+        }
+
+        // Sorted by schema_id.
+        const std::vector<RiftSchemaUsage>& GetSchemas() const { return m_schemas; }
+
+        uint64 GetObjectCount() const {
+            uint64 total = 0;
+            for (const RiftSchemaUsage& usage : m_schemas) total += usage.objects;
+            return total;
+        }
+
+    private:
+        RiftSchemaUsage& Find(uint32 schema_id) {
+            // Streams tend to repeat a schema, so check the last one first.
+            if (m_last < m_schemas.size() && m_schemas[m_last].schema_id == schema_id) return m_schemas[m_last];
+            auto it = std::lower_bound(m_schemas.begin(), m_schemas.end(), schema_id,
+                [](const RiftSchemaUsage& u, uint32 id) { return u.schema_id < id; });
+            if (it == m_schemas.end() || it->schema_id != schema_id) {
+                RiftSchemaUsage usage;
+                usage.schema_id = schema_id;
+                usage.schema = RiftSchemaRegistry::Instance().Find(schema_id);
+                if (usage.schema) usage.fields.resize(usage.schema->field_count);
+                it = m_schemas.insert(it, std::move(usage));
+            }
+            m_last = static_cast<size_t>(it - m_schemas.begin());
+            return *it;
+        }
+
+        template<typename T>
+        static void RecordValue(const uint8* p, RiftFieldUsage& usage) {
+            const auto value = static_cast<double>(detail::load_little_endian<T>(p));
+            usage.min_value = std::min(usage.min_value, value);
+            usage.max_value = std::max(usage.max_value, value);
+        }
+
+        static void RecordScalar(RiftFieldType type, const uint8* p, RiftFieldUsage& usage) {
+            switch (type) {
+            case RiftFieldType::Bool:
+            case RiftFieldType::UInt8:  RecordValue<uint8>(p, usage); break;
+            case RiftFieldType::Int8:   RecordValue<int8>(p, usage); break;
+            case RiftFieldType::Int16:  RecordValue<int16>(p, usage); break;
+            case RiftFieldType::UInt16: RecordValue<uint16>(p, usage); break;
+            case RiftFieldType::Int32:  RecordValue<int32>(p, usage); break;
+            case RiftFieldType::UInt32: RecordValue<uint32>(p, usage); break;
+            case RiftFieldType::Int64:  RecordValue<int64>(p, usage); break;
+            case RiftFieldType::UInt64: RecordValue<uint64>(p, usage); break;
+            case RiftFieldType::Float:  RecordValue<float>(p, usage); break;
+            case RiftFieldType::Double: RecordValue<double>(p, usage); break;
+            default:
+                for (uint32 c = 0; c < GetFieldTypeComponents(type); ++c) RecordValue<float>(p + c * sizeof(float), usage);
+                break;
+            }
+        }
+
+        static void AddField(const RiftFieldInfo& field, const uint8* object, uint32 total_size, RiftFieldUsage& usage) {
+            const uint32 slot_size = rift_field_slot_size(field);
+            if (slot_size == 0 || static_cast<uint64>(field.offset) + slot_size > total_size) return;
+            const uint8* slot = object + field.offset;
+            usage.present += 1;
+
+            if (!IsVariableSizeFieldType(field.type)) {
+                bool is_default = true;
+                for (uint32 i = 0; i < slot_size && is_default; ++i) is_default = slot[i] == 0;
+                usage.defaults += is_default;
+                RecordScalar(field.type, slot, usage);
+                return;
+            }
+
+            const uint32 data_offset = detail::load_little_endian<uint32>(slot);
+            const uint32 count = detail::load_little_endian<uint32>(slot + sizeof(uint32));
+            usage.lengths.Record(count);
+            if (count == 0) {
+                usage.defaults += 1;
+                return;
+            }
+            const uint64 data_bytes = field.type == RiftFieldType::String
+                ? static_cast<uint64>(count) + 1
+                : static_cast<uint64>(count) * GetFieldTypeSize(field.element_type);
+            if (static_cast<uint64>(data_offset) + data_bytes > total_size) {
+                usage.invalid += 1;
+                return;
+            }
+            usage.variable_bytes += data_bytes;
+        }
+
+        std::vector<RiftSchemaUsage> m_schemas; // Sorted by schema_id
+        size_t m_last = 0;
+    };
+
+    // --- RiftSchemaAnalyzer ---
+    class RiftSchemaAnalyzer {
+    public:
+        explicit RiftSchemaAnalyzer(RiftTaskExecutor& executor, size_t task_bytes = 1u << 20)
+            : m_processor(executor, task_bytes) {}
+
+        // Adds every object of an 8-aligned object stream. Objects before a
+        // framing error are still counted (see RiftParallelResult).
+        RiftParallelResult AddStream(const void* data, size_t size) {
+            std::vector<RiftSchemaCorpusStats> tasks(m_processor.GetMaxTaskCount(size));
+            const RiftParallelResult result = m_processor.ForEachObjectByTask(data, size,
+                [&](const RiftBufferViewBase& view, size_t, uint32 task) { tasks[task].Add(view); });
+            for (uint32 task = 0; task < result.task_count; ++task) m_stats.Merge(tasks[task]);
+            return result;
+        }
+
+        // Maps a RiftLog file (object logs and replays alike) and adds its
+        // objects. A file without a log header is read as a bare object
+        // stream, e.g. a saved RiftBufferBuilder output. Returns false if the
+        // file cannot be opened or holds no valid object.
+        bool AddFile(const char* path, RiftParallelResult* result = nullptr) {
+            RiftParallelResult file_result;
+            RiftLogReader log;
+            if (log.Open(path)) {
+                const RiftMappedFile& file = log.GetMappedFile();
+                file_result = AddStream(file.GetData() + sizeof(RiftLogFileHeader), file.GetSize() - sizeof(RiftLogFileHeader));
+            }
+            else {
+                RiftMappedFile file;
+                if (!file.Open(path)) return false;
+                file_result = AddStream(file.GetData(), file.GetSize());
+            }
+            if (result) *result = file_result;
+            return file_result.object_count > 0;
+        }
+
+        const RiftSchemaCorpusStats& GetStats() const { return m_stats; }
+
+    private:
+        RiftParallelProcessor m_processor;
+        RiftSchemaCorpusStats m_stats;
+    };
+
+} // namespace RiftSerializer
@@ -0,0 +1,137 @@
+﻿// RiftSerializer/include/RiftSerializer/ParallelReplayDecoder.h
+//
+// Decodes a replay on all cores while the consumer still sees frames in tick
+// order.
+//
+// The replay is split into blocks at keyframe boundaries (from the keyframe
+// index), so every block can be decoded on its own: its first frame carries
+// the full state. Workers decode blocks into per-block output buffers; the
+// calling thread delivers them strictly in block order. At most
+// max_blocks_in_flight blocks are decoding or waiting to be delivered, which
+// bounds memory and throttles decoding to the consumer's pace.
+
+#pragma once
+
+#include "Replay.h"
+#include "../Runtime/TaskExecutor.h"
+#include <memory>
+#include <vector>
+
+namespace RiftSerializer {
+
+    struct RiftParallelReplayConfig {
+        uint32 keyframes_per_block = 1;
+        uint32 max_blocks_in_flight = 0;         // 0 = twice the executor's thread count
+        size_t block_output_capacity = 1u << 20; // Initial size of each block's output buffer
+    };
+
+    struct RiftParallelReplayStats {
+        uint64 frame_count = 0;
+        uint32 block_count = 0;
+        uint32 consumer_waits = 0; // Times the next block was not decoded yet when the consumer reached it
+    };
+
+    // --- RiftParallelReplayDecoder ---
+    class RiftParallelReplayDecoder {
+    public:
+        explicit RiftParallelReplayDecoder(RiftTaskExecutor& executor, const RiftParallelReplayConfig& config = RiftParallelReplayConfig())
+            : m_executor(executor), m_config(config) {
+            m_config.keyframes_per_block = std::max<uint32>(m_config.keyframes_per_block, 1);
+            if (m_config.max_blocks_in_flight == 0) m_config.max_blocks_in_flight = 2 * executor.GetThreadCount();
+        }
+
+        // Decodes every frame of the replay.
+        //
+        // decoder(const RiftReplayFrame& frame, RiftBufferBuilder& out) runs on
+        // a worker for each frame of a block, in order, and appends the
+        // frame's decoded objects to out. It is copied for every block, so it
+        // may keep state across the frames of a block (e.g. the keyframe state
+        // being patched by deltas).
+        //
+        // on_frame(const RiftReplayFrame& decoded) runs on the calling thread
+        // in tick order; decoded.payload holds the decoder's output for that
+        // frame and is valid only during the callback.
+        template<typename Decoder, typename Callback>
+        RiftParallelReplayStats Decode(const RiftReplayReader& reader, const Decoder& decoder, Callback&& on_frame) {
+            RiftParallelReplayStats stats;
+            const size_t keyframes = reader.GetKeyframeCount();
+            const size_t block_count = (keyframes + m_config.keyframes_per_block - 1) / m_config.keyframes_per_block;
+            stats.block_count = static_cast<uint32>(block_count);
+            if (block_count == 0) return stats;
+
+            const size_t window = std::min<size_t>(m_config.max_blocks_in_flight, block_count);
+            EnsureSlots(window);
+
+            auto job = [&](uint32 slot_index) {
+                Slot& slot = *m_slots[slot_index];
+                const size_t first = slot.block * m_config.keyframes_per_block;
+                const size_t next = first + m_config.keyframes_per_block;
+                const uint64 end = next < keyframes ? reader.GetKeyframeOffset(next) : UINT64_MAX;
+                Decoder local = decoder;
+                slot.output.Reset();
+                slot.frames.clear();
+                RiftReplayFrame frame;
+                for (uint64 offset = reader.GetKeyframeOffset(first); offset < end && reader.PeekFrame(offset, frame);
+                    offset += sizeof(RiftReplayFrameHeader) + frame.payload_size) {
+                    const size_t begin = slot.output.GetCurrentSize();
+                    local(frame, slot.output);
+                    slot.output.PadToAlignment(alignof(RiftObjectHeader));
+                    slot.frames.push_back({ frame.tick, frame.kind, begin, slot.output.GetCurrentSize() - begin });
+                }
+                // A decoder may reference frame data with AddArrayRef(); deliver contiguous bytes.
+                if (slot.output.HasExternalBlobs()) {
+                    slot.flat.resize(slot.output.GetCurrentSize());
+                    slot.output.Flatten(slot.flat.data());
+                }
+            };
+            auto submit = [&](size_t block) {
+                const auto slot_index = static_cast<uint32>(block % window);
+                m_slots[slot_index]->block = block;
+                m_executor.Submit(m_slots[slot_index]->group, job, slot_index);
+            };
+
+            for (size_t block = 0; block < window; ++block) submit(block);
+            for (size_t block = 0; block < block_count; ++block) {
+                Slot& slot = *m_slots[block % window];
+                if (!slot.group.IsDone()) {
+                    ++stats.consumer_waits;
+                    m_executor.Wait(slot.group);
+                }
+                const uint8* output = slot.output.HasExternalBlobs() ? slot.flat.data() : slot.output.GetBufferPointer();
+                for (const DecodedFrame& decoded : slot.frames) {
+                    on_frame(RiftReplayFrame{ decoded.tick, decoded.kind, output + decoded.offset, decoded.size });
+                }
+                stats.frame_count += slot.frames.size();
+                if (block + window < block_count) submit(block + window);
+            }
+            return stats;
+        }
+
+    private:
+        struct DecodedFrame {
+            uint64 tick;
+            RiftReplayFrameKind kind;
+            size_t offset; // Into the block's output
+            size_t size;
+        };
+
+        // Output buffers are reused across blocks and calls.
+        struct Slot {
+            explicit Slot(size_t capacity) : output(capacity) {}
+            RiftTaskGroup group;
+            size_t block = 0;
+            RiftBufferBuilder output;
+            std::vector<uint8> flat; // output flattened, when it holds external blobs
+            std::vector<DecodedFrame> frames;
+        };
+
+        void EnsureSlots(size_t count) {
+            while (m_slots.size() < count) m_slots.push_back(std::make_unique<Slot>(m_config.block_output_capacity));
+        }
+
+        RiftTaskExecutor& m_executor;
+        RiftParallelReplayConfig m_config;
+        std::vector<std::unique_ptr<Slot>> m_slots;
+    };
+
+} // namespace RiftSerializer
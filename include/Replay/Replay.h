@@ -0,0 +1,314 @@
+﻿// RiftSerializer/include/RiftSerializer/Replay.h
+//
+// Seekable replays on top of the object log.
+//
+// A replay is a RiftLog file of frames. Every frame is a RiftReplayFrameHeader
+// object followed by the frame's payload objects. Keyframes carry the full
+// state; deltas carry changes since the previous frame. Closing the writer
+// appends a keyframe index and a fixed-size trailer:
+//
+//   [log header][frame]...[frame][index object][trailer object]
+//
+// Seeking to a tick binary-searches the index, then decodes one keyframe and
+// at most keyframe_interval deltas, so seek cost does not depend on the
+// length of the replay.
+
+#pragma once
+
+#include "../LogWriter/LogWriter.h"
+#include <vector>
+
+namespace RiftSerializer {
+
+    // Reserved schema ids for the replay's own objects.
+    constexpr uint32 RIFT_REPLAY_FRAME_SCHEMA_ID = 0xFFFF0001;
+    constexpr uint32 RIFT_REPLAY_INDEX_SCHEMA_ID = 0xFFFF0002;
+    constexpr uint32 RIFT_REPLAY_TRAILER_SCHEMA_ID = 0xFFFF0003;
+
+    enum class RiftReplayFrameKind : uint32 {
+        Keyframe = 0,
+        Delta = 1,
+    };
+
+    struct alignas(8) RiftReplayFrameHeader {
+        RiftObjectHeader object; // schema_id = RIFT_REPLAY_FRAME_SCHEMA_ID
+        uint64 tick;
+        uint32 kind;             // RiftReplayFrameKind
+        uint32 payload_size;     // Bytes of payload objects that follow (a multiple of 8)
+    };
+    static_assert(sizeof(RiftReplayFrameHeader) == 32, "RiftReplayFrameHeader must be 32 bytes.");
+
+    // One entry per keyframe, sorted by tick.
+    struct alignas(8) RiftReplayIndexEntry {
+        uint64 tick;
+        uint64 offset; // File offset of the keyframe's RiftReplayFrameHeader
+    };
+    static_assert(sizeof(RiftReplayIndexEntry) == 16, "RiftReplayIndexEntry must be 16 bytes.");
+
+    // The last object of a cleanly closed replay.
+    struct alignas(8) RiftReplayTrailer {
+        RiftObjectHeader object; // schema_id = RIFT_REPLAY_TRAILER_SCHEMA_ID
+        uint64 index_offset;     // File offset of the index object
+        uint64 keyframe_count;
+    };
+    static_assert(sizeof(RiftReplayTrailer) == 32, "RiftReplayTrailer must be 32 bytes.");
+
+    // --- RiftReplayWriter ---
+    // Frames go through a RiftLogWriter, so the caller's thread only copies
+    // into its ring. Unlike a plain log, frames are never dropped: when the
+    // ring is full the writer waits for it to drain.
+    class RiftReplayWriter {
+    public:
+        explicit RiftReplayWriter(uint32 keyframe_interval = 300, const RiftLogWriterConfig& config = RiftLogWriterConfig())
+            : m_log(config), m_keyframe_interval(keyframe_interval) {
+        }
+        ~RiftReplayWriter() { Close(); }
+
+        bool Open(const char* path) {
+            Close();
+            m_index.clear();
+            m_offset = sizeof(RiftLogFileHeader);
+            m_has_frames = false;
+            return m_log.Open(path);
+        }
+
+        // True when the next frame at this tick should be a keyframe: for the
+        // first frame and once keyframe_interval ticks have passed since the last one.
+        bool IsKeyframeDue(uint64 tick) const {
+            return m_index.empty() || tick - m_index.back().tick >= m_keyframe_interval;
+        }
+
+        // state/delta hold the frame's payload objects, as built by the caller.
+        bool WriteKeyframe(uint64 tick, const RiftBufferBuilder& state) {
+            const uint64 offset = m_offset;
+            if (!WriteFrame(tick, RiftReplayFrameKind::Keyframe, state)) return false;
+            m_index.push_back({ tick, offset });
+            return true;
+        }
+
+        bool WriteDelta(uint64 tick, const RiftBufferBuilder& delta) {
+            RIFT_ASSERT(!m_index.empty(), "A replay must start with a keyframe.");
+            return WriteFrame(tick, RiftReplayFrameKind::Delta, delta);
+        }
+
+        // Appends the keyframe index and trailer, then flushes and closes the log.
+        bool Close() {
+            if (!m_log.IsOpen()) return false;
+
+            RiftBufferBuilder builder(sizeof(RiftObjectHeader) + m_index.size() * sizeof(RiftReplayIndexEntry) + sizeof(RiftReplayTrailer));
+            const size_t index_start = builder.BeginObject();
+            builder.Reserve(sizeof(RiftObjectHeader));
+            for (const RiftReplayIndexEntry& entry : m_index) {
+                RiftReplayIndexEntry stored;
+                stored.tick = to_little_endian(entry.tick);
+                stored.offset = to_little_endian(entry.offset);
+                builder.WriteRaw(&stored, sizeof(stored));
+            }
+            builder.EndObject(index_start, RIFT_REPLAY_INDEX_SCHEMA_ID);
+
+            RiftReplayTrailer trailer{};
+            trailer.index_offset = to_little_endian(m_offset);
+            trailer.keyframe_count = to_little_endian(static_cast<uint64>(m_index.size()));
+            const size_t trailer_start = builder.BeginObject();
+            builder.WriteRaw(&trailer, sizeof(trailer));
+            builder.EndObject(trailer_start, RIFT_REPLAY_TRAILER_SCHEMA_ID);
+
+            const bool ok = AppendBlocking(builder.GetCurrentSize(), [&] { return m_log.Append(builder); });
+            m_log.Close();
+            return ok && !m_log.HasFailed();
+        }
+
+        bool IsOpen() const { return m_log.IsOpen(); }
+        size_t GetKeyframeCount() const { return m_index.size(); }
+        const RiftLogWriter& GetLogWriter() const { return m_log; }
+
+    private:
+        bool WriteFrame(uint64 tick, RiftReplayFrameKind kind, const RiftBufferBuilder& payload) {
+            RIFT_ASSERT(!m_has_frames || tick >= m_last_tick, "Replay ticks must not go backwards.");
+            const size_t payload_size = align_up(payload.GetCurrentSize(), alignof(RiftObjectHeader));
+            if (payload_size > UINT32_MAX) return false;
+
+            RiftReplayFrameHeader header{};
+            header.object.magic = to_little_endian(RIFT_MAGIC_NUMBER);
+            header.object.schema_id = to_little_endian(RIFT_REPLAY_FRAME_SCHEMA_ID);
+            header.object.total_size = to_little_endian(static_cast<uint32>(sizeof(header)));
+            header.tick = to_little_endian(tick);
+            header.kind = to_little_endian(static_cast<uint32>(kind));
+            header.payload_size = to_little_endian(static_cast<uint32>(payload_size));
+
+            // Header and payload go into the log as one unit: a frame header is
+            // never written without the payload_size bytes it announces.
+            m_slices.clear();
+            m_slices.push_back({ &header, sizeof(header) });
+            payload.GetIoSlices(m_slices);
+            if (!AppendBlocking(sizeof(header) + payload.GetCurrentSize(), [&] { return m_log.Append(m_slices.data(), m_slices.size()); })) {
+                return false;
+            }
+            m_last_tick = tick;
+            m_has_frames = true;
+            return true;
+        }
+
+        // Retries append() (one RiftLogWriter::Append of size bytes) until the ring has room.
+        template<typename Append>
+        bool AppendBlocking(size_t size, Append&& append) {
+            if (align_up(size, alignof(RiftObjectHeader)) > m_log.GetQueueCapacity()) return false;
+            while (!append()) {
+                if (m_log.HasFailed()) return false;
+                std::this_thread::yield();
+            }
+            m_offset += align_up(size, alignof(RiftObjectHeader));
+            return true;
+        }
+
+        RiftLogWriter m_log;
+        uint32 m_keyframe_interval;
+        uint64 m_offset = 0;      // File offset of the next appended byte
+        uint64 m_last_tick = 0;
+        bool m_has_frames = false;
+        std::vector<RiftReplayIndexEntry> m_index; // Host byte order until written by Close()
+        std::vector<RiftIoSlice> m_slices;         // Reused gather list of WriteFrame()
+    };
+
+    // --- RiftReplayFrame ---
+    // A decoded frame. payload points into the mapped replay.
+    struct RiftReplayFrame {
+        uint64 tick;
+        RiftReplayFrameKind kind;
+        const uint8* payload;
+        size_t payload_size;
+
+        // Calls visitor(const RiftBufferViewBase&) for every payload object.
+        // Each object header is checked against the rest of the payload
+        // first; returns false (after visiting the objects before it) at the
+        // first corrupt one.
+        template<typename Visitor>
+        bool ForEachObject(Visitor&& visitor) const {
+            for (size_t offset = 0; offset + sizeof(RiftObjectHeader) <= payload_size;) {
+                const uint32 total_size = rift_verify_object_header(payload + offset, payload_size - offset);
+                if (total_size == 0) return false;
+                visitor(RiftBufferViewBase(payload + offset));
+                offset = align_up(offset + total_size, alignof(RiftObjectHeader));
+            }
+            return true;
+        }
+    };
+
+    // --- RiftReplayReader ---
+    // Maps a replay and plays it back from any tick. A replay without a valid
+    // trailer (e.g. the recorder crashed) is still readable: Open() then
+    // rebuilds the keyframe index with one pass over the frame headers.
+    class RiftReplayReader {
+    public:
+        bool Open(const char* path) {
+            m_index = nullptr;
+            m_keyframe_count = 0;
+            m_rebuilt_index.clear();
+            if (!m_log.Open(path)) return false;
+            if (!LoadIndex()) RebuildIndex();
+            m_log.Seek(sizeof(RiftLogFileHeader));
+            return true;
+        }
+
+        void Close() { m_log.Close(); }
+
+        size_t GetKeyframeCount() const { return m_keyframe_count; }
+        uint64 GetKeyframeTick(size_t index) const { return from_little_endian(m_index[index].tick); }
+        // File offset of the keyframe's frame header.
+        uint64 GetKeyframeOffset(size_t index) const { return from_little_endian(m_index[index].offset); }
+
+        // Positions playback at the given tick: calls on_frame(const RiftReplayFrame&)
+        // for the last keyframe at or before tick and every delta after it up
+        // to and including tick. Returns false if no keyframe precedes tick.
+        template<typename Callback>
+        bool Seek(uint64 tick, Callback&& on_frame) {
+            const RiftReplayIndexEntry* end = m_index + m_keyframe_count;
+            const RiftReplayIndexEntry* it = std::upper_bound(m_index, end, tick,
+                [](uint64 t, const RiftReplayIndexEntry& e) { return t < from_little_endian(e.tick); });
+            if (it == m_index) return false;
+            --it;
+
+            m_log.Seek(from_little_endian(it->offset));
+            RiftReplayFrame frame;
+            while (PeekFrame(m_log.GetOffset(), frame) && frame.tick <= tick) {
+                on_frame(frame);
+                SkipFrame(frame);
+            }
+            return true;
+        }
+
+        // Delivers the frame after the current position. Returns false at the end of the replay.
+        template<typename Callback>
+        bool NextFrame(Callback&& on_frame) {
+            RiftReplayFrame frame;
+            if (!PeekFrame(m_log.GetOffset(), frame)) return false;
+            on_frame(frame);
+            SkipFrame(frame);
+            return true;
+        }
+
+        const RiftLogReader& GetLogReader() const { return m_log; }
+
+        // Decodes the frame header at a file offset without moving the
+        // playback position. Returns false if no complete frame starts there.
+        // Only reads the mapping, so several threads may call it at once.
+        bool PeekFrame(uint64 offset, RiftReplayFrame& frame) const {
+            const auto* header = static_cast<const RiftReplayFrameHeader*>(m_log.PeekAt(offset));
+            if (!header || from_little_endian(header->object.schema_id) != RIFT_REPLAY_FRAME_SCHEMA_ID ||
+                from_little_endian(header->object.total_size) != sizeof(RiftReplayFrameHeader)) {
+                return false;
+            }
+            frame.tick = from_little_endian(header->tick);
+            frame.kind = static_cast<RiftReplayFrameKind>(from_little_endian(header->kind));
+            frame.payload = reinterpret_cast<const uint8*>(header) + sizeof(RiftReplayFrameHeader);
+            frame.payload_size = from_little_endian(header->payload_size);
+            return offset + sizeof(RiftReplayFrameHeader) + frame.payload_size <= m_log.GetMappedFile().GetSize();
+        }
+
+    private:
+
+        void SkipFrame(const RiftReplayFrame& frame) {
+            m_log.Seek(m_log.GetOffset() + sizeof(RiftReplayFrameHeader) + frame.payload_size);
+        }
+
+        bool LoadIndex() {
+            const RiftMappedFile& file = m_log.GetMappedFile();
+            if (file.GetSize() < sizeof(RiftLogFileHeader) + sizeof(RiftReplayTrailer)) return false;
+            const uint64 trailer_offset = file.GetSize() - sizeof(RiftReplayTrailer);
+            const auto* trailer = static_cast<const RiftReplayTrailer*>(m_log.PeekAt(trailer_offset));
+            if (!trailer || from_little_endian(trailer->object.schema_id) != RIFT_REPLAY_TRAILER_SCHEMA_ID) return false;
+
+            const uint64 count = from_little_endian(trailer->keyframe_count);
+            const auto* index = static_cast<const RiftObjectHeader*>(m_log.PeekAt(from_little_endian(trailer->index_offset)));
+            if (!index || from_little_endian(index->schema_id) != RIFT_REPLAY_INDEX_SCHEMA_ID) return false;
+            const uint32 total_size = from_little_endian(index->total_size);
+            // Bound count before multiplying so a corrupt trailer cannot wrap the size check.
+            if (total_size < sizeof(RiftObjectHeader) ||
+                count > (total_size - sizeof(RiftObjectHeader)) / sizeof(RiftReplayIndexEntry) ||
+                total_size != sizeof(RiftObjectHeader) + count * sizeof(RiftReplayIndexEntry)) {
+                return false;
+            }
+            m_index = reinterpret_cast<const RiftReplayIndexEntry*>(index + 1);
+            m_keyframe_count = static_cast<size_t>(count);
+            return true;
+        }
+
+        void RebuildIndex() {
+            RiftReplayFrame frame;
+            for (uint64 offset = sizeof(RiftLogFileHeader); PeekFrame(offset, frame);
+                offset += sizeof(RiftReplayFrameHeader) + frame.payload_size) {
+                if (frame.kind == RiftReplayFrameKind::Keyframe) {
+                    m_rebuilt_index.push_back({ to_little_endian(frame.tick), to_little_endian(offset) });
+                }
+            }
+            m_index = m_rebuilt_index.data();
+            m_keyframe_count = m_rebuilt_index.size();
+        }
+
+        RiftLogReader m_log;
+        const RiftReplayIndexEntry* m_index = nullptr; // Little-endian entries, in the mapping or m_rebuilt_index
+        size_t m_keyframe_count = 0;
+        std::vector<RiftReplayIndexEntry> m_rebuilt_index;
+    };
+
+} // namespace RiftSerializer
@@ -0,0 +1,198 @@
+﻿// RiftSerializer/include/RiftSerializer/ParallelProcessor.h
+//
+// Parallel verification and processing of large object streams (replay
+// chunks, snapshot extents, archive payloads) and of batches of objects.
+//
+// A stream is split into tasks of about task_bytes at object boundaries. The
+// split only reads and checks headers (magic, size, bounds), and each range is
+// submitted as soon as it is found, so workers start while it is still
+// running. The tasks run the visitor on their objects in parallel.
+//
+// The visitor is called concurrently from several threads. If it returns
+// bool, false counts the object as failed. MapOrdered() collects one result
+// per object and hands them to a sink on the calling thread in stream order,
+// so its output does not depend on the thread count.
+
+#pragma once
+
+#include "TaskExecutor.h"
+#include "../Accessor/Accessor.h"
+#include <type_traits>
+#include <vector>
+
+namespace RiftSerializer {
+
+    struct RiftParallelResult {
+        uint64 object_count = 0;
+        uint64 failed_count = 0;       // Objects the visitor rejected (or, for batches, with a bad header)
+        uint32 task_count = 0;
+        bool framing_valid = true;     // False if a header was corrupt; objects before it were still processed
+        size_t first_error_offset = 0; // Lowest offset (or batch index) of a framing error or rejected object
+
+        bool IsValid() const { return framing_valid && failed_count == 0; }
+    };
+
+    // --- RiftParallelProcessor ---
+    class RiftParallelProcessor {
+    public:
+        explicit RiftParallelProcessor(RiftTaskExecutor& executor, size_t task_bytes = 1u << 20)
+            : m_executor(executor), m_task_bytes(std::max<size_t>(task_bytes, 4096)) {}
+
+        // Verifies every object of the stream and calls
+        // visitor(const RiftBufferViewBase&, size_t offset) on it, concurrently.
+        template<typename Visitor>
+        RiftParallelResult ForEachObject(const void* data, size_t size, Visitor&& visitor) {
+            return ProcessStream(static_cast<const uint8*>(data), size, [&](const RiftBufferViewBase& view, size_t offset, uint32) {
+                return Invoke(visitor, view, offset);
+            });
+        }
+
+        // Like ForEachObject, but calls visitor(const RiftBufferViewBase&, size_t offset,
+        // uint32 task) with the index of the task running it, which is below
+        // GetMaxTaskCount(size). Objects of one task are visited on one thread
+        // in stream order, so per-task state needs no synchronization.
+        template<typename Visitor>
+        RiftParallelResult ForEachObjectByTask(const void* data, size_t size, Visitor&& visitor) {
+            return ProcessStream(static_cast<const uint8*>(data), size, [&](const RiftBufferViewBase& view, size_t offset, uint32 task) {
+                if constexpr (std::is_same_v<std::invoke_result_t<Visitor&, const RiftBufferViewBase&, size_t, uint32>, bool>) {
+                    return visitor(view, offset, task);
+                }
+                else {
+                    visitor(view, offset, task);
+                    return true;
+                }
+            });
+        }
+
+        // Upper bound on the number of tasks a stream of size bytes is split into.
+        // Every task but the last covers at least task_bytes.
+        size_t GetMaxTaskCount(size_t size) const { return size / m_task_bytes + 1; }
+
+        // Calls map(const RiftBufferViewBase&, size_t offset) -> Result on every
+        // object in parallel, then sink(Result&&) for each on the calling
+        // thread, in stream order. Results are held until the stream is done.
+        template<typename Result, typename Map, typename Sink>
+        RiftParallelResult MapOrdered(const void* data, size_t size, Map&& map, Sink&& sink) {
+            std::vector<std::vector<Result>> results(GetMaxTaskCount(size));
+            const RiftParallelResult result = ProcessStream(static_cast<const uint8*>(data), size,
+                [&](const RiftBufferViewBase& view, size_t offset, uint32 task) {
+                    results[task].push_back(map(view, offset));
+                    return true;
+                });
+            for (uint32 task = 0; task < result.task_count; ++task) {
+                for (Result& value : results[task]) sink(std::move(value));
+            }
+            return result;
+        }
+
+        // Batch form: objects[i] points at a complete object. offset is the index.
+        template<typename Visitor>
+        RiftParallelResult ForEachObject(const void* const* objects, size_t count, Visitor&& visitor) {
+            const size_t per_task = std::max<size_t>(m_task_bytes / 256, 1);
+            const size_t task_count = (count + per_task - 1) / per_task;
+            std::vector<TaskState> tasks(task_count);
+            auto job = [&](uint32 task) {
+                TaskState& state = tasks[task];
+                for (size_t i = state.begin; i < state.end; ++i) {
+                    const auto* object = static_cast<const uint8*>(objects[i]);
+                    ++state.objects;
+                    if (!object || rift_verify_object_header(object, SIZE_MAX) == 0 || !Invoke(visitor, RiftBufferViewBase(object), i)) {
+                        state.Fail(i);
+                    }
+                }
+            };
+            RiftTaskGroup group;
+            for (size_t t = 0; t < task_count; ++t) {
+                tasks[t].begin = t * per_task;
+                tasks[t].end = std::min(count, tasks[t].begin + per_task);
+                m_executor.Submit(group, job, static_cast<uint32>(t));
+            }
+            m_executor.Wait(group);
+            return Combine(tasks, task_count, true, SIZE_MAX);
+        }
+
+    private:
+        struct TaskState {
+            size_t begin = 0;
+            size_t end = 0;
+            uint64 objects = 0;
+            uint64 failed = 0;
+            size_t first_failure = SIZE_MAX;
+
+            void Fail(size_t offset) {
+                if (failed++ == 0) first_failure = offset;
+            }
+        };
+
+        template<typename Visitor>
+        static bool Invoke(Visitor& visitor, const RiftBufferViewBase& view, size_t offset) {
+            if constexpr (std::is_same_v<std::invoke_result_t<Visitor&, const RiftBufferViewBase&, size_t>, bool>) {
+                return visitor(view, offset);
+            }
+            else {
+                visitor(view, offset);
+                return true;
+            }
+        }
+
+        template<typename Body>
+        RiftParallelResult ProcessStream(const uint8* data, size_t size, Body&& body) {
+            std::vector<TaskState> tasks(GetMaxTaskCount(size));
+            // Framing was verified by the split; the task re-reads headers
+            // (now cached) and runs the visitor.
+            auto job = [&](uint32 task) {
+                TaskState& state = tasks[task];
+                for (size_t offset = state.begin; offset < state.end;) {
+                    const RiftBufferViewBase view(data + offset);
+                    if (!body(view, offset, task)) state.Fail(offset);
+                    ++state.objects;
+                    offset = align_up(offset + view.GetTotalSize(), alignof(RiftObjectHeader));
+                }
+            };
+
+            RiftTaskGroup group;
+            uint32 task_count = 0;
+            bool framing_valid = true;
+            size_t error_offset = SIZE_MAX;
+            size_t begin = 0;
+            size_t offset = 0;
+            while (offset < size) {
+                const uint32 total_size = rift_verify_object_header(data + offset, size - offset);
+                if (total_size == 0) {
+                    framing_valid = false;
+                    error_offset = offset;
+                    break;
+                }
+                offset = std::min(align_up(offset + total_size, alignof(RiftObjectHeader)), size);
+                if (offset - begin >= m_task_bytes) {
+                    tasks[task_count] = { begin, offset };
+                    m_executor.Submit(group, job, task_count++);
+                    begin = offset;
+                }
+            }
+            if (offset > begin) {
+                tasks[task_count] = { begin, offset };
+                m_executor.Submit(group, job, task_count++);
+            }
+            m_executor.Wait(group);
+            return Combine(tasks, task_count, framing_valid, error_offset);
+        }
+
+        static RiftParallelResult Combine(const std::vector<TaskState>& tasks, size_t task_count, bool framing_valid, size_t error_offset) {
+            RiftParallelResult result;
+            result.task_count = static_cast<uint32>(task_count);
+            result.framing_valid = framing_valid;
+            for (size_t t = 0; t < task_count; ++t) {
+                result.object_count += tasks[t].objects;
+                result.failed_count += tasks[t].failed;
+                error_offset = std::min(error_offset, tasks[t].first_failure);
+            }
+            result.first_error_offset = error_offset == SIZE_MAX ? 0 : error_offset;
+            return result;
+        }
+
+        RiftTaskExecutor& m_executor;
+        size_t m_task_bytes;
+    };
+
+} // namespace RiftSerializer
@@ -0,0 +1,197 @@
+﻿// RiftSerializer/include/RiftSerializer/TaskExecutor.h
+//
+// A small work-stealing thread pool for data-parallel batch work (parallel
+// verification, replay decoding). Every worker owns a deque: it pops its own
+// tasks from the back and, when that is empty, steals from the front of the
+// others. Tasks submitted from a worker go to that worker's own deque, so a
+// task that fans out keeps its children hot in the same cache while idle
+// workers take the oldest ones; other threads spread their tasks round-robin.
+// The thread that waits on a task group runs tasks too, so an
+// executor with N threads starts N - 1 workers.
+//
+// Tasks are a function pointer, a context pointer and an index, so submitting
+// one never allocates beyond the deque itself.
+
+#pragma once
+
+#include "../Common/Common.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace RiftSerializer {
+
+    // Counts the unfinished tasks of one batch. Pass it to Submit() and wait
+    // for it with RiftTaskExecutor::Wait().
+    class RiftTaskGroup {
+    public:
+        bool IsDone() const { return m_pending.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class RiftTaskExecutor;
+        std::atomic<uint32> m_pending{ 0 };
+    };
+
+    // --- RiftTaskExecutor ---
+    class RiftTaskExecutor {
+    public:
+        using TaskFunction = void (*)(void* context, uint32 index);
+
+        // thread_count includes the waiting thread; 0 means one per hardware thread.
+        explicit RiftTaskExecutor(uint32 thread_count = 0) {
+            if (thread_count == 0) thread_count = std::max<uint32>(std::thread::hardware_concurrency(), 1);
+            m_thread_count = thread_count;
+            const uint32 worker_count = thread_count - 1;
+            for (uint32 i = 0; i < std::max<uint32>(worker_count, 1); ++i) {
+                m_queues.push_back(std::make_unique<WorkQueue>());
+            }
+            for (uint32 i = 0; i < worker_count; ++i) {
+                m_workers.emplace_back([this, i] { Work(i); });
+            }
+        }
+
+        ~RiftTaskExecutor() {
+            {
+                std::lock_guard<std::mutex> lock(m_sleep_mutex);
+                m_stopping = true;
+            }
+            m_work_ready.notify_all();
+            for (auto& worker : m_workers) worker.join();
+        }
+
+        RiftTaskExecutor(const RiftTaskExecutor&) = delete;
+        RiftTaskExecutor& operator=(const RiftTaskExecutor&) = delete;
+
+        uint32 GetThreadCount() const { return m_thread_count; }
+        // Tasks a worker took from another worker's deque.
+        uint64 GetStealCount() const { return m_steals.load(std::memory_order_relaxed); }
+
+        // Queues function(context, index). Thread-safe; tasks may submit more tasks.
+        void Submit(RiftTaskGroup& group, TaskFunction function, void* context, uint32 index) {
+            group.m_pending.fetch_add(1, std::memory_order_relaxed);
+            const WorkerIdentity& worker = CurrentWorker();
+            const uint32 target = worker.executor == this
+                ? worker.index
+                : static_cast<uint32>(m_next_queue.fetch_add(1, std::memory_order_relaxed) % m_queues.size());
+            WorkQueue& queue = *m_queues[target];
+            {
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                queue.tasks.push_back({ function, context, &group, index });
+            }
+            m_queued.fetch_add(1, std::memory_order_seq_cst);
+            if (m_sleeping.load(std::memory_order_seq_cst) > 0) {
+                std::lock_guard<std::mutex> lock(m_sleep_mutex);
+                m_work_ready.notify_one();
+            }
+        }
+
+        // Queues job(index) for a callable that outlives the group.
+        template<typename Job>
+        void Submit(RiftTaskGroup& group, Job& job, uint32 index) {
+            Submit(group, [](void* context, uint32 i) { (*static_cast<Job*>(context))(i); }, &job, index);
+        }
+
+        // Runs queued tasks on the calling thread until every task of the
+        // group has finished.
+        void Wait(RiftTaskGroup& group) {
+            while (!group.IsDone()) {
+                Task task;
+                if (Steal(static_cast<uint32>(m_queues.size()), task)) {
+                    Run(task);
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+    private:
+        struct Task {
+            TaskFunction function;
+            void* context;
+            RiftTaskGroup* group;
+            uint32 index;
+        };
+
+        // Which executor's worker, if any, the current thread is.
+        struct WorkerIdentity {
+            const RiftTaskExecutor* executor = nullptr;
+            uint32 index = 0;
+        };
+
+        static WorkerIdentity& CurrentWorker() {
+            static thread_local WorkerIdentity identity;
+            return identity;
+        }
+
+        struct alignas(RIFT_CACHE_LINE_SIZE) WorkQueue {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        void Run(const Task& task) {
+            task.function(task.context, task.index);
+            task.group->m_pending.fetch_sub(1, std::memory_order_acq_rel);
+        }
+
+        bool PopOwn(uint32 self, Task& task) {
+            WorkQueue& queue = *m_queues[self];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty()) return false;
+            task = queue.tasks.back();
+            queue.tasks.pop_back();
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        // Takes the oldest task of any queue other than self.
+        bool Steal(uint32 self, Task& task) {
+            const auto count = static_cast<uint32>(m_queues.size());
+            for (uint32 i = 1; i <= count; ++i) {
+                const uint32 victim = (self + i) % count;
+                if (victim == self) continue;
+                WorkQueue& queue = *m_queues[victim];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                if (queue.tasks.empty()) continue;
+                task = queue.tasks.front();
+                queue.tasks.pop_front();
+                m_queued.fetch_sub(1, std::memory_order_relaxed);
+                if (self + 1 < m_thread_count) m_steals.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            return false;
+        }
+
+        void Work(uint32 self) {
+            CurrentWorker() = { this, self };
+            for (;;) {
+                Task task;
+                if (PopOwn(self, task) || Steal(self, task)) {
+                    Run(task);
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(m_sleep_mutex);
+                m_sleeping.fetch_add(1, std::memory_order_seq_cst);
+                m_work_ready.wait(lock, [&] { return m_stopping || m_queued.load(std::memory_order_seq_cst) > 0; });
+                m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+                if (m_stopping) return;
+            }
+        }
+
+        uint32 m_thread_count = 1;
+        std::vector<std::unique_ptr<WorkQueue>> m_queues;
+        std::vector<std::thread> m_workers;
+        alignas(RIFT_CACHE_LINE_SIZE) std::atomic<uint32> m_next_queue{ 0 };
+        std::atomic<uint64> m_steals{ 0 };
+        alignas(RIFT_CACHE_LINE_SIZE) std::atomic<int64> m_queued{ 0 };
+        std::atomic<uint32> m_sleeping{ 0 };
+        std::mutex m_sleep_mutex;
+        std::condition_variable m_work_ready;
+        bool m_stopping = false;
+    };
+
+} // namespace RiftSerializer
@@ -0,0 +1,273 @@
+﻿// RiftSerializer/include/RiftSerializer/Snapshot.h
+//
+// Page-aligned snapshot files for cache-bypassing bulk loads.
+//
+// Layout (every part starts on a page boundary and is a whole number of pages):
+//   [RiftSnapshotHeader, padded][extent 0][extent 1]...[extent table, padded]
+//
+// An extent is a run of 8-byte aligned objects built in a RiftBufferBuilder
+// and padded to the page size by the builder itself, so the file can be read
+// with O_DIRECT in large page-multiple chunks straight into a huge-page
+// buffer and then viewed in place.
+
+#pragma once
+
+#include "../Builder/Builder.h"
+#include "../Memory/HugePageBuffer.h"
+#include "../Platform/File.h"
+#include <vector>
+
+namespace RiftSerializer {
+
+    // 'RFSS' in Little Endian (version 1)
+    constexpr uint32 RIFT_SNAPSHOT_MAGIC_NUMBER = 0x53534652;
+    constexpr uint32 RIFT_SNAPSHOT_VERSION = 1;
+
+    struct alignas(8) RiftSnapshotHeader {
+        uint32 magic;               // 'RFSS'
+        uint32 version;
+        uint32 page_size;           // Alignment of every extent
+        uint32 extent_count;
+        uint64 object_count;
+        uint64 extent_table_offset; // File offset of the RiftSnapshotExtent table
+        uint64 file_size;           // Total file size (a multiple of page_size)
+    };
+    static_assert(sizeof(RiftSnapshotHeader) == 40, "RiftSnapshotHeader must be 40 bytes.");
+
+    struct alignas(8) RiftSnapshotExtent {
+        uint64 offset;       // File offset (page-aligned)
+        uint64 size;         // Bytes used by objects, excluding trailing padding
+        uint64 object_count;
+    };
+    static_assert(sizeof(RiftSnapshotExtent) == 24, "RiftSnapshotExtent must be 24 bytes.");
+
+    // --- RiftSnapshotWriter ---
+    // Objects are built directly into GetBuilder() (or copied in with Add());
+    // once the current extent reaches extent_size it is padded to a page
+    // boundary and written out.
+    class RiftSnapshotWriter {
+    public:
+        explicit RiftSnapshotWriter(size_t extent_size = 4u << 20, uint32 page_size = 4096)
+            : m_builder(extent_size + page_size), m_extent_size(extent_size), m_page_size(page_size) {
+            RIFT_ASSERT((page_size & (page_size - 1)) == 0 && page_size >= sizeof(RiftSnapshotHeader), "Page size must be a power of two.");
+        }
+        ~RiftSnapshotWriter() { Finish(); }
+
+        bool Open(const char* path) {
+            m_extents.clear();
+            m_builder.Reset();
+            m_object_count = 0;
+            m_file_offset = m_page_size; // Page 0 holds the header, written by Finish().
+            return m_file.Open(path, RiftFileMode::Write);
+        }
+
+        // The builder for the current extent. After building one or more
+        // objects into it, call Commit().
+        RiftBufferBuilder& GetBuilder() { return m_builder; }
+
+        // Seals the current extent if it has reached extent_size.
+        bool Commit() {
+            return m_builder.GetCurrentSize() < m_extent_size || SealExtent();
+        }
+
+        // Copies one finished object into the current extent.
+        bool Add(const void* object) {
+            const RiftBufferViewBase view(object);
+            m_builder.BeginObject();
+            m_builder.WriteRaw(object, view.GetTotalSize());
+            return Commit();
+        }
+
+        bool Finish() {
+            if (!m_file.IsOpen()) return false;
+            bool ok = m_builder.GetCurrentSize() == 0 || SealExtent();
+
+            // Extent table
+            m_builder.Reset();
+            m_builder.WriteRaw(m_extents.data(), m_extents.size() * sizeof(RiftSnapshotExtent));
+            m_builder.PadToAlignment(m_page_size);
+            const uint64 table_offset = m_file_offset;
+            ok = ok && WritePages(GetBuiltData());
+
+            // Header page
+            RiftSnapshotHeader header{};
+            header.magic = to_little_endian(RIFT_SNAPSHOT_MAGIC_NUMBER);
+            header.version = to_little_endian(RIFT_SNAPSHOT_VERSION);
+            header.page_size = to_little_endian(m_page_size);
+            header.extent_count = to_little_endian(static_cast<uint32>(m_extents.size()));
+            header.object_count = to_little_endian(m_object_count);
+            header.extent_table_offset = to_little_endian(table_offset);
+            header.file_size = to_little_endian(m_file_offset);
+            m_builder.Reset();
+            m_builder.WriteRaw(&header, sizeof(header));
+            m_builder.PadToAlignment(m_page_size);
+            ok = ok && m_file.WriteAt(0, GetBuiltData(), m_builder.GetCurrentSize());
+
+            m_builder.Reset();
+            m_file.Close();
+            return ok;
+        }
+
+    private:
+        bool SealExtent() {
+            // Count the objects built since the last extent.
+            const size_t used = m_builder.GetCurrentSize();
+            m_builder.PadToAlignment(m_page_size);
+            const uint8* data = GetBuiltData();
+            uint64 objects = 0;
+            for (size_t offset = 0; offset + sizeof(RiftObjectHeader) <= used; ++objects) {
+                const auto* header = reinterpret_cast<const RiftObjectHeader*>(data + offset);
+                RIFT_ASSERT(from_little_endian(header->magic) == RIFT_MAGIC_NUMBER, "Snapshot extent contains a malformed object.");
+                offset = align_up(offset + from_little_endian(header->total_size), alignof(RiftObjectHeader));
+            }
+
+            RiftSnapshotExtent extent;
+            extent.offset = to_little_endian(m_file_offset);
+            extent.size = to_little_endian(static_cast<uint64>(used));
+            extent.object_count = to_little_endian(objects);
+            m_extents.push_back(extent);
+            m_object_count += objects;
+            return WritePages(data);
+        }
+
+        // The builder's bytes as one contiguous run. Objects built with
+        // AddArrayRef() hold external blobs; those are flattened into m_flat.
+        const uint8* GetBuiltData() {
+            if (!m_builder.HasExternalBlobs()) return m_builder.GetBufferPointer();
+            m_flat.resize(m_builder.GetCurrentSize());
+            m_builder.Flatten(m_flat.data());
+            return m_flat.data();
+        }
+
+        // Writes the builder's (page-padded) contents, as returned by GetBuiltData().
+        bool WritePages(const uint8* data) {
+            const bool ok = m_file.WriteAt(m_file_offset, data, m_builder.GetCurrentSize());
+            m_file_offset += m_builder.GetCurrentSize();
+            m_builder.Reset();
+            return ok;
+        }
+
+        RiftFile m_file;
+        RiftBufferBuilder m_builder;
+        size_t m_extent_size;
+        uint32 m_page_size;
+        uint64 m_file_offset = 0;
+        uint64 m_object_count = 0;
+        std::vector<RiftSnapshotExtent> m_extents;
+        std::vector<uint8> m_flat;
+    };
+
+    enum class RiftSnapshotLoadMethod {
+        Direct,   // O_DIRECT reads into a huge-page buffer (falls back to Buffered)
+        Buffered, // Regular reads through the page cache into a huge-page buffer
+        Mapped,   // mmap the file; pages fault in on first access
+    };
+
+    // --- RiftSnapshotLoader ---
+    class RiftSnapshotLoader {
+    public:
+        bool Load(const char* path, RiftSnapshotLoadMethod method = RiftSnapshotLoadMethod::Direct, size_t chunk_size = 8u << 20) {
+            Unload();
+            m_method = method;
+            if (method == RiftSnapshotLoadMethod::Mapped) {
+                if (!m_mapping.Open(path)) return false;
+                m_data = m_mapping.GetData();
+                m_size = m_mapping.GetSize();
+                return Validate();
+            }
+
+            RiftFile file;
+            if (method == RiftSnapshotLoadMethod::Direct && !file.Open(path, RiftFileMode::Read, true)) {
+                m_method = RiftSnapshotLoadMethod::Buffered;
+            }
+            if (!file.IsOpen() && !file.Open(path, RiftFileMode::Read)) return false;
+
+            const uint64 size = file.GetSize();
+            if (size < sizeof(RiftSnapshotHeader) || !m_buffer.Allocate(static_cast<size_t>(size))) return false;
+            chunk_size = align_up(chunk_size, 4096);
+            for (uint64 offset = 0; offset < size; offset += chunk_size) {
+                const size_t chunk = static_cast<size_t>(std::min<uint64>(chunk_size, size - offset));
+                if (!file.ReadAt(offset, m_buffer.GetData() + offset, chunk)) return Fail();
+            }
+            m_data = m_buffer.GetData();
+            m_size = static_cast<size_t>(size);
+            return Validate();
+        }
+
+        void Unload() {
+            m_mapping.Close();
+            m_buffer.Free();
+            m_data = nullptr;
+            m_size = 0;
+            m_header = nullptr;
+            m_extents = nullptr;
+        }
+
+        // The method actually used (Direct may have fallen back to Buffered).
+        RiftSnapshotLoadMethod GetMethod() const { return m_method; }
+        bool IsHugePageBacked() const { return m_buffer.IsHugePageBacked(); }
+        const uint8* GetData() const { return m_data; }
+        size_t GetSize() const { return m_size; }
+        uint64 GetObjectCount() const { return m_header ? from_little_endian(m_header->object_count) : 0; }
+        uint32 GetExtentCount() const { return m_header ? from_little_endian(m_header->extent_count) : 0; }
+        const RiftSnapshotExtent& GetExtent(uint32 index) const { return m_extents[index]; }
+
+        // Calls visitor(const RiftBufferViewBase&) for every object, in file
+        // order. Each object header is checked against its extent first;
+        // returns false (after visiting the objects before it) at the first
+        // corrupt one.
+        template<typename Visitor>
+        bool ForEachObject(Visitor&& visitor) const {
+            for (uint32 e = 0; e < GetExtentCount(); ++e) {
+                const uint64 begin = from_little_endian(m_extents[e].offset);
+                const uint64 end = begin + from_little_endian(m_extents[e].size); // Bounded by Validate()
+                for (uint64 offset = begin; offset < end;) {
+                    const uint32 total_size = rift_verify_object_header(m_data + offset, static_cast<size_t>(end - offset));
+                    if (total_size == 0) return false;
+                    visitor(RiftBufferViewBase(m_data + offset));
+                    offset = align_up(offset + total_size, alignof(RiftObjectHeader));
+                }
+            }
+            return true;
+        }
+
+    private:
+        bool Fail() {
+            Unload();
+            return false;
+        }
+
+        bool Validate() {
+            if (m_size < sizeof(RiftSnapshotHeader)) return Fail();
+            m_header = reinterpret_cast<const RiftSnapshotHeader*>(m_data);
+            if (from_little_endian(m_header->magic) != RIFT_SNAPSHOT_MAGIC_NUMBER ||
+                from_little_endian(m_header->version) != RIFT_SNAPSHOT_VERSION ||
+                from_little_endian(m_header->file_size) != m_size) {
+                return Fail();
+            }
+            // Checked as differences so corrupt offsets and counts cannot wrap.
+            const uint64 table_offset = from_little_endian(m_header->extent_table_offset);
+            const uint64 extent_count = from_little_endian(m_header->extent_count);
+            if (table_offset % alignof(RiftSnapshotExtent) != 0 || table_offset > m_size ||
+                extent_count > (m_size - table_offset) / sizeof(RiftSnapshotExtent)) {
+                return Fail();
+            }
+            m_extents = reinterpret_cast<const RiftSnapshotExtent*>(m_data + table_offset);
+            for (uint64 e = 0; e < extent_count; ++e) {
+                const uint64 offset = from_little_endian(m_extents[e].offset);
+                const uint64 size = from_little_endian(m_extents[e].size);
+                if (offset % alignof(RiftObjectHeader) != 0 || size > table_offset || offset > table_offset - size) return Fail();
+            }
+            return true;
+        }
+
+        RiftSnapshotLoadMethod m_method = RiftSnapshotLoadMethod::Direct;
+        RiftHugePageBuffer m_buffer;
+        RiftMappedFile m_mapping;
+        const uint8* m_data = nullptr;
+        size_t m_size = 0;
+        const RiftSnapshotHeader* m_header = nullptr;
+        const RiftSnapshotExtent* m_extents = nullptr;
+    };
+
+} // namespace RiftSerializer
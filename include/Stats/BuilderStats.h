@@ -0,0 +1,151 @@
+﻿// RiftSerializer/include/RiftSerializer/BuilderStats.h
+//
+// Growth and layout counters for RiftBufferBuilder, aggregated per schema in
+// a process-wide registry. Used to tune initial builder capacities and to
+// spot schemas that waste bytes on alignment padding.
+//
+// The builder only collects counters when RIFT_SERIALIZER_BUILDER_STATS is
+// defined; otherwise none of its hooks are compiled and this header is not
+// needed. The registry itself is always usable and is empty in that case.
+
+#pragma once
+
+#include "../Common/Common.h"
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+namespace RiftSerializer {
+
+    // --- RiftBuilderCounters ---
+    // What one builder did between two Reset() calls (one "buffer").
+    struct RiftBuilderCounters {
+        uint64 reallocations = 0;       // Times the owned storage grew
+        uint64 growth_bytes_copied = 0; // Bytes moved to the new storage by those growths
+        uint64 padding_bytes = 0;       // Zero bytes inserted by PadToAlignment
+        uint64 reserve_fill_bytes = 0;  // Zero bytes written by Reserve (later overwritten by WriteAt)
+        uint64 objects = 0;             // EndObject calls
+        uint64 built_bytes = 0;         // Stream size at the last EndObject
+        uint64 peak_capacity = 0;       // Largest owned capacity
+        uint32 last_schema_id = 0;      // Schema of the last EndObject (the root); the buffer is attributed to it
+
+        bool IsEmpty() const { return objects == 0 && reallocations == 0 && padding_bytes == 0 && reserve_fill_bytes == 0; }
+    };
+
+    // --- RiftBuilderSchemaStats ---
+    // Totals over every buffer whose root object had this schema_id.
+    struct RiftBuilderSchemaStats {
+        uint32 schema_id = 0;
+        uint64 buffers = 0;
+        uint64 objects = 0;
+        uint64 reallocations = 0;
+        uint64 growth_bytes_copied = 0;
+        uint64 padding_bytes = 0;
+        uint64 reserve_fill_bytes = 0;
+        uint64 total_bytes = 0;      // Sum of the built sizes
+        uint64 max_bytes = 0;        // Largest built size
+        uint64 peak_capacity = 0;    // Largest owned capacity of any of those builders
+
+        double GetObjectsPerBuffer() const { return buffers ? static_cast<double>(objects) / static_cast<double>(buffers) : 0.0; }
+        double GetReallocationsPerBuffer() const { return buffers ? static_cast<double>(reallocations) / static_cast<double>(buffers) : 0.0; }
+        // Share of the built bytes that is alignment padding.
+        double GetPaddingRatio() const { return total_bytes ? static_cast<double>(padding_bytes) / static_cast<double>(total_bytes) : 0.0; }
+    };
+
+    // --- RiftBuilderStatsRegistry ---
+    // Builders report once per buffer (on Reset and on destruction), so a
+    // mutex is cheap enough here; nothing is taken on the per-write path.
+    class RiftBuilderStatsRegistry {
+    public:
+        static RiftBuilderStatsRegistry& Get() {
+            static RiftBuilderStatsRegistry registry;
+            return registry;
+        }
+
+        void Record(const RiftBuilderCounters& counters) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = std::lower_bound(m_stats.begin(), m_stats.end(), counters.last_schema_id,
+                [](const RiftBuilderSchemaStats& s, uint32 id) { return s.schema_id < id; });
+            if (it == m_stats.end() || it->schema_id != counters.last_schema_id) {
+                it = m_stats.insert(it, RiftBuilderSchemaStats{});
+                it->schema_id = counters.last_schema_id;
+            }
+            it->buffers += 1;
+            it->objects += counters.objects;
+            it->reallocations += counters.reallocations;
+            it->growth_bytes_copied += counters.growth_bytes_copied;
+            it->padding_bytes += counters.padding_bytes;
+            it->reserve_fill_bytes += counters.reserve_fill_bytes;
+            it->total_bytes += counters.built_bytes;
+            it->max_bytes = std::max(it->max_bytes, counters.built_bytes);
+            it->peak_capacity = std::max(it->peak_capacity, counters.peak_capacity);
+        }
+
+        // Copies the current totals, sorted by schema_id.
+        std::vector<RiftBuilderSchemaStats> Snapshot() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_stats;
+        }
+
+        void Reset() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.clear();
+        }
+
+        // Writes one line per schema. Schema 0 collects buffers that never
+        // completed an object. Schema names can be looked up through
+        // RiftSchemaRegistry when reflection tables are linked in.
+        void Dump(std::FILE* out = stderr) const {
+            const std::vector<RiftBuilderSchemaStats> stats = Snapshot();
+            std::fprintf(out, "%-10s %10s %8s %9s %12s %12s %12s %10s %10s %10s %8s\n", "schema", "buffers", "obj/buf",
+                "realloc/b", "grow-copied", "padding", "reserve-fill", "avg-bytes", "max-bytes", "peak-cap", "pad%");
+            for (const RiftBuilderSchemaStats& s : stats) {
+                std::fprintf(out, "0x%08x %10llu %8.2f %9.2f %12llu %12llu %12llu %10llu %10llu %10llu %7.2f%%\n", s.schema_id,
+                    static_cast<unsigned long long>(s.buffers), s.GetObjectsPerBuffer(), s.GetReallocationsPerBuffer(),
+                    static_cast<unsigned long long>(s.growth_bytes_copied), static_cast<unsigned long long>(s.padding_bytes),
+                    static_cast<unsigned long long>(s.reserve_fill_bytes),
+                    static_cast<unsigned long long>(s.buffers ? s.total_bytes / s.buffers : 0),
+                    static_cast<unsigned long long>(s.max_bytes), static_cast<unsigned long long>(s.peak_capacity),
+                    s.GetPaddingRatio() * 100.0);
+            }
+            std::fflush(out);
+        }
+
+    private:
+        RiftBuilderStatsRegistry() = default;
+        mutable std::mutex m_mutex;
+        std::vector<RiftBuilderSchemaStats> m_stats; // Sorted by schema_id
+    };
+
+    namespace detail {
+        // Held by RiftBufferBuilder when stats are enabled. Reports the
+        // pending buffer on destruction; a moved-from or copied-to builder
+        // starts with fresh counters so no buffer is counted twice.
+        struct builder_stats_scope {
+            RiftBuilderCounters counters;
+
+            // Touching the registry first orders its destruction after any
+            // builder with static storage duration.
+            builder_stats_scope() { RiftBuilderStatsRegistry::Get(); }
+            builder_stats_scope(const builder_stats_scope&) : builder_stats_scope() {}
+            builder_stats_scope(builder_stats_scope&& other) noexcept : counters(other.counters) { other.counters = {}; }
+            builder_stats_scope& operator=(const builder_stats_scope&) { Flush(); return *this; }
+            builder_stats_scope& operator=(builder_stats_scope&& other) noexcept {
+                if (this != &other) {
+                    Flush();
+                    counters = other.counters;
+                    other.counters = {};
+                }
+                return *this;
+            }
+            ~builder_stats_scope() { Flush(); }
+
+            void Flush() {
+                if (!counters.IsEmpty()) RiftBuilderStatsRegistry::Get().Record(counters);
+                counters = {};
+            }
+        };
+    } // namespace detail
+
+} // namespace RiftSerializer
@@ -0,0 +1,123 @@
+﻿// RiftSerializer/include/RiftSerializer/HdrHistogram.h
+#pragma once
+
+#include "../Common/Common.h"
+#include <atomic>
+#include <memory>
+
+namespace RiftSerializer {
+
+    // --- RiftHdrHistogram ---
+    // High-dynamic-range histogram with log-linear buckets: every power of two
+    // is split into 2^sub_bucket_bits linear steps, so any recorded value is
+    // reported within a relative error of 2^-sub_bucket_bits (0.8% with the
+    // default 7) across the full 64-bit range. Use it where tail percentiles
+    // (p99.9) matter; RiftHistogram's power-of-two buckets are too coarse.
+    // Recording uses relaxed atomics, like RiftHistogram.
+    class RiftHdrHistogram {
+    public:
+        explicit RiftHdrHistogram(uint32 sub_bucket_bits = 7)
+            : m_sub_bucket_bits(sub_bucket_bits),
+            m_bucket_count((64 - sub_bucket_bits + 1) << sub_bucket_bits),
+            m_buckets(new std::atomic<uint64>[m_bucket_count]) {
+            RIFT_ASSERT(sub_bucket_bits >= 1 && sub_bucket_bits <= 16, "Sub-bucket bits must be between 1 and 16.");
+            Reset();
+        }
+
+        void Record(uint64 value, uint64 count = 1) {
+            m_buckets[BucketIndex(value)].fetch_add(count, std::memory_order_relaxed);
+            m_count.fetch_add(count, std::memory_order_relaxed);
+            m_sum.fetch_add(value * count, std::memory_order_relaxed);
+            uint64 max = m_max.load(std::memory_order_relaxed);
+            while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+            uint64 min = m_min.load(std::memory_order_relaxed);
+            while (value < min && !m_min.compare_exchange_weak(min, value, std::memory_order_relaxed)) {}
+        }
+
+        // Records value and, for a measurement loop that expects one sample
+        // every expected_interval, the samples a stalled loop failed to take
+        // (value - interval, value - 2 * interval, ...). Corrects for
+        // coordinated omission in fixed-rate latency benchmarks.
+        void RecordCorrected(uint64 value, uint64 expected_interval) {
+            Record(value);
+            if (expected_interval == 0) return;
+            for (uint64 missing = value > expected_interval ? value - expected_interval : 0; missing >= expected_interval; missing -= expected_interval) {
+                Record(missing);
+            }
+        }
+
+        uint64 GetCount() const { return m_count.load(std::memory_order_relaxed); }
+        uint64 GetMax() const { return m_max.load(std::memory_order_relaxed); }
+        uint64 GetMin() const { return GetCount() ? m_min.load(std::memory_order_relaxed) : 0; }
+        double GetMean() const {
+            const uint64 count = GetCount();
+            return count ? static_cast<double>(m_sum.load(std::memory_order_relaxed)) / static_cast<double>(count) : 0.0;
+        }
+
+        // Highest value equivalent to the bucket holding the given percentile (0-100).
+        uint64 GetPercentile(double percentile) const {
+            const uint64 count = GetCount();
+            if (count == 0) return 0;
+            const uint64 target = std::max<uint64>(1, static_cast<uint64>(static_cast<double>(count) * percentile / 100.0 + 0.5));
+            uint64 seen = 0;
+            for (uint32 i = 0; i < m_bucket_count; ++i) {
+                seen += m_buckets[i].load(std::memory_order_relaxed);
+                if (seen >= target) return std::min(GetMax(), BucketUpperBound(i));
+            }
+            return GetMax();
+        }
+
+        // Adds other's samples. Both histograms must use the same sub_bucket_bits.
+        void Merge(const RiftHdrHistogram& other) {
+            RIFT_ASSERT(other.m_sub_bucket_bits == m_sub_bucket_bits, "Histograms have different precision.");
+            for (uint32 i = 0; i < m_bucket_count; ++i) {
+                const uint64 count = other.m_buckets[i].load(std::memory_order_relaxed);
+                if (count) m_buckets[i].fetch_add(count, std::memory_order_relaxed);
+            }
+            m_count.fetch_add(other.GetCount(), std::memory_order_relaxed);
+            m_sum.fetch_add(other.m_sum.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            if (other.GetCount()) {
+                uint64 max = m_max.load(std::memory_order_relaxed);
+                while (other.GetMax() > max && !m_max.compare_exchange_weak(max, other.GetMax(), std::memory_order_relaxed)) {}
+                uint64 min = m_min.load(std::memory_order_relaxed);
+                while (other.GetMin() < min && !m_min.compare_exchange_weak(min, other.GetMin(), std::memory_order_relaxed)) {}
+            }
+        }
+
+        void Reset() {
+            for (uint32 i = 0; i < m_bucket_count; ++i) m_buckets[i].store(0, std::memory_order_relaxed);
+            m_count.store(0, std::memory_order_relaxed);
+            m_sum.store(0, std::memory_order_relaxed);
+            m_max.store(0, std::memory_order_relaxed);
+            m_min.store(UINT64_MAX, std::memory_order_relaxed);
+        }
+
+    private:
+        // Values below 2^bits map one-to-one; above, the top bits + 1 significant
+        // bits select the bucket within its power of two.
+        uint32 BucketIndex(uint64 value) const {
+            if (value < (uint64(1) << m_sub_bucket_bits)) return static_cast<uint32>(value);
+            const uint32 exponent = 63 - detail::count_leading_zeros(value);
+            const uint32 shift = exponent - m_sub_bucket_bits;
+            const uint64 top = value >> shift; // In [2^bits, 2^(bits+1))
+            return ((shift + 1) << m_sub_bucket_bits) + static_cast<uint32>(top - (uint64(1) << m_sub_bucket_bits));
+        }
+
+        uint64 BucketUpperBound(uint32 index) const {
+            const uint32 tier = index >> m_sub_bucket_bits;
+            if (tier == 0) return index;
+            const uint32 shift = tier - 1;
+            const uint64 top = (uint64(1) << m_sub_bucket_bits) + (index & ((1u << m_sub_bucket_bits) - 1));
+            return ((top + 1) << shift) - 1;
+        }
+
+        uint32 m_sub_bucket_bits;
+        uint32 m_bucket_count;
+        std::unique_ptr<std::atomic<uint64>[]> m_buckets;
+        std::atomic<uint64> m_count{ 0 };
+        std::atomic<uint64> m_sum{ 0 };
+        std::atomic<uint64> m_max{ 0 };
+        std::atomic<uint64> m_min{ UINT64_MAX };
+    };
+
+} // namespace RiftSerializer
@@ -0,0 +1,62 @@
+﻿// RiftSerializer/include/RiftSerializer/Histogram.h
+#pragma once
+
+#include "../Common/Common.h"
+#include <atomic>
+
+namespace RiftSerializer {
+
+    // --- RiftHistogram ---
+    // Power-of-two bucketed histogram of non-negative values (latencies in
+    // nanoseconds, queue depths in bytes, ...). Recording is a few relaxed
+    // atomic adds, so it can be updated from a hot thread and read from any other.
+    class RiftHistogram {
+    public:
+        static constexpr uint32 BUCKET_COUNT = 64;
+
+        void Record(uint64 value) {
+            const uint32 bucket = value == 0 ? 0 : 64 - detail::count_leading_zeros(value);
+            m_buckets[bucket < BUCKET_COUNT ? bucket : BUCKET_COUNT - 1].fetch_add(1, std::memory_order_relaxed);
+            m_count.fetch_add(1, std::memory_order_relaxed);
+            m_sum.fetch_add(value, std::memory_order_relaxed);
+            uint64 max = m_max.load(std::memory_order_relaxed);
+            while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+        }
+
+        uint64 GetCount() const { return m_count.load(std::memory_order_relaxed); }
+        uint64 GetMax() const { return m_max.load(std::memory_order_relaxed); }
+        double GetMean() const {
+            const uint64 count = GetCount();
+            return count ? static_cast<double>(m_sum.load(std::memory_order_relaxed)) / static_cast<double>(count) : 0.0;
+        }
+
+        // Upper bound of the bucket containing the given percentile (0-100).
+        uint64 GetPercentile(double percentile) const {
+            const uint64 count = GetCount();
+            if (count == 0) return 0;
+            const uint64 target = static_cast<uint64>(static_cast<double>(count) * percentile / 100.0);
+            uint64 seen = 0;
+            for (uint32 i = 0; i < BUCKET_COUNT; ++i) {
+                seen += m_buckets[i].load(std::memory_order_relaxed);
+                if (seen > target) return i == 0 ? 0 : std::min<uint64>(GetMax(), (uint64(1) << i) - 1);
+            }
+            return GetMax();
+        }
+
+        uint64 GetBucketCount(uint32 bucket) const { return m_buckets[bucket].load(std::memory_order_relaxed); }
+
+        void Reset() {
+            for (auto& bucket : m_buckets) bucket.store(0, std::memory_order_relaxed);
+            m_count.store(0, std::memory_order_relaxed);
+            m_sum.store(0, std::memory_order_relaxed);
+            m_max.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<uint64> m_buckets[BUCKET_COUNT] = {};
+        std::atomic<uint64> m_count{ 0 };
+        std::atomic<uint64> m_sum{ 0 };
+        std::atomic<uint64> m_max{ 0 };
+    };
+
+} // namespace RiftSerializer
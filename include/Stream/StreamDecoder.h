@@ -0,0 +1,129 @@
+﻿// RiftSerializer/include/RiftSerializer/StreamDecoder.h
+//
+// Incremental decoder for RiftObject streams arriving in arbitrary fragments
+// (TCP, WebSocket, pipes). The stream is the byte image a RiftBufferBuilder
+// produces: objects back to back, each starting on an 8-byte boundary
+// relative to the start of the stream.
+
+#pragma once
+
+#include "../Accessor/Accessor.h"
+#include "../Memory/AlignedBuffer.h"
+
+namespace RiftSerializer {
+
+    struct RiftStreamDecoderStats {
+        uint64 objects_in_place;  // Delivered as views straight into the caller's fragment
+        uint64 objects_copied;    // Straddled fragments (or were misaligned) and were staged
+        uint64 bytes_copied;
+    };
+
+    // --- RiftStreamDecoder ---
+    // Objects that lie entirely inside one fragment, at an 8-byte aligned
+    // address, are handed out in place. Anything else is copied exactly once
+    // into a staging buffer allocated up front; the decoder never allocates
+    // after construction. Objects larger than max_object_size are rejected.
+    class RiftStreamDecoder {
+    public:
+        explicit RiftStreamDecoder(size_t max_object_size = 64u << 10)
+            : m_staging(align_up(std::max(max_object_size, sizeof(RiftObjectHeader)), alignof(RiftObjectHeader)), alignof(RiftObjectHeader)) {
+        }
+
+        // Consumes one fragment and calls on_object(const RiftBufferViewBase&)
+        // for every object completed by it. Views are only valid during the
+        // callback. Returns false if the stream is corrupt; the decoder then
+        // ignores further input until Reset().
+        template<typename Callback>
+        bool Feed(const void* fragment, size_t size, Callback&& on_object) {
+            const auto* p = static_cast<const uint8*>(fragment);
+            while (size > 0 && !m_failed) {
+                if (m_padding > 0) {
+                    const size_t skip = std::min(m_padding, size);
+                    p += skip;
+                    size -= skip;
+                    m_padding -= skip;
+                    continue;
+                }
+
+                if (m_staged == 0 && size >= sizeof(RiftObjectHeader) && is_aligned(p, alignof(RiftObjectHeader))) {
+                    const uint32 total_size = ReadTotalSize(p);
+                    if (m_failed) break;
+                    if (total_size <= size) {
+                        const RiftBufferViewBase view(p);
+                        on_object(view);
+                        ++m_stats.objects_in_place;
+                        Advance(p, size, total_size);
+                        continue;
+                    }
+                }
+
+                // Stage: first the header, then the rest of the object once its size is known.
+                const size_t target = m_staged < sizeof(RiftObjectHeader) ? sizeof(RiftObjectHeader) : m_expected;
+                const size_t chunk = std::min(target - m_staged, size);
+                std::memcpy(m_staging.GetData() + m_staged, p, chunk);
+                m_staged += chunk;
+                m_stats.bytes_copied += chunk;
+                p += chunk;
+                size -= chunk;
+
+                if (m_staged == sizeof(RiftObjectHeader) && m_expected == 0) {
+                    m_expected = ReadTotalSize(m_staging.GetData());
+                }
+                if (!m_failed && m_expected != 0 && m_staged == m_expected) {
+                    const RiftBufferViewBase view(m_staging.GetData());
+                    on_object(view);
+                    ++m_stats.objects_copied;
+                    m_padding = align_up(m_expected, alignof(RiftObjectHeader)) - m_expected;
+                    m_staged = 0;
+                    m_expected = 0;
+                }
+            }
+            return !m_failed;
+        }
+
+        // Drops any partial object and clears the error state, e.g. after a reconnect.
+        void Reset() {
+            m_staged = 0;
+            m_expected = 0;
+            m_padding = 0;
+            m_failed = false;
+        }
+
+        bool HasFailed() const { return m_failed; }
+        // Bytes of an incomplete object currently held in the staging buffer.
+        size_t GetPendingBytes() const { return m_staged; }
+        size_t GetMaxObjectSize() const { return m_staging.GetSize(); }
+        const RiftStreamDecoderStats& GetStats() const { return m_stats; }
+
+    private:
+        // Validates a header (which may be unaligned) and returns its total_size.
+        // The size limit applies on both paths, so whether an object is
+        // accepted never depends on where the fragments split.
+        uint32 ReadTotalSize(const uint8* p) {
+            RiftObjectHeader header;
+            std::memcpy(&header, p, sizeof(header));
+            const uint32 total_size = from_little_endian(header.total_size);
+            if (from_little_endian(header.magic) != RIFT_MAGIC_NUMBER || total_size < sizeof(RiftObjectHeader) ||
+                total_size > m_staging.GetSize()) {
+                m_failed = true;
+            }
+            return total_size;
+        }
+
+        void Advance(const uint8*& p, size_t& size, uint32 total_size) {
+            const size_t padded = align_up(total_size, alignof(RiftObjectHeader));
+            const size_t step = std::min(padded, size);
+            p += step;
+            size -= step;
+            m_padding = padded - step;
+        }
+
+        RiftAlignedBuffer m_staging;
+        size_t m_staged = 0;     // Bytes of the current object in m_staging
+        size_t m_expected = 0;   // total_size of the staged object, once its header is complete
+        size_t m_padding = 0;    // Alignment padding still to skip after the last object
+        bool m_failed = false;
+        RiftStreamDecoderStats m_stats{};
+    };
+
+} // namespace RiftSerializer
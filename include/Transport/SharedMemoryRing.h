@@ -0,0 +1,192 @@
+﻿// RiftSerializer/include/RiftSerializer/SharedMemoryRing.h
+//
+// Single-producer / single-consumer ring of fixed-size slots in shared memory.
+// The producer builds each RiftObject directly in its slot through a
+// RiftSpanBuilder; the consumer process views it in place. Handoff is one
+// release store and one acquire load, with no system calls.
+//
+// Region layout:
+//   [RiftSharedRingControl (3 cache lines)][slot 0][slot 1]...[slot N-1]
+
+#pragma once
+
+#include "../Builder/SpanBuilder.h"
+#include "../Platform/SharedMemory.h"
+#include <atomic>
+#include <new>
+
+namespace RiftSerializer {
+
+    // 'RFR1' in Little Endian (version 1)
+    constexpr uint32 RIFT_SHARED_RING_MAGIC_NUMBER = 0x31524652;
+
+    static_assert(std::atomic<uint64>::is_always_lock_free && std::atomic<uint32>::is_always_lock_free,
+        "Shared-memory atomics must be lock-free to be shared between processes.");
+
+    // --- RiftSharedRingControl ---
+    // Geometry plus the two indexes, each on its own cache line so that the
+    // producer and consumer never write to the same line.
+    struct RiftSharedRingControl {
+        alignas(RIFT_CACHE_LINE_SIZE) std::atomic<uint32> magic; // Stored last by the creator
+        uint32 slot_size;
+        uint32 slot_count;
+        alignas(RIFT_CACHE_LINE_SIZE) std::atomic<uint64> write_index; // Slots published (producer)
+        alignas(RIFT_CACHE_LINE_SIZE) std::atomic<uint64> read_index;  // Slots released (consumer)
+    };
+    static_assert(sizeof(RiftSharedRingControl) == 3 * RIFT_CACHE_LINE_SIZE, "RiftSharedRingControl must be three cache lines.");
+
+    // --- RiftSharedMemoryRing ---
+    // One process calls Create() and acts as one side, the other calls Open()
+    // and acts as the other side; either may be the producer. Each side keeps
+    // a private copy of the other's index and only reloads it when the ring
+    // looks full (producer) or empty (consumer).
+    class RiftSharedMemoryRing {
+    public:
+        // slot_size bounds the size of a single object; slot_count must be a power of two.
+        bool Create(const char* name, uint32 slot_size, uint32 slot_count) {
+            RIFT_ASSERT(slot_count != 0 && (slot_count & (slot_count - 1)) == 0, "Slot count must be a power of two.");
+            slot_size = static_cast<uint32>(align_up(slot_size, RIFT_CACHE_LINE_SIZE));
+            if (!m_memory.Create(name, sizeof(RiftSharedRingControl) + static_cast<size_t>(slot_size) * slot_count)) return false;
+
+            m_control = new (m_memory.GetData()) RiftSharedRingControl();
+            m_control->slot_size = slot_size;
+            m_control->slot_count = slot_count;
+            m_control->write_index.store(0, std::memory_order_relaxed);
+            m_control->read_index.store(0, std::memory_order_relaxed);
+            m_control->magic.store(RIFT_SHARED_RING_MAGIC_NUMBER, std::memory_order_release);
+            return Attach();
+        }
+
+        // Fails if the region does not exist, its creator has not finished
+        // initializing it, or its geometry is invalid or larger than the region.
+        bool Open(const char* name) {
+            if (!m_memory.Open(name) || m_memory.GetSize() < sizeof(RiftSharedRingControl)) return Fail();
+            m_control = reinterpret_cast<RiftSharedRingControl*>(m_memory.GetData());
+            if (m_control->magic.load(std::memory_order_acquire) != RIFT_SHARED_RING_MAGIC_NUMBER) return Fail();
+            const uint32 slot_size = m_control->slot_size;
+            const uint32 slot_count = m_control->slot_count;
+            if (slot_size == 0 || slot_size % alignof(RiftObjectHeader) != 0 ||
+                slot_count == 0 || (slot_count & (slot_count - 1)) != 0 ||
+                m_memory.GetSize() < sizeof(RiftSharedRingControl) + static_cast<size_t>(slot_size) * slot_count) {
+                return Fail();
+            }
+            return Attach();
+        }
+
+        void Close() {
+            m_memory.Close();
+            m_control = nullptr;
+            m_slots = nullptr;
+        }
+
+        bool IsOpen() const { return m_control != nullptr; }
+        uint32 GetSlotSize() const { return m_slot_size; }
+        uint32 GetSlotCount() const { return m_mask + 1; }
+
+        // --- Producer ---
+
+        // Returns a builder over the next free slot, or nullptr if the ring is
+        // full. Build exactly one object into it, then call Commit().
+        RiftSpanBuilder* BeginWrite() {
+            if (m_write - m_cached_read > m_mask) {
+                m_cached_read = m_control->read_index.load(std::memory_order_acquire);
+                if (m_write - m_cached_read > m_mask) return nullptr;
+            }
+            m_builder.Attach(Slot(m_write), m_slot_size);
+            return &m_builder;
+        }
+
+        // Publishes the slot. Returns false (and publishes nothing) if the
+        // object did not fit in the slot.
+        bool Commit() {
+            if (m_builder.HasOverflowed() || m_builder.GetCurrentSize() < sizeof(RiftObjectHeader)) return false;
+            m_control->write_index.store(++m_write, std::memory_order_release);
+            return true;
+        }
+
+        // Copies a finished object into the next slot.
+        bool Write(const void* object) {
+            const uint32 size = RiftBufferViewBase(object).GetTotalSize();
+            if (size > m_slot_size) return false;
+            RiftSpanBuilder* builder = BeginWrite();
+            if (!builder) return false;
+            builder->WriteRaw(object, size);
+            return Commit();
+        }
+
+        // --- Consumer ---
+
+        // The oldest unreleased object, or nullptr if none is available. The
+        // pointer stays valid until Release(). Slots whose header is corrupt
+        // or does not fit the slot are released without being returned.
+        const void* Peek() {
+            for (;;) {
+                if (m_read == m_cached_write) {
+                    m_cached_write = m_control->write_index.load(std::memory_order_acquire);
+                    if (m_read == m_cached_write) return nullptr;
+                }
+                if (rift_verify_object_header(Slot(m_read), m_slot_size) != 0) return Slot(m_read);
+                m_control->read_index.store(++m_read, std::memory_order_release);
+            }
+        }
+
+        void Release() {
+            RIFT_ASSERT(m_read != m_cached_write, "Release without a peeked object.");
+            m_control->read_index.store(++m_read, std::memory_order_release);
+        }
+
+        // Calls on_object(const RiftBufferViewBase&) for up to max_count
+        // available slots, then releases them with a single store. Corrupt
+        // slots (see Peek) are released without a callback. Returns the
+        // number of objects delivered.
+        template<typename Callback>
+        uint32 Consume(Callback&& on_object, uint32 max_count = UINT32_MAX) {
+            m_cached_write = m_control->write_index.load(std::memory_order_acquire);
+            // A peer can never have more than slot_count slots outstanding.
+            const uint64 end = m_read + std::min<uint64>(std::min<uint64>(m_cached_write - m_read, m_mask + 1), max_count);
+            uint32 count = 0;
+            for (uint64 i = m_read; i < end; ++i) {
+                if (rift_verify_object_header(Slot(i), m_slot_size) == 0) continue;
+                const RiftBufferViewBase view(Slot(i));
+                on_object(view);
+                ++count;
+            }
+            if (end != m_read) {
+                m_read = end;
+                m_control->read_index.store(m_read, std::memory_order_release);
+            }
+            return count;
+        }
+
+    private:
+        bool Attach() {
+            m_slots = m_memory.GetData() + sizeof(RiftSharedRingControl);
+            m_slot_size = m_control->slot_size;
+            m_mask = m_control->slot_count - 1;
+            m_write = m_cached_write = m_control->write_index.load(std::memory_order_acquire);
+            m_read = m_cached_read = m_control->read_index.load(std::memory_order_acquire);
+            return true;
+        }
+
+        bool Fail() {
+            Close();
+            return false;
+        }
+
+        uint8* Slot(uint64 index) const { return m_slots + (index & m_mask) * m_slot_size; }
+
+        RiftSharedMemory m_memory;
+        RiftSharedRingControl* m_control = nullptr;
+        uint8* m_slots = nullptr;
+        uint32 m_slot_size = 0;
+        uint64 m_mask = 0;
+        RiftSpanBuilder m_builder;
+        // Producer state
+        uint64 m_write = 0;
+        uint64 m_cached_read = 0;
+        // Consumer state
+        uint64 m_cached_write = 0;
+        uint64 m_read = 0;
+    };
+
+} // namespace RiftSerializer
@@ -2,4 +2,36 @@
 #include "../../include/Common/Common.h"
 #include "../../include/Types/Types.h"
 #include "../../include/Accessor/Accessor.h"
-#include "../../include/Builder/Builder.h"
\ No newline at end of file
+#include "../../include/Builder/Builder.h"
+#include "../../include/Reflection/Reflection.h"
+#include "../../include/Json/Json.h"
+#include "../../include/Platform/File.h"
+#include "../../include/Archive/Archive.h"
+#include "../../include/Memory/AlignedBuffer.h"
+#include "../../include/Stats/Histogram.h"
+#include "../../include/LogWriter/LogWriter.h"
+#include "../../include/AsyncIO/AsyncIO.h"
+#include "../../include/AsyncIO/AsyncArchiveReader.h"
+#include "../../include/Memory/HugePageBuffer.h"
+#include "../../include/Snapshot/Snapshot.h"
+#include "../../include/Stream/StreamDecoder.h"
+#include "../../include/Builder/SpanBuilder.h"
+#include "../../include/Platform/SharedMemory.h"
+#include "../../include/Transport/SharedMemoryRing.h"
+#include "../../include/Replay/Replay.h"
+#include "../../include/Net/Packetizer.h"
+#include "../../include/Net/Socket.h"
+#include "../../include/Net/Coalescer.h"
+#include "../../include/Net/FanOut.h"
+#include "../../include/BitStream/BitStream.h"
+#include "../../include/Stats/HdrHistogram.h"
+#include "../../include/Concurrency/SpscRing.h"
+#include "../../include/Concurrency/EventQueue.h"
+#include "../../include/Runtime/TaskExecutor.h"
+#include "../../include/Runtime/ParallelProcessor.h"
+#include "../../include/Concurrency/StatePublisher.h"
+#include "../../include/Replay/ParallelReplayDecoder.h"
+#include "../../include/Logger/Logger.h"
+#include "../../include/Debug/DebugDraw.h"
+#include "../../include/Stats/BuilderStats.h"
+#include "../../include/Reflection/SchemaAnalyzer.h"
@@ -0,0 +1,232 @@
+﻿// RiftSerializer/tools/SchemaAnalyzer.cpp
+//
+// Reports the layout of the registered schemas and, given object logs or
+// replays, what real data puts in each field: bytes contributed, alignment
+// padding, share of default-valued occurrences, string and array length
+// distributions and numeric ranges. Suggests a hole-free field order and
+// flags elision, integer-narrowing and quantization candidates.
+//
+// Schemas come from the reflection tables linked in. Build with
+// -DRIFT_SCHEMA_ANALYZER_SCHEMAS=<header> (a header including the generated
+// schema headers); without it only per-schema_id object sizes are reported.
+// Files are memory-mapped and analyzed in parallel; the output does not depend
+// on the thread count.
+//
+// Usage: SchemaAnalyzer [--csv] [--threads=N] [--task-kb=1024] [file...]
+
+#include "../include/Reflection/SchemaAnalyzer.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef RIFT_SCHEMA_ANALYZER_SCHEMAS
+#include RIFT_SCHEMA_ANALYZER_SCHEMAS
+#endif
+
+using namespace RiftSerializer;
+
+namespace {
+
+    struct Options {
+        bool csv = false;
+        uint32 threads = 0;
+        size_t task_kb = 1024;
+        std::vector<std::string> files;
+    };
+
+    constexpr double DEFAULT_SHARE_HINT = 0.9; // Fields at least this often default are elision candidates
+
+    double Percent(uint64 part, uint64 whole) {
+        return whole ? 100.0 * static_cast<double>(part) / static_cast<double>(whole) : 0.0;
+    }
+
+    // Smallest integer type holding every observed value, if narrower than the field's.
+    const char* NarrowerIntegerType(RiftFieldType type, const RiftFieldUsage& usage) {
+        if (!usage.HasRange()) return nullptr;
+        struct Candidate { RiftFieldType type; double min; double max; };
+        static constexpr Candidate candidates[] = {
+            { RiftFieldType::UInt8, 0.0, 255.0 },
+            { RiftFieldType::Int8, -128.0, 127.0 },
+            { RiftFieldType::UInt16, 0.0, 65535.0 },
+            { RiftFieldType::Int16, -32768.0, 32767.0 },
+            { RiftFieldType::UInt32, 0.0, 4294967295.0 },
+            { RiftFieldType::Int32, -2147483648.0, 2147483647.0 },
+        };
+        for (const Candidate& candidate : candidates) {
+            if (GetFieldTypeSize(candidate.type) >= GetFieldTypeSize(type)) break;
+            if (usage.min_value >= candidate.min && usage.max_value <= candidate.max) return GetFieldTypeName(candidate.type);
+        }
+        return nullptr;
+    }
+
+    bool IsIntegerType(RiftFieldType type) {
+        return type >= RiftFieldType::Int8 && type <= RiftFieldType::UInt64;
+    }
+
+    bool IsFloatType(RiftFieldType type) {
+        return type == RiftFieldType::Float || type == RiftFieldType::Double || GetFieldTypeComponents(type) > 0;
+    }
+
+    void PrintLayout(const RiftSchemaInfo& schema, const RiftSchemaLayout& layout) {
+        std::printf("Schema %s (0x%08x): inline %u B = header %zu + slots %u + padding %u\n", schema.name, schema.schema_id,
+            schema.inline_size, sizeof(RiftObjectHeader), layout.slot_bytes, layout.padding_bytes);
+        std::printf("  %-24s %-7s %6s %5s %5s %10s\n", "field", "type", "offset", "size", "align", "pad-before");
+        for (const RiftFieldLayout& field : layout.fields) {
+            const RiftFieldInfo& info = schema.fields[field.field_index];
+            std::printf("  %-24s %-7s %6u %5u %5u %10u\n", info.name, GetFieldTypeName(info.type), info.offset,
+                field.slot_size, field.alignment, field.padding_before);
+        }
+        if (!layout.suggested_order.empty()) {
+            std::printf("  suggested order (inline %u -> %u B):", schema.inline_size, layout.suggested_inline_size);
+            for (uint32 index : layout.suggested_order) std::printf(" %s", schema.fields[index].name);
+            std::printf("\n");
+        }
+    }
+
+    void PrintUsage(const RiftSchemaUsage& usage) {
+        std::printf("Schema %s (0x%08x): %llu objects, %llu B (size mean %.1f, p50 %llu, p99 %llu, max %llu)\n",
+            usage.schema ? usage.schema->name : "<unregistered>", usage.schema_id,
+            static_cast<unsigned long long>(usage.objects), static_cast<unsigned long long>(usage.stream_bytes),
+            usage.object_sizes.GetMean(), static_cast<unsigned long long>(usage.object_sizes.GetPercentile(50)),
+            static_cast<unsigned long long>(usage.object_sizes.GetPercentile(99)), static_cast<unsigned long long>(usage.object_sizes.max));
+        if (!usage.schema) return;
+        const RiftSchemaInfo& schema = *usage.schema;
+        const RiftSchemaLayout layout = rift_analyze_schema_layout(schema);
+        const uint64 analyzed = usage.objects - usage.truncated;
+        const uint64 slot_bytes = analyzed * (sizeof(RiftObjectHeader) + layout.slot_bytes);
+        const uint64 variable_bytes = usage.GetVariableBytes();
+        // Everything in the stream that is neither the header, a slot nor field data.
+        const uint64 padding_bytes = usage.stream_bytes > slot_bytes + variable_bytes ? usage.stream_bytes - slot_bytes - variable_bytes : 0;
+        std::printf("  header and slots %.1f%%, variable data %.1f%%, padding %.1f%% (%llu B of it inside the inline part)\n",
+            Percent(slot_bytes, usage.stream_bytes), Percent(variable_bytes, usage.stream_bytes), Percent(padding_bytes, usage.stream_bytes),
+            static_cast<unsigned long long>(analyzed * layout.padding_bytes));
+        if (usage.truncated) std::printf("  %llu objects smaller than the inline size were skipped\n", static_cast<unsigned long long>(usage.truncated));
+
+        std::printf("  %-24s %-7s %12s %7s %9s %22s %s\n", "field", "type", "bytes", "share", "default", "length p50/p99/max", "range");
+        for (const RiftFieldLayout& field_layout : layout.fields) {
+            const RiftFieldInfo& field = schema.fields[field_layout.field_index];
+            const RiftFieldUsage& field_usage = usage.fields[field_layout.field_index];
+            const uint64 bytes = field_usage.present * field_layout.slot_size + field_usage.variable_bytes;
+            char lengths[32] = "";
+            if (IsVariableSizeFieldType(field.type)) {
+                std::snprintf(lengths, sizeof(lengths), "%llu/%llu/%llu", static_cast<unsigned long long>(field_usage.lengths.GetPercentile(50)),
+                    static_cast<unsigned long long>(field_usage.lengths.GetPercentile(99)), static_cast<unsigned long long>(field_usage.lengths.max));
+            }
+            char range[64] = "";
+            if (field_usage.HasRange()) std::snprintf(range, sizeof(range), "[%g, %g]", field_usage.min_value, field_usage.max_value);
+            std::printf("  %-24s %-7s %12llu %6.1f%% %8.1f%% %22s %s\n", field.name, GetFieldTypeName(field.type),
+                static_cast<unsigned long long>(bytes), Percent(bytes, usage.stream_bytes), field_usage.GetDefaultShare() * 100.0, lengths, range);
+        }
+
+        for (const RiftFieldLayout& field_layout : layout.fields) {
+            const RiftFieldInfo& field = schema.fields[field_layout.field_index];
+            const RiftFieldUsage& field_usage = usage.fields[field_layout.field_index];
+            if (field_usage.present == 0) continue;
+            if (field_usage.GetDefaultShare() >= DEFAULT_SHARE_HINT) {
+                std::printf("  hint: %s is default in %.1f%% of objects; candidate for elision\n", field.name, field_usage.GetDefaultShare() * 100.0);
+            }
+            if (IsIntegerType(field.type)) {
+                if (const char* narrower = NarrowerIntegerType(field.type, field_usage)) {
+                    std::printf("  hint: %s (%s) only holds values that fit %s\n", field.name, GetFieldTypeName(field.type), narrower);
+                }
+            }
+            else if (IsFloatType(field.type) && field_usage.HasRange() && field_usage.min_value >= -1.0 && field_usage.max_value <= 1.0) {
+                std::printf("  hint: %s stays within [-1, 1]; candidate for snorm16 quantization\n", field.name);
+            }
+            if (field_usage.invalid) {
+                std::printf("  warning: %s has %llu out-of-bounds references\n", field.name, static_cast<unsigned long long>(field_usage.invalid));
+            }
+        }
+        if (!layout.suggested_order.empty()) {
+            const uint64 saved = analyzed * (align_up(schema.inline_size, alignof(RiftObjectHeader)) - align_up(layout.suggested_inline_size, alignof(RiftObjectHeader)));
+            std::printf("  suggested order (inline %u -> %u B, saves %llu B over this corpus):", schema.inline_size,
+                layout.suggested_inline_size, static_cast<unsigned long long>(saved));
+            for (uint32 index : layout.suggested_order) std::printf(" %s", schema.fields[index].name);
+            std::printf("\n");
+        }
+    }
+
+    void PrintCsv(const RiftSchemaCorpusStats& stats) {
+        std::printf("schema_id,schema,field,type,offset,slot_size,padding_before,objects,defaults,inline_bytes,variable_bytes,"
+            "length_mean,length_p50,length_p99,length_max,min,max\n");
+        for (const RiftSchemaUsage& usage : stats.GetSchemas()) {
+            if (!usage.schema) continue;
+            const RiftSchemaLayout layout = rift_analyze_schema_layout(*usage.schema);
+            for (const RiftFieldLayout& field_layout : layout.fields) {
+                const RiftFieldInfo& field = usage.schema->fields[field_layout.field_index];
+                const RiftFieldUsage& field_usage = usage.fields[field_layout.field_index];
+                std::printf("%u,%s,%s,%s,%u,%u,%u,%llu,%llu,%llu,%llu,%.2f,%llu,%llu,%llu,", usage.schema_id, usage.schema->name, field.name,
+                    GetFieldTypeName(field.type), field.offset, field_layout.slot_size, field_layout.padding_before,
+                    static_cast<unsigned long long>(field_usage.present), static_cast<unsigned long long>(field_usage.defaults),
+                    static_cast<unsigned long long>(field_usage.present * field_layout.slot_size),
+                    static_cast<unsigned long long>(field_usage.variable_bytes), field_usage.lengths.GetMean(),
+                    static_cast<unsigned long long>(field_usage.lengths.GetPercentile(50)),
+                    static_cast<unsigned long long>(field_usage.lengths.GetPercentile(99)),
+                    static_cast<unsigned long long>(field_usage.lengths.max));
+                if (field_usage.HasRange()) std::printf("%.9g,%.9g\n", field_usage.min_value, field_usage.max_value);
+                else std::printf(",\n");
+            }
+        }
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            const auto value = [&](const char* prefix) { return arg.substr(std::strlen(prefix)); };
+            if (arg == "--csv") options.csv = true;
+            else if (arg.rfind("--threads=", 0) == 0) options.threads = static_cast<uint32>(std::stoul(value("--threads=")));
+            else if (arg.rfind("--task-kb=", 0) == 0) options.task_kb = std::stoul(value("--task-kb="));
+            else if (arg.rfind("--", 0) == 0) {
+                std::fprintf(stderr, "Unknown argument: %s\n", arg.c_str());
+                return false;
+            }
+            else options.files.push_back(arg);
+        }
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) return 1;
+
+    if (options.files.empty()) {
+        const std::vector<const RiftSchemaInfo*>& schemas = RiftSchemaRegistry::Instance().GetAll();
+        if (schemas.empty()) {
+            std::fprintf(stderr, "No schemas registered; rebuild with RIFT_SCHEMA_ANALYZER_SCHEMAS or pass object files.\n");
+            return 1;
+        }
+        for (const RiftSchemaInfo* schema : schemas) {
+            PrintLayout(*schema, rift_analyze_schema_layout(*schema));
+            std::printf("\n");
+        }
+        return 0;
+    }
+
+    RiftTaskExecutor executor(options.threads);
+    RiftSchemaAnalyzer analyzer(executor, options.task_kb << 10);
+    int status = 0;
+    for (const std::string& path : options.files) {
+        RiftParallelResult result;
+        if (!analyzer.AddFile(path.c_str(), &result)) {
+            std::fprintf(stderr, "%s: not readable or holds no objects\n", path.c_str());
+            status = 1;
+            continue;
+        }
+        if (!result.framing_valid) {
+            std::fprintf(stderr, "%s: framing error at stream offset %zu; later objects skipped\n", path.c_str(), result.first_error_offset);
+        }
+    }
+
+    if (options.csv) {
+        PrintCsv(analyzer.GetStats());
+        return status;
+    }
+    for (const RiftSchemaUsage& usage : analyzer.GetStats().GetSchemas()) {
+        PrintUsage(usage);
+        std::printf("\n");
+    }
+    return status;
+}